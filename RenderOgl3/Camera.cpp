@@ -3,7 +3,7 @@
 void Camera::resize(int width, int height) {
     projectionMatrix = glm::perspective(glm::radians(45.0f),
                                       static_cast<float>(width) / height,
-                                      0.1f, 100.0f);
+                                      NearPlane, FarPlane);
 }
 
 void Camera::updateRotation(float deltaX, float deltaY) {
@@ -3,6 +3,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 class Camera {
+public:
+    static constexpr float NearPlane = 0.1f;
+    static constexpr float FarPlane = 100.0f;
+
 private:
     glm::mat4 projectionMatrix;
     glm::mat4 viewMatrix;
@@ -1,6 +1,6 @@
 #include "CubeBuffer.h"
 
-CubeBuffer::CubeBuffer() {
+CubeBuffer::CubeBuffer(GlDevice& device) : gl(device) {
     float vertices[] = {
         -1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f,
          1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f,
@@ -37,33 +37,33 @@ CubeBuffer::CubeBuffer() {
         20, 21, 22, 22, 23, 20
     };
 
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
+    gl.genVertexArrays(1, &vao);
+    gl.genBuffers(1, &vbo);
+    gl.genBuffers(1, &ebo);
 
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    gl.bindVertexArray(vao);
+    gl.bindBuffer(GL_ARRAY_BUFFER, vbo);
+    gl.bufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    gl.vertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    gl.enableVertexAttribArray(0);
+    gl.vertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    gl.enableVertexAttribArray(1);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    gl.bufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
-    glBindVertexArray(0);
+    gl.bindVertexArray(0);
 }
 
 CubeBuffer::~CubeBuffer() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
-    glDeleteBuffers(1, &ebo);
+    gl.deleteVertexArrays(1, &vao);
+    gl.deleteBuffers(1, &vbo);
+    gl.deleteBuffers(1, &ebo);
 }
 
 void CubeBuffer::render() const {
-    glRiseVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    gl.bindVertexArray(vao);
+    gl.drawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    gl.bindVertexArray(0);
 }
\ No newline at end of file
@@ -1,13 +1,18 @@
 #pragma once
 #include <GL/glew.h>
+#include "GlDevice.h"
 
 class CubeBuffer {
 private:
+    GlDevice& gl;
     GLuint vao, vbo, ebo;
 
 public:
-    CubeBuffer();
+    explicit CubeBuffer(GlDevice& device = GlDevice::system());
     ~CubeBuffer();
 
+    CubeBuffer(const CubeBuffer&) = delete;
+    CubeBuffer& operator=(const CubeBuffer&) = delete;
+
     void render() const;
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "DrawList.h"
+#include <algorithm>
+
+uint64_t DrawList::makeKey(const State& state, float depth) {
+    constexpr uint64_t depthMax = (1ull << DepthBits) - 1;
+    const auto depthBucket = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(depthMax));
+    const uint64_t program = state.program & ((1ull << ProgramBits) - 1);
+    const uint64_t texture = state.texture & ((1ull << TextureBits) - 1);
+    const uint64_t material = state.material & ((1ull << MaterialBits) - 1);
+
+    const uint64_t stateBits = (program << (TextureBits + MaterialBits)) | (texture << MaterialBits) | material;
+    if (state.blended) {
+        return (1ull << 63) | ((depthMax - depthBucket) << (ProgramBits + TextureBits + MaterialBits)) | stateBits;
+    }
+    return (stateBits << DepthBits) | depthBucket;
+}
+
+void DrawList::clear() {
+    draws.clear();
+    ranges.clear();
+    entries.clear();
+    stats = {};
+}
+
+void DrawList::add(const State& state, float depth, uint32_t mesh, const OcclusionCuller::Range* meshRanges, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    entries.push_back({makeKey(state, depth), static_cast<uint32_t>(draws.size())});
+    draws.push_back({state, mesh, static_cast<uint32_t>(ranges.size()), static_cast<uint32_t>(count)});
+    ranges.insert(ranges.end(), meshRanges, meshRanges + count);
+}
+
+size_t DrawList::countStateChanges(const std::vector<Entry>& order, const std::vector<Draw>& draws) {
+    size_t changes = 0;
+    const State* previous = nullptr;
+    for (const Entry& entry : order) {
+        const State& state = draws[entry.draw].state;
+        if (!previous || state.program != previous->program || state.texture != previous->texture ||
+            state.material != previous->material || state.blended != previous->blended) {
+            ++changes;
+        }
+        previous = &state;
+    }
+    return changes;
+}
+
+void DrawList::sort() {
+    stats.draws = entries.size();
+    stats.unsortedStateChanges = countStateChanges(entries, draws);
+
+    // All eight histograms in one pass over the keys
+    std::array<std::array<uint32_t, 256>, 8> histograms{};
+    for (const Entry& entry : entries) {
+        for (size_t digit = 0; digit < 8; ++digit) {
+            ++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+        }
+    }
+
+    scratch.resize(entries.size());
+    for (size_t digit = 0; digit < 8 && !entries.empty(); ++digit) {
+        auto& counts = histograms[digit];
+        const unsigned shift = static_cast<unsigned>(digit * 8);
+        if (counts[(entries.front().key >> shift) & 0xFF] == entries.size()) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t& count : counts) {
+            const uint32_t bucket = count;
+            count = offset;
+            offset += bucket;
+        }
+        for (const Entry& entry : entries) {
+            scratch[counts[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        entries.swap(scratch);
+    }
+
+    stats.stateChanges = countStateChanges(entries, draws);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "../render/OcclusionCuller.h"
+
+// One frame's draws, each tagged with a 64-bit sort key built from the state it needs,
+// and radix-sorted so that a draw only changes what differs from the one before it.
+//
+//   opaque:  0 | program:7 | texture:16 | material:24 | depth:16     (front to back within a state)
+//   blended: 1 | ~depth:16 | program:7 | texture:16 | material:24    (back to front, then by state)
+//
+// Opaque draws come first. Texture sits above material because several materials can share
+// a texture and a bind costs more than a uniform upload. Fields wider than their bits are
+// truncated in the key, which only costs grouping: emission compares the real state.
+class DrawList {
+public:
+    struct State {
+        uint32_t program = 0;
+        uint32_t texture = 0;
+        uint32_t material = 0;
+        bool blended = false;
+    };
+
+    struct Draw {
+        State state;
+        uint32_t mesh = 0;
+        uint32_t firstRange = 0; // Into getRanges()
+        uint32_t rangeCount = 0;
+    };
+
+    // Changes of program, texture, material or blending along the list.
+    struct Stats {
+        size_t draws = 0;
+        size_t stateChanges = 0;
+        size_t unsortedStateChanges = 0; // The same draws in submission order
+    };
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t draw;
+    };
+
+    std::vector<Draw> draws;
+    std::vector<OcclusionCuller::Range> ranges;
+    std::vector<Entry> entries;
+    std::vector<Entry> scratch;
+    Stats stats;
+
+    static size_t countStateChanges(const std::vector<Entry>& order, const std::vector<Draw>& draws);
+
+public:
+    static constexpr unsigned DepthBits = 16;
+    static constexpr unsigned MaterialBits = 24;
+    static constexpr unsigned TextureBits = 16;
+    static constexpr unsigned ProgramBits = 7;
+
+    // depth is the view distance scaled to [0, 1]; values outside are clamped.
+    static uint64_t makeKey(const State& state, float depth);
+
+    void clear();
+
+    // ranges of one mesh that share state; nothing is added when count is 0.
+    void add(const State& state, float depth, uint32_t mesh, const OcclusionCuller::Range* meshRanges, size_t count);
+
+    // LSD radix sort on 8-bit digits, stable, skipping digits that are the same in every key.
+    void sort();
+
+    size_t size() const { return entries.size(); }
+    const Draw& operator[](size_t index) const { return draws[entries[index].draw]; }
+    const std::vector<OcclusionCuller::Range>& getRanges() const { return ranges; }
+    const Stats& getStats() const { return stats; }
+};
\ No newline at end of file
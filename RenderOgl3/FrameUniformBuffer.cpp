@@ -0,0 +1,20 @@
+#include "FrameUniformBuffer.h"
+#include "ShaderProgram.h"
+
+static_assert(sizeof(FrameUniformBuffer::FrameData) == 160, "FrameData must match the std140 block");
+
+FrameUniformBuffer::FrameUniformBuffer(GlDevice& device) : gl(device) {
+    gl.genBuffers(1, &ubo);
+    gl.bindBuffer(GL_UNIFORM_BUFFER, ubo);
+    gl.bufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+    gl.bindBufferBase(GL_UNIFORM_BUFFER, ShaderProgram::FrameBlockBinding, ubo);
+}
+
+FrameUniformBuffer::~FrameUniformBuffer() {
+    gl.deleteBuffers(1, &ubo);
+}
+
+void FrameUniformBuffer::update(const FrameData& data) {
+    gl.bindBuffer(GL_UNIFORM_BUFFER, ubo);
+    gl.bufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "GlDevice.h"
+
+// Camera and light for the whole frame in one uniform buffer bound to
+// ShaderProgram::FrameBlockBinding: one upload per frame instead of four
+// uniforms per program.
+class FrameUniformBuffer {
+public:
+    // std140 layout of the FrameData block in Shaders.cpp
+    struct FrameData {
+        glm::mat4 projection;
+        glm::mat4 view;
+        glm::vec4 lightPos;
+        glm::vec4 lightColor;
+    };
+
+private:
+    GlDevice& gl;
+    GLuint ubo;
+
+public:
+    explicit FrameUniformBuffer(GlDevice& device = GlDevice::system());
+    ~FrameUniformBuffer();
+
+    FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+    FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+    void update(const FrameData& data);
+};
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "GlDevice.h"
+
+namespace {
+    class SystemGlDevice final : public GlDevice {
+    public:
+        void initialize() override { glewInit(); }
+
+        void enable(GLenum capability) override { glEnable(capability); }
+        void disable(GLenum capability) override { glDisable(capability); }
+        void cullFace(GLenum mode) override { glCullFace(mode); }
+        void blendFunc(GLenum source, GLenum destination) override { glBlendFunc(source, destination); }
+        void depthMask(GLboolean enabled) override { glDepthMask(enabled); }
+        void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) override { glClearColor(r, g, b, a); }
+        void clear(GLbitfield mask) override { glClear(mask); }
+        void viewport(GLint x, GLint y, GLsizei width, GLsizei height) override { glViewport(x, y, width, height); }
+
+        void genVertexArrays(GLsizei count, GLuint* arrays) override { glGenVertexArrays(count, arrays); }
+        void deleteVertexArrays(GLsizei count, const GLuint* arrays) override { glDeleteVertexArrays(count, arrays); }
+        void bindVertexArray(GLuint array) override { glBindVertexArray(array); }
+        void genBuffers(GLsizei count, GLuint* buffers) override { glGenBuffers(count, buffers); }
+        void deleteBuffers(GLsizei count, const GLuint* buffers) override { glDeleteBuffers(count, buffers); }
+        void bindBuffer(GLenum target, GLuint buffer) override { glBindBuffer(target, buffer); }
+        void bindBufferBase(GLenum target, GLuint index, GLuint buffer) override { glBindBufferBase(target, index, buffer); }
+        void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override { glBufferData(target, size, data, usage); }
+        void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override { glBufferSubData(target, offset, size, data); }
+        void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) override {
+            glVertexAttribPointer(index, size, type, normalized, stride, offset);
+        }
+        void enableVertexAttribArray(GLuint index) override { glEnableVertexAttribArray(index); }
+        void genTextures(GLsizei count, GLuint* textures) override { glGenTextures(count, textures); }
+        void deleteTextures(GLsizei count, const GLuint* textures) override { glDeleteTextures(count, textures); }
+        void bindTexture(GLenum target, GLuint texture) override { glBindTexture(target, texture); }
+        void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format,
+                        GLenum type, const void* pixels) override {
+            glTexImage2D(target, level, internalFormat, width, height, 0, format, type, pixels);
+        }
+        void texParameteri(GLenum target, GLenum parameter, GLint value) override { glTexParameteri(target, parameter, value); }
+
+        void drawElements(GLenum mode, GLsizei count, GLenum type, const void* offset) override { glDrawElements(mode, count, type, offset); }
+        void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* offset, GLint baseVertex) override {
+            glDrawElementsBaseVertex(mode, count, type, const_cast<void*>(offset), baseVertex);
+        }
+        void multiDrawElementsBaseVertex(GLenum mode, const GLsizei* counts, GLenum type, const void* const* offsets,
+                                         GLsizei drawCount, const GLint* baseVertices) override {
+            glMultiDrawElementsBaseVertex(mode, const_cast<GLsizei*>(counts), type, const_cast<void**>(offsets), drawCount,
+                                          const_cast<GLint*>(baseVertices));
+        }
+
+        GLuint createShader(GLenum type) override { return glCreateShader(type); }
+        void shaderSource(GLuint shader, const char* source) override { glShaderSource(shader, 1, &source, nullptr); }
+        void compileShader(GLuint shader) override { glCompileShader(shader); }
+        void deleteShader(GLuint shader) override { glDeleteShader(shader); }
+        GLuint createProgram() override { return glCreateProgram(); }
+        void attachShader(GLuint program, GLuint shader) override { glAttachShader(program, shader); }
+        void linkProgram(GLuint program) override { glLinkProgram(program); }
+        void deleteProgram(GLuint program) override { glDeleteProgram(program); }
+        void useProgram(GLuint program) override { glUseProgram(program); }
+        void getProgramiv(GLuint program, GLenum parameter, GLint* value) override { glGetProgramiv(program, parameter, value); }
+        void getActiveUniform(GLuint program, GLuint index, GLsizei bufferSize, GLsizei* length, GLint* size, GLenum* type,
+                              GLchar* name) override {
+            glGetActiveUniform(program, index, bufferSize, length, size, type, name);
+        }
+        GLint getUniformLocation(GLuint program, const char* name) override { return glGetUniformLocation(program, name); }
+        GLuint getUniformBlockIndex(GLuint program, const char* name) override { return glGetUniformBlockIndex(program, name); }
+        void uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) override {
+            glUniformBlockBinding(program, blockIndex, binding);
+        }
+        void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) override {
+            glUniformMatrix3fv(location, count, transpose, value);
+        }
+        void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) override {
+            glUniformMatrix4fv(location, count, transpose, value);
+        }
+        void uniform3fv(GLint location, GLsizei count, const GLfloat* value) override { glUniform3fv(location, count, value); }
+        void uniform4fv(GLint location, GLsizei count, const GLfloat* value) override { glUniform4fv(location, count, value); }
+    };
+}
+
+GlDevice& GlDevice::system() {
+    static SystemGlDevice device;
+    return device;
+}
\ No newline at end of file
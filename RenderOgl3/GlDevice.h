@@ -0,0 +1,66 @@
+#pragma once
+#include <GL/glew.h>
+
+// The GL entry points used by the renderer, behind an interface so a frame can
+// run against RecordingGlDevice and be checked without a GPU or a context.
+class GlDevice {
+public:
+    virtual ~GlDevice() = default;
+
+    // Process-wide device that forwards to the real driver.
+    static GlDevice& system();
+
+    virtual void initialize() = 0;
+
+    virtual void enable(GLenum capability) = 0;
+    virtual void disable(GLenum capability) = 0;
+    virtual void cullFace(GLenum mode) = 0;
+    virtual void blendFunc(GLenum source, GLenum destination) = 0;
+    virtual void depthMask(GLboolean enabled) = 0;
+    virtual void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) = 0;
+    virtual void clear(GLbitfield mask) = 0;
+    virtual void viewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+
+    virtual void genVertexArrays(GLsizei count, GLuint* arrays) = 0;
+    virtual void deleteVertexArrays(GLsizei count, const GLuint* arrays) = 0;
+    virtual void bindVertexArray(GLuint array) = 0;
+    virtual void genBuffers(GLsizei count, GLuint* buffers) = 0;
+    virtual void deleteBuffers(GLsizei count, const GLuint* buffers) = 0;
+    virtual void bindBuffer(GLenum target, GLuint buffer) = 0;
+    virtual void bindBufferBase(GLenum target, GLuint index, GLuint buffer) = 0;
+    virtual void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) = 0;
+    virtual void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) = 0;
+    virtual void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) = 0;
+    virtual void enableVertexAttribArray(GLuint index) = 0;
+    virtual void genTextures(GLsizei count, GLuint* textures) = 0;
+    virtual void deleteTextures(GLsizei count, const GLuint* textures) = 0;
+    virtual void bindTexture(GLenum target, GLuint texture) = 0;
+    virtual void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format,
+                            GLenum type, const void* pixels) = 0;
+    virtual void texParameteri(GLenum target, GLenum parameter, GLint value) = 0;
+
+    virtual void drawElements(GLenum mode, GLsizei count, GLenum type, const void* offset) = 0;
+    virtual void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* offset, GLint baseVertex) = 0;
+    virtual void multiDrawElementsBaseVertex(GLenum mode, const GLsizei* counts, GLenum type, const void* const* offsets,
+                                             GLsizei drawCount, const GLint* baseVertices) = 0;
+
+    virtual GLuint createShader(GLenum type) = 0;
+    virtual void shaderSource(GLuint shader, const char* source) = 0;
+    virtual void compileShader(GLuint shader) = 0;
+    virtual void deleteShader(GLuint shader) = 0;
+    virtual GLuint createProgram() = 0;
+    virtual void attachShader(GLuint program, GLuint shader) = 0;
+    virtual void linkProgram(GLuint program) = 0;
+    virtual void deleteProgram(GLuint program) = 0;
+    virtual void useProgram(GLuint program) = 0;
+    virtual void getProgramiv(GLuint program, GLenum parameter, GLint* value) = 0;
+    virtual void getActiveUniform(GLuint program, GLuint index, GLsizei bufferSize, GLsizei* length, GLint* size, GLenum* type,
+                                  GLchar* name) = 0;
+    virtual GLint getUniformLocation(GLuint program, const char* name) = 0;
+    virtual GLuint getUniformBlockIndex(GLuint program, const char* name) = 0;
+    virtual void uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) = 0;
+    virtual void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) = 0;
+    virtual void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) = 0;
+    virtual void uniform3fv(GLint location, GLsizei count, const GLfloat* value) = 0;
+    virtual void uniform4fv(GLint location, GLsizei count, const GLfloat* value) = 0;
+};
\ No newline at end of file
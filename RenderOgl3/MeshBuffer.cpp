@@ -1,33 +1,160 @@
 #include "MeshBuffer.h"
+#include <algorithm>
+#include <cstddef>
+#include <span>
 
-MeshBuffer::MeshBuffer(const std::shared_ptr<Mesh>& mesh) {
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
+MeshBufferPool::MeshBufferPool(GlDevice& device) : gl(device) {
+    createArena(floatArena, false);
+    createArena(packedArena, true);
+}
+
+MeshBufferPool::~MeshBufferPool() {
+    destroyArena(floatArena);
+    destroyArena(packedArena);
+}
+
+void MeshBufferPool::createArena(Arena& arena, bool packed) {
+    gl.genVertexArrays(1, &arena.vao);
+    gl.genBuffers(1, &arena.vbo);
+    gl.genBuffers(1, &arena.ebo);
+
+    gl.bindVertexArray(arena.vao);
+    gl.bindBuffer(GL_ARRAY_BUFFER, arena.vbo);
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.ebo);
+
+    if (packed) {
+        using PackedVertex = Mesh::PackedVertex;
+        gl.vertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, px));
+        gl.enableVertexAttribArray(0);
+        gl.vertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, nx));
+        gl.enableVertexAttribArray(1);
+        gl.vertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, u));
+        gl.enableVertexAttribArray(2);
+    } else {
+        using Vertex = Mesh::Vertex;
+        gl.vertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
+        gl.enableVertexAttribArray(0);
+        gl.vertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, nx));
+        gl.enableVertexAttribArray(1);
+        gl.vertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, u));
+        gl.enableVertexAttribArray(2);
+    }
 
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    gl.bindVertexArray(0);
+}
+
+void MeshBufferPool::destroyArena(Arena& arena) {
+    gl.deleteVertexArrays(1, &arena.vao);
+    gl.deleteBuffers(1, &arena.vbo);
+    gl.deleteBuffers(1, &arena.ebo);
+    arena = Arena{};
+}
+
+// Always respecifies the storage: the driver can hand out fresh memory instead
+// of stalling on a frame that still reads the previous model.
+void MeshBufferPool::reserve(Arena& arena, size_t vertexBytes, size_t indexBytes) {
+    if (vertexBytes > arena.vertexCapacity) {
+        arena.vertexCapacity = std::max(vertexBytes, arena.vertexCapacity + arena.vertexCapacity / 2);
+    }
+    if (indexBytes > arena.indexCapacity) {
+        arena.indexCapacity = std::max(indexBytes, arena.indexCapacity + arena.indexCapacity / 2);
+    }
+    gl.bindBuffer(GL_ARRAY_BUFFER, arena.vbo);
+    gl.bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(arena.vertexCapacity), nullptr, GL_STATIC_DRAW);
+    gl.bufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(arena.indexCapacity), nullptr, GL_STATIC_DRAW);
+    gpuMemory.set(floatArena.vertexCapacity + floatArena.indexCapacity + packedArena.vertexCapacity + packedArena.indexCapacity);
+}
 
-    const auto& vertices = mesh->getVertices();
-    vertexCount = vertices.size();
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+size_t MeshBufferPool::upload(const Model3D& model) {
+    const auto& meshes = model.getMeshes();
+    allocations.assign(meshes.size(), Allocation{});
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, nx));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, u));
-    glEnableVertexAttribArray(2);
+    size_t vertexBytes[2] = { 0, 0 };
+    size_t indexBytes[2] = { 0, 0 };
+    for (const auto& mesh : meshes) {
+        bool packed = mesh->isCompressed();
+        vertexBytes[packed] += packed ? mesh->getPackedVertices().size() * sizeof(Mesh::PackedVertex)
+                                      : mesh->getVertices().size() * sizeof(Mesh::Vertex);
+        indexBytes[packed] += mesh->getIndices().size() * sizeof(uint32_t);
+    }
+
+    size_t writes = 0;
+    Arena* arenas[2] = { &floatArena, &packedArena };
+    for (int packed = 0; packed < 2; ++packed) {
+        Arena& arena = *arenas[packed];
+        arena.meshCount = 0;
+        if (indexBytes[packed] == 0) {
+            continue;
+        }
+
+        gl.bindVertexArray(arena.vao);
+        reserve(arena, vertexBytes[packed], indexBytes[packed]);
+        writes += 2;
+
+        size_t vertexOffset = 0;
+        size_t indexOffset = 0;
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            const auto& mesh = *meshes[i];
+            if (mesh.isCompressed() != static_cast<bool>(packed) || mesh.getIndices().empty()) {
+                continue;
+            }
+
+            Allocation& allocation = allocations[i];
+            allocation.packed = packed;
+            allocation.baseVertex = static_cast<GLint>(vertexOffset);
+            allocation.firstIndex = indexOffset;
+            allocation.indexCount = mesh.getIndices().size();
+
+            const auto& bounds = mesh.getBounds();
+            const auto extent = bounds.extent();
+            allocation.positionMin = glm::vec3(bounds.min[0], bounds.min[1], bounds.min[2]);
+            allocation.positionExtent = glm::vec3(extent[0], extent[1], extent[2]);
+
+            size_t vertexSize = packed ? sizeof(Mesh::PackedVertex) : sizeof(Mesh::Vertex);
+            const void* vertexData = packed ? static_cast<const void*>(mesh.getPackedVertices().data())
+                                            : static_cast<const void*>(mesh.getVertices().data());
+            gl.bufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(vertexOffset * vertexSize),
+                             static_cast<GLsizeiptr>(mesh.getVertexCount() * vertexSize), vertexData);
+            gl.bufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(indexOffset * sizeof(uint32_t)),
+                             static_cast<GLsizeiptr>(allocation.indexCount * sizeof(uint32_t)), mesh.getIndices().data());
+
+            writes += 2;
+
+            vertexOffset += mesh.getVertexCount();
+            indexOffset += allocation.indexCount;
+            ++arena.meshCount;
+        }
+    }
+
+    gl.bindVertexArray(0);
+    return writes;
+}
 
-    glBindVertexArray(0);
+void MeshBufferPool::bindArena(bool packed) {
+    gl.bindVertexArray(packed ? packedArena.vao : floatArena.vao);
 }
 
-MeshBuffer::~MeshBuffer() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
+void MeshBufferPool::appendRanges(size_t meshIndex, const OcclusionCuller::Range* ranges, size_t count) {
+    const Allocation& allocation = allocations[meshIndex];
+    for (const auto& range : std::span(ranges, count)) {
+        if (range.firstIndex >= allocation.indexCount) {
+            continue;
+        }
+        size_t indexCount = std::min<size_t>(range.indexCount, allocation.indexCount - range.firstIndex);
+        drawCounts.push_back(static_cast<GLsizei>(indexCount));
+        drawOffsets.push_back((const void*)((allocation.firstIndex + range.firstIndex) * sizeof(uint32_t)));
+        drawBaseVertices.push_back(allocation.baseVertex);
+    }
 }
 
-void MeshBuffer::render() const {
-    glBindVertexArray(vao);
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
-    glBindVertexArray(0);
+size_t MeshBufferPool::submit() {
+    if (drawCounts.empty()) {
+        return 0;
+    }
+    gl.multiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_INT, drawOffsets.data(),
+                                   static_cast<GLsizei>(drawCounts.size()), drawBaseVertices.data());
+    drawCounts.clear();
+    drawOffsets.clear();
+    drawBaseVertices.clear();
+    return 1;
 }
\ No newline at end of file
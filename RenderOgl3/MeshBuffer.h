@@ -1,16 +1,75 @@
 #pragma once
 #include <GL/glew.h>
-#include <memory>
+#include <glm/glm.hpp>
+#include <vector>
+#include "GlDevice.h"
 #include "../models/Model3D.h"
+#include "../render/OcclusionCuller.h"
+#include "../core/MemoryStats.h"
+
+// All meshes of a model suballocated from two shared arenas, one per vertex
+// format. An arena is one VAO over one vertex and one index buffer; meshes keep
+// their local indices and are drawn with a base vertex, so the visible ranges of
+// every float mesh that share a state go out in a single glMultiDrawElementsBaseVertex.
+class MeshBufferPool {
+public:
+    struct Allocation {
+        bool packed = false;
+        GLint baseVertex = 0;
+        size_t firstIndex = 0;
+        size_t indexCount = 0;
+        glm::vec3 positionMin{ 0.0f };
+        glm::vec3 positionExtent{ 0.0f };
+    };
 
-class MeshBuffer {
 private:
-    GLuint vao, vbo;
-    size_t vertexCount;
+    struct Arena {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        size_t vertexCapacity = 0;
+        size_t indexCapacity = 0;
+        size_t meshCount = 0;
+    };
+
+    GlDevice& gl;
+    Arena floatArena;
+    Arena packedArena;
+    std::vector<Allocation> allocations;
+    MemoryAccount gpuMemory{ MemoryTag::GpuBuffers };
+
+    std::vector<GLsizei> drawCounts;
+    std::vector<const void*> drawOffsets;
+    std::vector<GLint> drawBaseVertices;
+
+    void createArena(Arena& arena, bool packed);
+    void destroyArena(Arena& arena);
+    void reserve(Arena& arena, size_t vertexBytes, size_t indexBytes);
 
 public:
-    MeshBuffer(const std::shared_ptr<Mesh>& mesh);
-    ~MeshBuffer();
+    explicit MeshBufferPool(GlDevice& device);
+    ~MeshBufferPool();
+
+    MeshBufferPool(const MeshBufferPool&) = delete;
+    MeshBufferPool& operator=(const MeshBufferPool&) = delete;
+
+    // Replaces the previous model; the GL buffers are kept and only grow.
+    // Returns the number of buffer writes issued.
+    size_t upload(const Model3D& model);
+
+    size_t getMeshCount() const { return allocations.size(); }
+    const Allocation& getAllocation(size_t meshIndex) const { return allocations[meshIndex]; }
+    bool hasFloatMeshes() const { return floatArena.meshCount > 0; }
+    bool hasPackedMeshes() const { return packedArena.meshCount > 0; }
+
+    // Binds the VAO of one vertex format; the queued ranges must all be of that format.
+    void bindArena(bool packed);
+
+    // Queues visible ranges of one mesh, given relative to the mesh's own index buffer.
+    // Packed meshes dequantize with per-mesh uniforms, so a batch holds one packed mesh at most.
+    void appendRanges(size_t meshIndex, const OcclusionCuller::Range* ranges, size_t count);
 
-    void render() const;
+    // Issues the queued ranges as one multi-draw and empties the queue.
+    // Returns the number of GL draw calls, 0 when nothing was queued.
+    size_t submit();
 };
\ No newline at end of file
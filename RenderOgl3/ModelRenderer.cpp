@@ -1,31 +1,68 @@
 #include "ModelRenderer.h"
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+#include "../model/math/Matrix4x4.h"
+#include "../core/Trace.h"
 
-ModelRenderer::ModelRenderer() {
-    shader = std::make_unique<ShaderProgram>(Shaders::vertexShaderSource, Shaders::fragmentShaderSource);
-    cubeBuffer = std::make_unique<CubeBuffer>();
+namespace {
+    // Inverse transpose of the model matrix, once per draw instead of per vertex in the shader.
+    glm::mat3 normalMatrixOf(const glm::mat4& modelMatrix) {
+        VecMath::Matrix4x4<float> matrix;
+        std::memcpy(matrix.data(), glm::value_ptr(modelMatrix), sizeof(float) * 16);
+        const VecMath::Matrix4x4<float> inverseTranspose = matrix.inverseTranspose();
+
+        glm::mat3 normalMatrix(1.0f);
+        for (int column = 0; column < 3; ++column) {
+            for (int row = 0; row < 3; ++row) {
+                normalMatrix[column][row] = inverseTranspose.mm[column][row];
+            }
+        }
+        return normalMatrix;
+    }
+
+    glm::vec4 colorOf(const Material& material) {
+        return glm::vec4(material.diffuseColor.r, material.diffuseColor.g, material.diffuseColor.b, material.dissolve);
+    }
+
+    // Program ids in draw list keys
+    constexpr uint32_t FloatProgram = 0;
+    constexpr uint32_t PackedProgram = 1;
+}
+
+ModelRenderer::ModelRenderer(GlDevice& device) : gl(device) {
+    shader = std::make_unique<ShaderProgram>(Shaders::vertexShaderSource, Shaders::fragmentShaderSource, gl);
+    packedShader = std::make_unique<ShaderProgram>(Shaders::packedVertexShaderSource, Shaders::fragmentShaderSource, gl);
+    frameUniforms = std::make_unique<FrameUniformBuffer>(gl);
+    positionMinUniform = packedShader->findUniform("positionMin");
+    positionExtentUniform = packedShader->findUniform("positionExtent");
+    materialColorUniform = shader->findUniform("materialColor");
+    packedMaterialColorUniform = packedShader->findUniform("materialColor");
+    meshBuffers = std::make_unique<MeshBufferPool>(gl);
+    textures = std::make_unique<TextureBuffer>(gl);
+    cubeBuffer = std::make_unique<CubeBuffer>(gl);
     camera = std::make_unique<Camera>();
+    occlusionCuller = std::make_unique<OcclusionCuller>();
 }
 
 void ModelRenderer::setModel(std::shared_ptr<Model3D> newModel) {
     model = std::move(newModel);
-    meshBuffers.clear();
     if (model) {
-        for (const auto& mesh : model->getMeshes()) {
-            meshBuffers.push_back(std::make_unique<MeshBuffer>(mesh));
-        }
+        stats.frame().bufferUploads += meshBuffers->upload(*model);
+        textures->assign(*model);
     }
 }
 
 void ModelRenderer::initialize() {
-    glewInit();
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
+    gl.initialize();
+    gl.enable(GL_DEPTH_TEST);
+    gl.enable(GL_CULL_FACE);
+    gl.cullFace(GL_BACK);
+    gl.clearColor(0.2f, 0.2f, 0.2f, 1.0f);
 }
 
 void ModelRenderer::resize(int width, int height) {
-    glViewport(0, 0, width, height);
+    gl.viewport(0, 0, width, height);
     camera->resize(width, height);
 }
 
@@ -37,26 +74,191 @@ void ModelRenderer::updateZoom(float deltaZ) {
     camera->updateZoom(deltaZ);
 }
 
-void ModelRenderer::render() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    camera->updateViewMatrix();
-    shader->use();
-
-    shader->setMat4("projection", camera->getProjectionMatrix());
-    shader->setMat4("view", camera->getViewMatrix());
-    shader->setVec3("lightPos", glm::vec3(10.0f, 10.0f, 10.0f));
-    shader->setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+// Camera and light come from the frame uniform buffer; only per-object uniforms are set here.
+void ModelRenderer::useProgram(const ShaderProgram& program) const {
+    program.use();
 
     glm::mat4 modelMatrix(1.0f);
-    shader->setMat4("model", modelMatrix);
+    program.setMat4("model", modelMatrix);
+    program.setMat3("normalMatrix", normalMatrixOf(modelMatrix));
+}
+
+void ModelRenderer::setMaterial(bool packed, uint32_t material) const {
+    const glm::vec4 color = colorOf(model->getMaterials().get(material));
+    if (packed) {
+        packedShader->setVec4(packedMaterialColorUniform, color);
+    } else {
+        shader->setVec4(materialColorUniform, color);
+    }
+}
+
+// One draw per visible submesh: the culler's ranges are per mesh and may run across
+// submesh borders, so they are clipped to each submesh in turn.
+void ModelRenderer::buildDrawList(const glm::mat4& viewProjection) {
+    drawList.clear();
+    const auto& meshes = model->getMeshes();
+    const auto& materials = model->getMaterials();
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const auto& allocation = meshBuffers->getAllocation(i);
+        if (allocation.indexCount == 0 || !visibility[i].visible) {
+            continue;
+        }
+
+        // View distance of the mesh centre: opaque draws go front to back, blended ones back to front
+        const auto& bounds = meshes[i]->getBounds();
+        const glm::vec4 centre = viewProjection * glm::vec4((bounds.min[0] + bounds.max[0]) * 0.5f, (bounds.min[1] + bounds.max[1]) * 0.5f,
+                                                            (bounds.min[2] + bounds.max[2]) * 0.5f, 1.0f);
+        const float depth = centre.w / Camera::FarPlane;
+
+        const auto& ranges = visibility[i].ranges;
+        size_t next = 0;
+        for (const auto& submesh : meshes[i]->getSubmeshes()) {
+            const uint32_t end = submesh.firstIndex + submesh.indexCount;
+            while (next < ranges.size() && ranges[next].firstIndex + ranges[next].indexCount <= submesh.firstIndex) {
+                ++next;
+            }
+            submeshRanges.clear();
+            for (size_t r = next; r < ranges.size() && ranges[r].firstIndex < end; ++r) {
+                const uint32_t first = std::max(ranges[r].firstIndex, submesh.firstIndex);
+                const uint32_t last = std::min(ranges[r].firstIndex + ranges[r].indexCount, end);
+                submeshRanges.push_back({first, last - first});
+            }
+
+            DrawList::State state;
+            state.program = allocation.packed ? PackedProgram : FloatProgram;
+            state.texture = textures->getTexture(submesh.material);
+            state.material = submesh.material;
+            state.blended = materials.get(submesh.material).dissolve < 1.0f;
+            drawList.add(state, depth, static_cast<uint32_t>(i), submeshRanges.data(), submeshRanges.size());
+        }
+    }
+    drawList.sort();
+}
+
+// Walks the sorted list and touches only the state that differs from the previous draw.
+// Draws with equal state are merged into one multi-draw; packed meshes also break the
+// batch when the mesh changes, for their dequantization uniforms.
+void ModelRenderer::submitDrawList(FrameStats& frameStats) {
+    const auto& ranges = drawList.getRanges();
+    uint32_t program = FloatProgram; // Left in use by the setup stage
+    bool arenaBound = false;
+    bool blending = false;
+    uint32_t texture = 0;
+    uint32_t material = ~0u;
+    uint32_t packedMesh = ~0u;
+
+    for (size_t i = 0; i < drawList.size(); ++i) {
+        const DrawList::Draw& draw = drawList[i];
+        const DrawList::State& state = draw.state;
+        const bool packed = state.program == PackedProgram;
+        const bool sameState = arenaBound && state.program == program && state.texture == texture &&
+                               state.material == material && state.blended == blending;
+        if (!sameState || (packed && draw.mesh != packedMesh)) {
+            frameStats.drawCalls += meshBuffers->submit();
+        }
+
+        if (!sameState) {
+            ++frameStats.stateChanges;
+            if (state.blended != blending) {
+                if (state.blended) {
+                    gl.enable(GL_BLEND);
+                    gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    gl.depthMask(GL_FALSE);
+                } else {
+                    gl.disable(GL_BLEND);
+                    gl.depthMask(GL_TRUE);
+                }
+                blending = state.blended;
+            }
+            if (state.program != program) {
+                useProgram(packed ? *packedShader : *shader);
+                program = state.program;
+                material = ~0u;
+                packedMesh = ~0u;
+                arenaBound = false;
+            }
+            if (!arenaBound) {
+                meshBuffers->bindArena(packed);
+                arenaBound = true;
+            }
+            if (state.texture != texture) {
+                gl.bindTexture(GL_TEXTURE_2D, state.texture);
+                texture = state.texture;
+            }
+            if (state.material != material) {
+                setMaterial(packed, state.material);
+                material = state.material;
+            }
+        }
+        if (packed && draw.mesh != packedMesh) {
+            const auto& allocation = meshBuffers->getAllocation(draw.mesh);
+            packedShader->setVec3(positionMinUniform, allocation.positionMin);
+            packedShader->setVec3(positionExtentUniform, allocation.positionExtent);
+            packedMesh = draw.mesh;
+        }
+        meshBuffers->appendRanges(draw.mesh, ranges.data() + draw.firstRange, draw.rangeCount);
+    }
+    frameStats.drawCalls += meshBuffers->submit();
+
+    if (blending) {
+        gl.disable(GL_BLEND);
+        gl.depthMask(GL_TRUE);
+    }
+    if (texture != 0) {
+        gl.bindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void ModelRenderer::render() {
+    OBJVIEWER_TRACE_SCOPE("ModelRenderer::render");
+    stats.beginFrame();
+    FrameStats& frameStats = stats.frame();
+    {
+        auto timer = stats.time(FrameStats::Setup);
+        gl.clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        camera->updateViewMatrix();
+        frameUniforms->update({camera->getProjectionMatrix(), camera->getViewMatrix(),
+                               glm::vec4(10.0f, 10.0f, 10.0f, 1.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)});
+        ++frameStats.bufferUploads;
+        useProgram(*shader);
+    }
 
-    if (model && !meshBuffers.empty()) {
-        for (const auto& buffer : meshBuffers) {
-            buffer->render();
+    if (model && meshBuffers->getMeshCount() > 0) {
+        const glm::mat4 viewProjection = camera->getProjectionMatrix() * camera->getViewMatrix();
+        {
+            auto timer = stats.time(FrameStats::Cull);
+            occlusionCuller->cull(*model, glm::value_ptr(viewProjection), visibility);
+        }
+        const auto& culled = occlusionCuller->getStats();
+        frameStats.trianglesSubmitted += culled.trianglesTotal;
+        frameStats.trianglesFrustumCulled += culled.trianglesOutsideFrustum;
+        frameStats.trianglesOccluded += culled.trianglesOccluded;
+        {
+            auto timer = stats.time(FrameStats::Setup);
+            buildDrawList(viewProjection);
         }
+
+        auto timer = stats.time(FrameStats::Draw);
+        submitDrawList(frameStats);
+        gl.bindVertexArray(0);
     } else {
+        auto timer = stats.time(FrameStats::Draw);
+        shader->setVec4(materialColorUniform, colorOf(Material{}));
+        gl.bindTexture(GL_TEXTURE_2D, textures->getWhite());
         cubeBuffer->render();
+        gl.bindTexture(GL_TEXTURE_2D, 0);
+        ++frameStats.drawCalls;
+        frameStats.trianglesSubmitted += 12;
     }
 
-    glUseProgram(0);
+    gl.useProgram(0);
+    stats.endFrame();
+}
+
+void ModelRenderer::setOcclusionCulling(bool enabled) {
+    occlusionCuller->setEnabled(enabled);
+}
+
+const OcclusionCuller::Stats& ModelRenderer::getOcclusionStats() const {
+    return occlusionCuller->getStats();
 }
\ No newline at end of file
@@ -4,24 +4,57 @@
 #include "ShaderProgram.h"
 #include "MeshBuffer.h"
 #include "CubeBuffer.h"
+#include "FrameUniformBuffer.h"
 #include "Camera.h"
 #include "Shaders.h"
+#include "GlDevice.h"
+#include "DrawList.h"
+#include "TextureBuffer.h"
 #include "../models/Model3D.h"
+#include "../render/RenderStats.h"
 
 class ModelRenderer {
 private:
+    GlDevice& gl;
     std::shared_ptr<Model3D> model;
     std::unique_ptr<ShaderProgram> shader;
-    std::vector<std::unique_ptr<MeshBuffer>> meshBuffers;
+    std::unique_ptr<ShaderProgram> packedShader;
+    std::unique_ptr<FrameUniformBuffer> frameUniforms;
+    ShaderProgram::UniformHandle positionMinUniform;
+    ShaderProgram::UniformHandle positionExtentUniform;
+    ShaderProgram::UniformHandle materialColorUniform;       // In shader
+    ShaderProgram::UniformHandle packedMaterialColorUniform; // In packedShader
+    std::unique_ptr<MeshBufferPool> meshBuffers;
+    std::unique_ptr<TextureBuffer> textures;
     std::unique_ptr<CubeBuffer> cubeBuffer;
     std::unique_ptr<Camera> camera;
+    std::unique_ptr<OcclusionCuller> occlusionCuller;
+    std::vector<OcclusionCuller::MeshVisibility> visibility;
+    DrawList drawList;
+    std::vector<OcclusionCuller::Range> submeshRanges;
+    RenderStats stats;
+
+    void useProgram(const ShaderProgram& program) const;
+    void setMaterial(bool packed, uint32_t material) const;
+    void buildDrawList(const glm::mat4& viewProjection);
+    void submitDrawList(FrameStats& frameStats);
 
 public:
-    ModelRenderer();
+    explicit ModelRenderer(GlDevice& device = GlDevice::system());
     void setModel(std::shared_ptr<Model3D> newModel);
     void initialize();
     void resize(int width, int height);
     void updateRotation(float deltaX, float deltaY);
     void updateZoom(float deltaZ);
     void render();
+
+    void setOcclusionCulling(bool enabled);
+    const OcclusionCuller::Stats& getOcclusionStats() const;
+
+    // Draws of the last frame in state order and how many state changes sorting saved.
+    const DrawList::Stats& getDrawListStats() const { return drawList.getStats(); }
+
+    // CPU time per stage and what was sent to GL; back-face culling and shading happen on the GPU and stay zero.
+    RenderStats& getRenderStats() { return stats; }
+    const RenderStats& getRenderStats() const { return stats; }
 };
\ No newline at end of file
@@ -0,0 +1,458 @@
+#include "RecordingGlDevice.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace {
+    std::vector<std::string> tokenize(const std::string& source) {
+        std::vector<std::string> tokens;
+        size_t i = 0;
+        while (i < source.size()) {
+            unsigned char c = static_cast<unsigned char>(source[i]);
+            if (std::isspace(c)) {
+                ++i;
+            } else if (std::isalnum(c) || c == '_') {
+                size_t start = i;
+                while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) {
+                    ++i;
+                }
+                tokens.push_back(source.substr(start, i - start));
+            } else {
+                tokens.emplace_back(1, source[i++]);
+            }
+        }
+        return tokens;
+    }
+
+    GLenum uniformType(const std::string& name) {
+        if (name == "mat4") return GL_FLOAT_MAT4;
+        if (name == "mat3") return GL_FLOAT_MAT3;
+        if (name == "vec4") return GL_FLOAT_VEC4;
+        if (name == "vec3") return GL_FLOAT_VEC3;
+        if (name == "vec2") return GL_FLOAT_VEC2;
+        if (name == "float") return GL_FLOAT;
+        if (name == "int") return GL_INT;
+        if (name == "sampler2D") return GL_SAMPLER_2D;
+        return 0;
+    }
+}
+
+const char* RecordingGlDevice::callName(Call call) {
+    static const char* const names[] = {
+        "Initialize", "Enable", "Disable", "CullFace", "BlendFunc", "DepthMask", "ClearColor", "Clear", "Viewport",
+        "GenVertexArrays", "DeleteVertexArrays", "BindVertexArray", "GenBuffers", "DeleteBuffers", "BindBuffer", "BindBufferBase",
+        "BufferData", "BufferSubData", "VertexAttribPointer", "EnableVertexAttribArray",
+        "GenTextures", "DeleteTextures", "BindTexture", "TexImage2D", "TexParameteri",
+        "DrawElements", "DrawElementsBaseVertex", "MultiDrawElementsBaseVertex",
+        "CreateShader", "ShaderSource", "CompileShader", "DeleteShader", "CreateProgram", "AttachShader", "LinkProgram",
+        "DeleteProgram", "UseProgram", "GetProgramiv", "GetActiveUniform", "GetUniformLocation", "GetUniformBlockIndex",
+        "UniformBlockBinding", "UniformMatrix3fv", "UniformMatrix4fv", "Uniform3fv", "Uniform4fv"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(Call::Count));
+    return names[static_cast<size_t>(call)];
+}
+
+size_t RecordingGlDevice::drawCalls() const {
+    return count(Call::DrawElements) + count(Call::DrawElementsBaseVertex) + count(Call::MultiDrawElementsBaseVertex);
+}
+
+size_t RecordingGlDevice::stateChanges() const {
+    return count(Call::BindVertexArray) + count(Call::BindBuffer) + count(Call::BindBufferBase) + count(Call::UseProgram) +
+           count(Call::BindTexture) + count(Call::Enable) + count(Call::Disable) + count(Call::CullFace) +
+           count(Call::BlendFunc) + count(Call::DepthMask);
+}
+
+void RecordingGlDevice::resetCounters() {
+    calls.fill(0);
+    drawnIndices = 0;
+    commands = 0;
+    invalidDraws = 0;
+    errors.clear();
+}
+
+std::vector<uint8_t>* RecordingGlDevice::boundBuffer(GLenum target) {
+    GLuint name = 0;
+    if (target == GL_ARRAY_BUFFER) {
+        name = boundArrayBuffer;
+    } else if (target == GL_UNIFORM_BUFFER) {
+        name = boundUniformBuffer;
+    } else if (target == GL_ELEMENT_ARRAY_BUFFER && boundVertexArray != 0) {
+        name = vertexArrays[boundVertexArray].elementBuffer;
+    }
+    auto it = buffers.find(name);
+    return it != buffers.end() ? &it->second : nullptr;
+}
+
+// Index range inside the element buffer and every referenced vertex inside the position buffer.
+void RecordingGlDevice::checkDraw(GLsizei count, GLenum type, const void* offset, GLint baseVertex) {
+    ++commands;
+    drawnIndices += static_cast<size_t>(std::max<GLsizei>(count, 0));
+
+    auto fail = [&](const std::string& message) {
+        ++invalidDraws;
+        errors.push_back(message);
+    };
+
+    if (boundVertexArray == 0) {
+        fail("draw without a vertex array");
+        return;
+    }
+    if (type != GL_UNSIGNED_INT) {
+        fail("only GL_UNSIGNED_INT indices are checked");
+        return;
+    }
+
+    const auto& state = vertexArrays[boundVertexArray];
+    const auto elements = buffers.find(state.elementBuffer);
+    const auto positions = buffers.find(state.positionBuffer);
+    if (elements == buffers.end() || positions == buffers.end() || state.positionStride == 0) {
+        fail("vertex array is missing its element or position buffer");
+        return;
+    }
+
+    size_t first = reinterpret_cast<size_t>(offset);
+    size_t bytes = static_cast<size_t>(count) * sizeof(uint32_t);
+    if (first % sizeof(uint32_t) != 0 || first + bytes > elements->second.size()) {
+        fail("index range outside the element buffer");
+        return;
+    }
+
+    size_t vertexCount = positions->second.size() / static_cast<size_t>(state.positionStride);
+    for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+        uint32_t index;
+        std::memcpy(&index, elements->second.data() + first + i * sizeof(uint32_t), sizeof(index));
+        int64_t vertex = static_cast<int64_t>(index) + baseVertex;
+        if (vertex < 0 || static_cast<size_t>(vertex) >= vertexCount) {
+            fail("index " + std::to_string(vertex) + " outside the vertex buffer of " + std::to_string(vertexCount));
+            return;
+        }
+    }
+}
+
+void RecordingGlDevice::initialize() { record(Call::Initialize); }
+
+void RecordingGlDevice::enable(GLenum) { record(Call::Enable); }
+void RecordingGlDevice::disable(GLenum) { record(Call::Disable); }
+void RecordingGlDevice::cullFace(GLenum) { record(Call::CullFace); }
+void RecordingGlDevice::blendFunc(GLenum, GLenum) { record(Call::BlendFunc); }
+void RecordingGlDevice::depthMask(GLboolean) { record(Call::DepthMask); }
+void RecordingGlDevice::clearColor(GLfloat, GLfloat, GLfloat, GLfloat) { record(Call::ClearColor); }
+void RecordingGlDevice::clear(GLbitfield) { record(Call::Clear); }
+void RecordingGlDevice::viewport(GLint, GLint, GLsizei, GLsizei) { record(Call::Viewport); }
+
+void RecordingGlDevice::genVertexArrays(GLsizei count, GLuint* arrays) {
+    record(Call::GenVertexArrays);
+    for (GLsizei i = 0; i < count; ++i) {
+        arrays[i] = nextName++;
+        vertexArrays[arrays[i]] = VertexArrayState{};
+    }
+}
+
+void RecordingGlDevice::deleteVertexArrays(GLsizei count, const GLuint* arrays) {
+    record(Call::DeleteVertexArrays);
+    for (GLsizei i = 0; i < count; ++i) {
+        vertexArrays.erase(arrays[i]);
+        if (boundVertexArray == arrays[i]) {
+            boundVertexArray = 0;
+        }
+    }
+}
+
+void RecordingGlDevice::bindVertexArray(GLuint array) {
+    record(Call::BindVertexArray);
+    boundVertexArray = array;
+}
+
+void RecordingGlDevice::genBuffers(GLsizei count, GLuint* names) {
+    record(Call::GenBuffers);
+    for (GLsizei i = 0; i < count; ++i) {
+        names[i] = nextName++;
+        buffers[names[i]];
+    }
+}
+
+void RecordingGlDevice::deleteBuffers(GLsizei count, const GLuint* names) {
+    record(Call::DeleteBuffers);
+    for (GLsizei i = 0; i < count; ++i) {
+        buffers.erase(names[i]);
+    }
+}
+
+void RecordingGlDevice::bindBuffer(GLenum target, GLuint buffer) {
+    record(Call::BindBuffer);
+    if (target == GL_ARRAY_BUFFER) {
+        boundArrayBuffer = buffer;
+    } else if (target == GL_UNIFORM_BUFFER) {
+        boundUniformBuffer = buffer;
+    } else if (target == GL_ELEMENT_ARRAY_BUFFER && boundVertexArray != 0) {
+        vertexArrays[boundVertexArray].elementBuffer = buffer;
+    }
+}
+
+void RecordingGlDevice::bindBufferBase(GLenum target, GLuint, GLuint buffer) {
+    record(Call::BindBufferBase);
+    if (target == GL_UNIFORM_BUFFER) {
+        boundUniformBuffer = buffer;
+    }
+}
+
+void RecordingGlDevice::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum) {
+    record(Call::BufferData);
+    if (auto* buffer = boundBuffer(target)) {
+        buffer->assign(static_cast<size_t>(size), 0);
+        if (data) {
+            std::memcpy(buffer->data(), data, static_cast<size_t>(size));
+        }
+    }
+}
+
+void RecordingGlDevice::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    record(Call::BufferSubData);
+    auto* buffer = boundBuffer(target);
+    if (!buffer || static_cast<size_t>(offset + size) > buffer->size()) {
+        ++invalidDraws;
+        errors.push_back("bufferSubData outside the buffer");
+        return;
+    }
+    std::memcpy(buffer->data() + offset, data, static_cast<size_t>(size));
+}
+
+void RecordingGlDevice::vertexAttribPointer(GLuint index, GLint, GLenum, GLboolean, GLsizei stride, const void*) {
+    record(Call::VertexAttribPointer);
+    if (index == 0 && boundVertexArray != 0) {
+        vertexArrays[boundVertexArray].positionBuffer = boundArrayBuffer;
+        vertexArrays[boundVertexArray].positionStride = stride;
+    }
+}
+
+void RecordingGlDevice::enableVertexAttribArray(GLuint) { record(Call::EnableVertexAttribArray); }
+void RecordingGlDevice::genTextures(GLsizei count, GLuint* names) {
+    record(Call::GenTextures);
+    for (GLsizei i = 0; i < count; ++i) {
+        names[i] = nextName++;
+        textures[names[i]] = 0;
+    }
+}
+
+void RecordingGlDevice::deleteTextures(GLsizei count, const GLuint* names) {
+    record(Call::DeleteTextures);
+    for (GLsizei i = 0; i < count; ++i) {
+        textures.erase(names[i]);
+        if (boundTexture == names[i]) {
+            boundTexture = 0;
+        }
+    }
+}
+
+void RecordingGlDevice::bindTexture(GLenum, GLuint texture) {
+    record(Call::BindTexture);
+    if (texture != 0 && textures.find(texture) == textures.end()) {
+        errors.push_back("bindTexture with unknown texture " + std::to_string(texture));
+    }
+    boundTexture = texture;
+}
+
+// RGBA8 is the only format the renderer uploads
+void RecordingGlDevice::texImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLenum, GLenum, const void*) {
+    record(Call::TexImage2D);
+    if (boundTexture == 0) {
+        errors.push_back("texImage2D without a bound texture");
+        return;
+    }
+    textures[boundTexture] += static_cast<size_t>(std::max<GLsizei>(width, 0)) * std::max<GLsizei>(height, 0) * 4;
+}
+
+void RecordingGlDevice::texParameteri(GLenum, GLenum, GLint) {
+    record(Call::TexParameteri);
+    if (boundTexture == 0) {
+        errors.push_back("texParameteri without a bound texture");
+    }
+}
+
+void RecordingGlDevice::drawElements(GLenum, GLsizei count, GLenum type, const void* offset) {
+    record(Call::DrawElements);
+    checkDraw(count, type, offset, 0);
+}
+
+void RecordingGlDevice::drawElementsBaseVertex(GLenum, GLsizei count, GLenum type, const void* offset, GLint baseVertex) {
+    record(Call::DrawElementsBaseVertex);
+    checkDraw(count, type, offset, baseVertex);
+}
+
+void RecordingGlDevice::multiDrawElementsBaseVertex(GLenum, const GLsizei* counts, GLenum type, const void* const* offsets,
+                                                    GLsizei drawCount, const GLint* baseVertices) {
+    record(Call::MultiDrawElementsBaseVertex);
+    for (GLsizei i = 0; i < drawCount; ++i) {
+        checkDraw(counts[i], type, offsets[i], baseVertices[i]);
+    }
+}
+
+GLuint RecordingGlDevice::createShader(GLenum) {
+    record(Call::CreateShader);
+    return nextName++;
+}
+
+void RecordingGlDevice::shaderSource(GLuint shader, const char* source) {
+    record(Call::ShaderSource);
+    shaderSources[shader] = source;
+}
+
+void RecordingGlDevice::compileShader(GLuint) { record(Call::CompileShader); }
+void RecordingGlDevice::deleteShader(GLuint) { record(Call::DeleteShader); }
+
+GLuint RecordingGlDevice::createProgram() {
+    record(Call::CreateProgram);
+    return nextName++;
+}
+
+void RecordingGlDevice::attachShader(GLuint program, GLuint shader) {
+    record(Call::AttachShader);
+    programs[program].shaders.push_back(shader);
+}
+
+// Default-block uniforms get locations in declaration order; members of a uniform
+// block are active too, but have no location, as in GL.
+void RecordingGlDevice::linkProgram(GLuint program) {
+    record(Call::LinkProgram);
+    ProgramState& state = programs[program];
+    state.uniforms.clear();
+    state.blocks.clear();
+
+    GLint nextLocation = 0;
+    auto addUniform = [&](const std::string& type, const std::string& name, bool inBlock) {
+        for (const auto& uniform : state.uniforms) {
+            if (uniform.name == name) {
+                return;
+            }
+        }
+        state.uniforms.push_back({name, uniformType(type), inBlock ? -1 : nextLocation++});
+    };
+
+    for (GLuint shader : state.shaders) {
+        const auto tokens = tokenize(shaderSources[shader]);
+        for (size_t i = 0; i + 2 < tokens.size(); ++i) {
+            if (tokens[i] != "uniform") {
+                continue;
+            }
+            if (tokens[i + 2] == "{") {
+                state.blocks.push_back(tokens[i + 1]);
+                for (i += 3; i + 2 < tokens.size() && tokens[i] != "}"; i += 3) {
+                    addUniform(tokens[i], tokens[i + 1], true);
+                }
+            } else {
+                addUniform(tokens[i + 1], tokens[i + 2], false);
+            }
+        }
+    }
+}
+
+void RecordingGlDevice::deleteProgram(GLuint program) {
+    record(Call::DeleteProgram);
+    programs.erase(program);
+    if (currentProgram == program) {
+        currentProgram = 0;
+    }
+}
+
+void RecordingGlDevice::useProgram(GLuint program) {
+    record(Call::UseProgram);
+    currentProgram = program;
+}
+
+void RecordingGlDevice::getProgramiv(GLuint program, GLenum parameter, GLint* value) {
+    record(Call::GetProgramiv);
+    const ProgramState& state = programs[program];
+    if (parameter == GL_ACTIVE_UNIFORMS) {
+        *value = static_cast<GLint>(state.uniforms.size());
+    } else if (parameter == GL_ACTIVE_UNIFORM_MAX_LENGTH) {
+        size_t length = 0;
+        for (const auto& uniform : state.uniforms) {
+            length = std::max(length, uniform.name.size() + 1);
+        }
+        *value = static_cast<GLint>(length);
+    } else if (parameter == GL_LINK_STATUS) {
+        *value = GL_TRUE;
+    } else {
+        *value = 0;
+    }
+}
+
+void RecordingGlDevice::getActiveUniform(GLuint program, GLuint index, GLsizei bufferSize, GLsizei* length, GLint* size,
+                                         GLenum* type, GLchar* name) {
+    record(Call::GetActiveUniform);
+    const auto& uniforms = programs[program].uniforms;
+    if (index >= uniforms.size() || bufferSize <= 0) {
+        errors.push_back("getActiveUniform index out of range");
+        return;
+    }
+    const ActiveUniform& uniform = uniforms[index];
+    size_t copied = std::min(uniform.name.size(), static_cast<size_t>(bufferSize - 1));
+    std::memcpy(name, uniform.name.data(), copied);
+    name[copied] = '\0';
+    if (length) {
+        *length = static_cast<GLsizei>(copied);
+    }
+    *size = 1;
+    *type = uniform.type;
+}
+
+GLint RecordingGlDevice::getUniformLocation(GLuint program, const char* name) {
+    record(Call::GetUniformLocation);
+    for (const auto& uniform : programs[program].uniforms) {
+        if (uniform.name == name) {
+            return uniform.location;
+        }
+    }
+    return -1;
+}
+
+GLuint RecordingGlDevice::getUniformBlockIndex(GLuint program, const char* name) {
+    record(Call::GetUniformBlockIndex);
+    const auto& blocks = programs[program].blocks;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (blocks[i] == name) {
+            return static_cast<GLuint>(i);
+        }
+    }
+    return GL_INVALID_INDEX;
+}
+
+void RecordingGlDevice::uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint) {
+    record(Call::UniformBlockBinding);
+    if (blockIndex >= programs[program].blocks.size()) {
+        errors.push_back("uniformBlockBinding with an unknown block");
+    }
+}
+
+// Location -1 is silently ignored by GL; any other location must belong to the current program.
+void RecordingGlDevice::checkUniform(GLint location) {
+    if (location == -1) {
+        return;
+    }
+    for (const auto& uniform : programs[currentProgram].uniforms) {
+        if (uniform.location == location) {
+            return;
+        }
+    }
+    errors.push_back("uniform location " + std::to_string(location) + " is not active in program " + std::to_string(currentProgram));
+}
+
+void RecordingGlDevice::uniformMatrix3fv(GLint location, GLsizei, GLboolean, const GLfloat*) {
+    record(Call::UniformMatrix3fv);
+    checkUniform(location);
+}
+
+void RecordingGlDevice::uniformMatrix4fv(GLint location, GLsizei, GLboolean, const GLfloat*) {
+    record(Call::UniformMatrix4fv);
+    checkUniform(location);
+}
+
+void RecordingGlDevice::uniform3fv(GLint location, GLsizei, const GLfloat*) {
+    record(Call::Uniform3fv);
+    checkUniform(location);
+}
+
+void RecordingGlDevice::uniform4fv(GLint location, GLsizei, const GLfloat*) {
+    record(Call::Uniform4fv);
+    checkUniform(location);
+}
\ No newline at end of file
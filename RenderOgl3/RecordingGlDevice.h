@@ -0,0 +1,141 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GlDevice.h"
+
+// GlDevice that needs no context: counts every call, hands out fake object names
+// and keeps buffer contents, so indexed draws can be checked against the bound
+// element and vertex buffers the way a driver would. Textures are tracked by name
+// and uploaded bytes, so binding a deleted texture is reported. Linking scans the shader
+// sources for uniform declarations, so reflection and uniform locations behave
+// like a real program and uniforms set on the wrong program are reported.
+class RecordingGlDevice final : public GlDevice {
+public:
+    enum class Call {
+        Initialize, Enable, Disable, CullFace, BlendFunc, DepthMask, ClearColor, Clear, Viewport,
+        GenVertexArrays, DeleteVertexArrays, BindVertexArray, GenBuffers, DeleteBuffers, BindBuffer, BindBufferBase,
+        BufferData, BufferSubData, VertexAttribPointer, EnableVertexAttribArray,
+        GenTextures, DeleteTextures, BindTexture, TexImage2D, TexParameteri,
+        DrawElements, DrawElementsBaseVertex, MultiDrawElementsBaseVertex,
+        CreateShader, ShaderSource, CompileShader, DeleteShader, CreateProgram, AttachShader, LinkProgram,
+        DeleteProgram, UseProgram, GetProgramiv, GetActiveUniform, GetUniformLocation, GetUniformBlockIndex,
+        UniformBlockBinding, UniformMatrix3fv, UniformMatrix4fv, Uniform3fv, Uniform4fv,
+        Count
+    };
+
+    static const char* callName(Call call);
+
+private:
+    struct VertexArrayState {
+        GLuint elementBuffer = 0;
+        GLuint positionBuffer = 0;
+        GLsizei positionStride = 0;
+    };
+
+    struct ActiveUniform {
+        std::string name;
+        GLenum type = 0;
+        GLint location = -1;
+    };
+
+    struct ProgramState {
+        std::vector<GLuint> shaders;
+        std::vector<ActiveUniform> uniforms;
+        std::vector<std::string> blocks;
+    };
+
+    std::array<size_t, static_cast<size_t>(Call::Count)> calls{};
+    size_t drawnIndices = 0;
+    size_t commands = 0;
+    size_t invalidDraws = 0;
+    std::vector<std::string> errors;
+
+    GLuint nextName = 1;
+    GLuint boundVertexArray = 0;
+    GLuint boundArrayBuffer = 0;
+    GLuint boundUniformBuffer = 0;
+    GLuint currentProgram = 0;
+    GLuint boundTexture = 0;
+    std::unordered_map<GLuint, std::vector<uint8_t>> buffers;
+    std::unordered_map<GLuint, size_t> textures; // Bytes over all levels
+    std::unordered_map<GLuint, VertexArrayState> vertexArrays;
+    std::unordered_map<GLuint, std::string> shaderSources;
+    std::unordered_map<GLuint, ProgramState> programs;
+
+    void record(Call call) { ++calls[static_cast<size_t>(call)]; }
+    std::vector<uint8_t>* boundBuffer(GLenum target);
+    void checkDraw(GLsizei count, GLenum type, const void* offset, GLint baseVertex);
+    void checkUniform(GLint location);
+
+public:
+    size_t count(Call call) const { return calls[static_cast<size_t>(call)]; }
+    size_t drawCalls() const;
+    // Individual draws, counting every entry of a multi-draw: what one call per range would cost.
+    size_t drawCommands() const { return commands; }
+    // Binds, program switches and fixed-function state; uniform uploads are counted per call.
+    size_t stateChanges() const;
+    size_t indicesDrawn() const { return drawnIndices; }
+    size_t invalidDrawCount() const { return invalidDraws; }
+    size_t textureCount() const { return textures.size(); }
+    const std::vector<std::string>& getErrors() const { return errors; }
+
+    // Clears the counters but keeps objects and buffer contents, e.g. between frames.
+    void resetCounters();
+
+    void initialize() override;
+
+    void enable(GLenum capability) override;
+    void disable(GLenum capability) override;
+    void cullFace(GLenum mode) override;
+    void blendFunc(GLenum source, GLenum destination) override;
+    void depthMask(GLboolean enabled) override;
+    void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) override;
+    void clear(GLbitfield mask) override;
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+
+    void genVertexArrays(GLsizei count, GLuint* arrays) override;
+    void deleteVertexArrays(GLsizei count, const GLuint* arrays) override;
+    void bindVertexArray(GLuint array) override;
+    void genBuffers(GLsizei count, GLuint* names) override;
+    void deleteBuffers(GLsizei count, const GLuint* names) override;
+    void bindBuffer(GLenum target, GLuint buffer) override;
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer) override;
+    void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+    void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
+    void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) override;
+    void enableVertexAttribArray(GLuint index) override;
+    void genTextures(GLsizei count, GLuint* names) override;
+    void deleteTextures(GLsizei count, const GLuint* names) override;
+    void bindTexture(GLenum target, GLuint texture) override;
+    void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format,
+                    GLenum type, const void* pixels) override;
+    void texParameteri(GLenum target, GLenum parameter, GLint value) override;
+
+    void drawElements(GLenum mode, GLsizei count, GLenum type, const void* offset) override;
+    void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* offset, GLint baseVertex) override;
+    void multiDrawElementsBaseVertex(GLenum mode, const GLsizei* counts, GLenum type, const void* const* offsets,
+                                     GLsizei drawCount, const GLint* baseVertices) override;
+
+    GLuint createShader(GLenum type) override;
+    void shaderSource(GLuint shader, const char* source) override;
+    void compileShader(GLuint shader) override;
+    void deleteShader(GLuint shader) override;
+    GLuint createProgram() override;
+    void attachShader(GLuint program, GLuint shader) override;
+    void linkProgram(GLuint program) override;
+    void deleteProgram(GLuint program) override;
+    void useProgram(GLuint program) override;
+    void getProgramiv(GLuint program, GLenum parameter, GLint* value) override;
+    void getActiveUniform(GLuint program, GLuint index, GLsizei bufferSize, GLsizei* length, GLint* size, GLenum* type,
+                          GLchar* name) override;
+    GLint getUniformLocation(GLuint program, const char* name) override;
+    GLuint getUniformBlockIndex(GLuint program, const char* name) override;
+    void uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) override;
+    void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) override;
+    void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) override;
+    void uniform3fv(GLint location, GLsizei count, const GLfloat* value) override;
+    void uniform4fv(GLint location, GLsizei count, const GLfloat* value) override;
+};
\ No newline at end of file
@@ -1,35 +1,111 @@
 #include "ShaderProgram.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <glm/gtc/type_ptr.hpp>
 
-ShaderProgram::ShaderProgram(const char* vertexSource, const char* fragmentSource) {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSource, nullptr);
-    glCompileShader(vertexShader);
+ShaderProgram::ShaderProgram(const char* vertexSource, const char* fragmentSource, GlDevice& device) : gl(device) {
+    GLuint vertexShader = gl.createShader(GL_VERTEX_SHADER);
+    gl.shaderSource(vertexShader, vertexSource);
+    gl.compileShader(vertexShader);
 
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
-    glCompileShader(fragmentShader);
+    GLuint fragmentShader = gl.createShader(GL_FRAGMENT_SHADER);
+    gl.shaderSource(fragmentShader, fragmentSource);
+    gl.compileShader(fragmentShader);
 
-    programID = glCreateProgram();
-    glAttachShader(programID, vertexShader);
-    glAttachShader(programID, fragmentShader);
-    glLinkProgram(programID);
+    programID = gl.createProgram();
+    gl.attachShader(programID, vertexShader);
+    gl.attachShader(programID, fragmentShader);
+    gl.linkProgram(programID);
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    gl.deleteShader(vertexShader);
+    gl.deleteShader(fragmentShader);
+
+    reflectUniforms();
+
+    GLuint frameBlock = gl.getUniformBlockIndex(programID, FrameBlockName);
+    if (frameBlock != GL_INVALID_INDEX) {
+        gl.uniformBlockBinding(programID, frameBlock, FrameBlockBinding);
+    }
 }
 
 ShaderProgram::~ShaderProgram() {
-    glDeleteProgram(programID);
+    gl.deleteProgram(programID);
+}
+
+// The only place that asks GL for locations. Uniform block members are active
+// but have no location and are skipped.
+void ShaderProgram::reflectUniforms() {
+    GLint count = 0;
+    GLint maxLength = 0;
+    gl.getProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+    gl.getProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(static_cast<size_t>(std::max(maxLength, 1)), '\0');
+    uniforms.clear();
+    uniforms.reserve(static_cast<size_t>(count));
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        gl.getActiveUniform(programID, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+
+        // Arrays are reported as "name[0]"
+        std::string_view uniformName(name.data(), static_cast<size_t>(length));
+        if (uniformName.size() > 3 && uniformName.substr(uniformName.size() - 3) == "[0]") {
+            uniformName.remove_suffix(3);
+        }
+
+        GLint location = gl.getUniformLocation(programID, std::string(uniformName).c_str());
+        if (location >= 0) {
+            uniforms.push_back({hashName(uniformName), location});
+        }
+    }
+
+    std::sort(uniforms.begin(), uniforms.end(), [](const UniformEntry& lhs, const UniformEntry& rhs) {
+        return lhs.hash < rhs.hash;
+    });
+    for (size_t i = 1; i < uniforms.size(); ++i) {
+        if (uniforms[i].hash == uniforms[i - 1].hash) {
+            throw std::runtime_error("Uniform name hash collision in shader program");
+        }
+    }
+}
+
+ShaderProgram::UniformHandle ShaderProgram::findUniform(UniformName name) const {
+    auto it = std::lower_bound(uniforms.begin(), uniforms.end(), name.hash, [](const UniformEntry& entry, uint32_t hash) {
+        return entry.hash < hash;
+    });
+    if (it == uniforms.end() || it->hash != name.hash) {
+        return {};
+    }
+    return {it->location};
 }
 
 void ShaderProgram::use() const {
-    glUseProgram(programID);
+    gl.useProgram(programID);
+}
+
+void ShaderProgram::setMat3(UniformHandle uniform, const glm::mat3& mat) const {
+    if (uniform.isValid()) {
+        gl.uniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
+}
+
+void ShaderProgram::setMat4(UniformHandle uniform, const glm::mat4& mat) const {
+    if (uniform.isValid()) {
+        gl.uniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+    }
 }
 
-void ShaderProgram::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(programID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+void ShaderProgram::setVec3(UniformHandle uniform, const glm::vec3& vec) const {
+    if (uniform.isValid()) {
+        gl.uniform3fv(uniform.location, 1, glm::value_ptr(vec));
+    }
 }
 
-void ShaderProgram::setVec3(const std::string& name, const glm::vec3& vec) const {
-    glUniform3fv(glGetUniformLocation(programID, name.c_str()), 1, glm::value_ptr(vec));
+void ShaderProgram::setVec4(UniformHandle uniform, const glm::vec4& vec) const {
+    if (uniform.isValid()) {
+        gl.uniform4fv(uniform.location, 1, glm::value_ptr(vec));
+    }
 }
\ No newline at end of file
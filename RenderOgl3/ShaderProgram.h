@@ -1,16 +1,69 @@
 #pragma once
 #include <GL/glew.h>
-#include <string>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "GlDevice.h"
 
 class ShaderProgram {
+public:
+    // FNV-1a of the uniform name, computed by the compiler for string literals.
+    static constexpr uint32_t hashName(std::string_view name) {
+        uint32_t hash = 2166136261u;
+        for (char c : name) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        }
+        return hash;
+    }
+
+    // setMat4("model", ...) hashes the literal at compile time, so a lookup is a
+    // binary search in the reflected table with no string work and no GL query.
+    struct UniformName {
+        uint32_t hash;
+        consteval UniformName(const char* name) : hash(hashName(name)) {}
+    };
+
+    // Location resolved once, for uniforms set on every draw.
+    struct UniformHandle {
+        GLint location = -1;
+        bool isValid() const { return location >= 0; }
+    };
+
+    // Binding point of the per-frame block, see FrameUniformBuffer.
+    static constexpr GLuint FrameBlockBinding = 0;
+    static constexpr const char* FrameBlockName = "FrameData";
+
 private:
+    struct UniformEntry {
+        uint32_t hash;
+        GLint location;
+    };
+
+    GlDevice& gl;
     GLuint programID;
+    std::vector<UniformEntry> uniforms;
+
+    void reflectUniforms();
 
 public:
-    ShaderProgram(const char* vertexSource, const char* fragmentSource);
+    ShaderProgram(const char* vertexSource, const char* fragmentSource, GlDevice& device = GlDevice::system());
     ~ShaderProgram();
 
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
     void use() const;
-    void setMat4(const std::string& name, const glm::mat4& mat) const;
-    void setVec3(const std::string& name, const glm::vec3& vec) const;
+
+    UniformHandle findUniform(UniformName name) const;
+    size_t getUniformCount() const { return uniforms.size(); }
+
+    void setMat3(UniformHandle uniform, const glm::mat3& mat) const;
+    void setMat4(UniformHandle uniform, const glm::mat4& mat) const;
+    void setVec3(UniformHandle uniform, const glm::vec3& vec) const;
+    void setVec4(UniformHandle uniform, const glm::vec4& vec) const;
+    void setMat3(UniformName name, const glm::mat3& mat) const { setMat3(findUniform(name), mat); }
+    void setMat4(UniformName name, const glm::mat4& mat) const { setMat4(findUniform(name), mat); }
+    void setVec3(UniformName name, const glm::vec3& vec) const { setVec3(findUniform(name), vec); }
+    void setVec4(UniformName name, const glm::vec4& vec) const { setVec4(findUniform(name), vec); }
 };
\ No newline at end of file
@@ -7,17 +7,62 @@ namespace Shaders {
     layout(location = 1) in vec3 aNormal;
     layout(location = 2) in vec2 aTexCoord;
 
-    uniform mat4 projection;
-    uniform mat4 view;
+    layout(std140) uniform FrameData {
+        mat4 projection;
+        mat4 view;
+        vec4 lightPos;
+        vec4 lightColor;
+    };
     uniform mat4 model;
+    uniform mat3 normalMatrix;
 
     out vec3 FragPos;
     out vec3 Normal;
+    out vec2 TexCoord;
 
     void main() {
         FragPos = vec3(model * vec4(aPos, 1.0));
-        Normal = mat3(transpose(inverse(model))) * aNormal;
+        Normal = normalMatrix * aNormal;
         gl_Position = projection * view * vec4(FragPos, 1.0);
+        TexCoord = aTexCoord;
+    }
+    )";
+
+    const char* packedVertexShaderSource = R"(
+    #version 330 core
+    layout(location = 0) in vec3 aPos;
+    layout(location = 1) in vec2 aNormal;
+    layout(location = 2) in vec2 aTexCoord;
+
+    layout(std140) uniform FrameData {
+        mat4 projection;
+        mat4 view;
+        vec4 lightPos;
+        vec4 lightColor;
+    };
+    uniform mat4 model;
+    uniform mat3 normalMatrix;
+    uniform vec3 positionMin;
+    uniform vec3 positionExtent;
+
+    out vec3 FragPos;
+    out vec3 Normal;
+    out vec2 TexCoord;
+
+    vec3 octDecode(vec2 e) {
+        vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+        float t = max(-n.z, 0.0);
+        n.x += n.x >= 0.0 ? -t : t;
+        n.y += n.y >= 0.0 ? -t : t;
+        return normalize(n);
+    }
+
+    void main() {
+        vec3 position = positionMin + aPos * positionExtent;
+        FragPos = vec3(model * vec4(position, 1.0));
+        Normal = normalMatrix * octDecode(aNormal);
+        gl_Position = projection * view * vec4(FragPos, 1.0);
+        TexCoord = aTexCoord;
     }
     )";
 
@@ -25,23 +70,33 @@ namespace Shaders {
     #version 330 core
     in vec3 FragPos;
     in vec3 Normal;
+    in vec2 TexCoord;
+
+    layout(std140) uniform FrameData {
+        mat4 projection;
+        mat4 view;
+        vec4 lightPos;
+        vec4 lightColor;
+    };
 
-    uniform vec3 lightPos;
-    uniform vec3 lightColor;
+    // Diffuse colour and dissolve of the material being drawn
+    uniform vec4 materialColor;
+    // map_Kd on texture unit 0; a white texel for untextured materials
+    uniform sampler2D diffuseMap;
 
     out vec4 FragColor;
 
     void main() {
         vec3 norm = normalize(Normal);
-        vec3 lightDir = normalize(lightPos - FragPos);
+        vec3 lightDir = normalize(lightPos.xyz - FragPos);
         
         float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = diff * lightColor;
+        vec3 diffuse = diff * lightColor.rgb;
         
-        vec3 ambient = 0.2 * lightColor;
-        vec3 result = (ambient + diffuse) * vec3(0.8, 0.8, 0.8);
+        vec3 ambient = 0.2 * lightColor.rgb;
+        vec3 result = (ambient + diffuse) * materialColor.rgb * texture(diffuseMap, TexCoord).rgb;
         
-        FragColor = vec4(result, 1.0);
+        FragColor = vec4(result, materialColor.a);
     }
     )";
 }
\ No newline at end of file
@@ -2,5 +2,6 @@
 
 namespace Shaders {
     extern const char* vertexShaderSource;
+    extern const char* packedVertexShaderSource;
     extern const char* fragmentShaderSource;
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "TextureBuffer.h"
+
+TextureBuffer::TextureBuffer(GlDevice& device) : gl(device) {
+    const uint8_t pixel[4] = {255, 255, 255, 255};
+    gl.genTextures(1, &white);
+    gl.bindTexture(GL_TEXTURE_2D, white);
+    gl.texImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    gl.bindTexture(GL_TEXTURE_2D, 0);
+}
+
+TextureBuffer::~TextureBuffer() {
+    for (const auto& [hash, texture] : uploaded) {
+        gl.deleteTextures(1, &texture.name);
+    }
+    gl.deleteTextures(1, &white);
+}
+
+GLuint TextureBuffer::upload(const Texture& texture) {
+    GLuint name = 0;
+    gl.genTextures(1, &name);
+    gl.bindTexture(GL_TEXTURE_2D, name);
+    size_t bytes = 0;
+    for (size_t level = 0; level < texture.getLevelCount(); ++level) {
+        const auto& size = texture.getLevel(level);
+        gl.texImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA8, static_cast<GLsizei>(size.width),
+                      static_cast<GLsizei>(size.height), GL_RGBA, GL_UNSIGNED_BYTE, texture.getData(level));
+        bytes += static_cast<size_t>(size.width) * size.height * 4;
+    }
+    gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.getLevelCount() - 1));
+    gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    uploaded[texture.getContentHash()] = {name, bytes};
+    return name;
+}
+
+size_t TextureBuffer::assign(const Model3D& model) {
+    const auto& materials = model.getMaterials();
+    std::unordered_map<uint64_t, Uploaded> previous = std::move(uploaded);
+    uploaded.clear();
+    materialTextures.assign(materials.size(), white);
+
+    size_t uploads = 0;
+    for (uint32_t material = 0; material < materials.size(); ++material) {
+        const Texture* texture = model.getTexture(material);
+        if (!texture) {
+            continue;
+        }
+        const uint64_t hash = texture->getContentHash();
+        if (auto it = uploaded.find(hash); it != uploaded.end()) {
+            materialTextures[material] = it->second.name;
+        } else if (auto kept = previous.find(hash); kept != previous.end()) {
+            materialTextures[material] = kept->second.name;
+            uploaded.insert(previous.extract(kept));
+        } else {
+            materialTextures[material] = upload(*texture);
+            ++uploads;
+        }
+    }
+    if (uploads > 0) {
+        gl.bindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    for (const auto& [hash, texture] : previous) {
+        gl.deleteTextures(1, &texture.name);
+    }
+    size_t bytes = 4;
+    for (const auto& [hash, texture] : uploaded) {
+        bytes += texture.bytes;
+    }
+    gpuMemory.set(bytes);
+    return uploads;
+}
\ No newline at end of file
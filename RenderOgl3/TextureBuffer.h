@@ -0,0 +1,46 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "GlDevice.h"
+#include "../models/Model3D.h"
+#include "../core/MemoryStats.h"
+
+// GL textures for the materials of the current model. Textures are keyed by content
+// hash, so materials and models sharing an image share one GL texture, and a new model
+// only uploads what the previous one did not have. The stored mip chain is uploaded
+// level by level instead of calling glGenerateMipmap.
+class TextureBuffer {
+private:
+    struct Uploaded {
+        GLuint name = 0;
+        size_t bytes = 0;
+    };
+
+    GlDevice& gl;
+    GLuint white = 0; // 1x1 texture for untextured materials, so one shader serves both
+    std::unordered_map<uint64_t, Uploaded> uploaded;
+    std::vector<GLuint> materialTextures;
+    MemoryAccount gpuMemory{ MemoryTag::GpuBuffers };
+
+    GLuint upload(const Texture& texture);
+
+public:
+    explicit TextureBuffer(GlDevice& device);
+    ~TextureBuffer();
+
+    TextureBuffer(const TextureBuffer&) = delete;
+    TextureBuffer& operator=(const TextureBuffer&) = delete;
+
+    // Textures of the model's materials; ones no longer used are deleted.
+    // Returns the number of textures uploaded.
+    size_t assign(const Model3D& model);
+
+    // Texture of a material of the assigned model, the white texture if it has none.
+    GLuint getTexture(uint32_t material) const {
+        return material < materialTextures.size() ? materialTextures[material] : white;
+    }
+    GLuint getWhite() const { return white; }
+    size_t getTextureCount() const { return uploaded.size(); }
+};
\ No newline at end of file
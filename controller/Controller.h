@@ -2,6 +2,8 @@
 #define OBJVIEWER__CONTROLLER_H
 
 #include "IEventHandler.h"
+#include "EventQueue.h"
+#include "../core/JobSystem.h"
 #include "../render/Renderer.h"
 #include "../model/loaders/OBJLoader.h"
 #include "../model/Model.h"
@@ -10,13 +12,40 @@
 class Controller : public IEventHandler {
 private:
     std::unique_ptr<Renderer> renderer;
-    std::unique_ptr<Model> model;
+    EventQueue eventQueue;
+    JobSystem::TaskGroup loads; // Загрузки в общем пуле, ждём их в деструкторе
+    MeshHandle modelMesh; // Текущая модель, загруженная в рендер
+
+    // Загрузка и преобразование задачей общего пула, результат возвращается событием
+    void loadInBackground(std::string filePath) {
+        JobSystem::global().run(loads, [this, filePath = std::move(filePath)]() mutable {
+            OBJVIEWER_TRACE_SCOPE("Controller::loadInBackground");
+            try {
+                Model model(std::make_unique<OBJLoader>());
+                model.loadModel(filePath);
+                auto triangles = std::make_shared<std::vector<Triangle>>(Transformer::transformTriangles(model.getTriangles()));
+                eventQueue.post(Event(EventType::ModelLoaded, LoadedModel{std::move(filePath), std::move(triangles)}));
+            } catch (const std::exception& e) {
+                eventQueue.post(Event(EventType::ModelLoadFailed, std::string(e.what())));
+            }
+        });
+    }
 
 public:
     Controller() {
         renderer = std::make_unique<WinAPIRenderer>();
-        model = std::make_unique<Model>(std::make_unique<OBJLoader>());
         renderer->setEventHandler(this);
+        renderer->setEventQueue(&eventQueue);
+        renderer->setFrameCallback([this](Renderer& target) {
+            if (modelMesh.isValid()) {
+                target.draw(modelMesh);
+            }
+        });
+    }
+
+    ~Controller() override {
+        // Задачи пишут в eventQueue, поэтому должны закончиться до разрушения контроллера
+        JobSystem::global().wait(loads);
     }
 
     bool initializeRenderer() {
@@ -28,19 +57,31 @@ public:
     }
 
     void handleEvent(const Event& event) override {
+        OBJVIEWER_TRACE_SCOPE("Controller::handleEvent");
         switch (event.type) {
             case EventType::FileOpen: {
-                const auto& filePath = std::get<std::string>(event.payload);
-                try {
-                    model->loadModel(filePath);
-                    auto workingTriangles = Transformer::transformTriangles(model->getTriangles());
-                    renderer->updateModel(workingTriangles);
-                } catch (const std::exception& e) {
-                    //MessageBox(nullptr, e.what(), L"Error", MB_ICONERROR | MB_OK);
+                loadInBackground(event.get<std::string>());
+                break;
+            }
+            case EventType::ModelLoaded: {
+                const auto& loaded = event.get<LoadedModel>();
+                if (loaded.triangles->empty()) {
+                    renderer->showError("Failed to load OBJ model");
+                    break;
                 }
+                // Рендер копирует геометрию к себе, треугольники события больше не нужны
+                renderer->destroyMesh(modelMesh);
+                modelMesh = renderer->createMesh(*loaded.triangles);
+                renderer->requestFrame();
+                break;
+            }
+            case EventType::ModelLoadFailed: {
+                renderer->showError("Failed to load OBJ model: " + event.get<std::string>());
                 break;
             }
             case EventType::WindowClose: {
+                // OBJVIEWER_TRACE=trace.json - выгрузить трассировку сеанса при закрытии
+                Trace::writeRequestedTrace();
                 break;
             }
             default:
@@ -3,14 +3,51 @@
 
 #include <variant>
 #include <string>
+#include <vector>
+#include <memory>
 #include "EventType.h"
+#include "Triangle.h"
 
+struct RotateDelta {
+    float x;
+    float y;
+};
+
+struct ZoomDelta {
+    float amount;
+};
+
+struct WindowSize {
+    int width;
+    int height;
+};
+
+// Результат фоновой загрузки: треугольники уже преобразованы Transformer
+struct LoadedModel {
+    std::string filePath;
+    std::shared_ptr<std::vector<Triangle>> triangles;
+};
+
+using EventPayload = std::variant<std::monostate, std::string, int, RotateDelta, ZoomDelta, WindowSize, LoadedModel>;
+
+// Событие только перемещается: строки и модели не копируются по пути от потока-источника к обработчику
 struct Event {
     EventType type; // Тип события
-    std::variant<std::string, int> payload;
+    EventPayload payload;
+
+    explicit Event(EventType type, EventPayload payload = {})
+            : type(type), payload(std::move(payload)) {}
+
+    Event(Event&&) noexcept = default;
+    Event& operator=(Event&&) noexcept = default;
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    template<typename T>
+    [[nodiscard]] const T& get() const { return std::get<T>(payload); }
 
-    explicit Event(EventType type, const std::variant<std::string, int>& payload = {})
-            : type(type), payload(payload) {}
+    template<typename T>
+    [[nodiscard]] T& get() { return std::get<T>(payload); }
 };
 
 #endif //OBJVIEWER__EVENT_H
@@ -0,0 +1,157 @@
+#ifndef OBJVIEWER__EVENTQUEUE_H
+#define OBJVIEWER__EVENTQUEUE_H
+
+#include <atomic>
+#include <optional>
+#include <functional>
+#include <cstddef>
+#include "Event.h"
+#include "IEventHandler.h"
+
+// Очередь событий между платформенным слоем и обработчиком.
+// Писать может любой поток (окно, потоки загрузки), читает только поток окна.
+// Запись без блокировок: узел добавляется одним atomic exchange (MPSC-очередь Вьюкова).
+class EventQueue {
+public:
+    struct Stats {
+        size_t posted = 0;
+        size_t dispatched = 0;
+        size_t coalesced = 0; // Поглощено соседними событиями того же типа
+    };
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<Event> event;
+    };
+
+    std::atomic<Node*> head; // Последний добавленный узел, общий для производителей
+    Node* tail;              // Фиктивный узел перед первым событием, только у потребителя
+
+    std::atomic<bool> wakePending{false};
+    std::function<void()> wakeup;
+
+    std::atomic<size_t> posted{0};
+    size_t dispatched = 0;
+    size_t coalesced = 0;
+
+    std::optional<Event> pop() {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            // Пусто, либо производитель ещё не связал узел - он разбудит потребителя ещё раз
+            return std::nullopt;
+        }
+        std::optional<Event> event = std::move(next->event);
+        next->event.reset();
+        delete tail;
+        tail = next;
+        return event;
+    }
+
+    static void merge(Event& target, const Event& source) {
+        switch (target.type) {
+            case EventType::Rotate: {
+                auto& delta = target.get<RotateDelta>();
+                const auto& extra = source.get<RotateDelta>();
+                delta.x += extra.x;
+                delta.y += extra.y;
+                break;
+            }
+            case EventType::Zoom:
+                target.get<ZoomDelta>().amount += source.get<ZoomDelta>().amount;
+                break;
+            case EventType::Resize:
+                target.get<WindowSize>() = source.get<WindowSize>();
+                break;
+            default:
+                break;
+        }
+    }
+
+    static bool isCoalescable(EventType type) {
+        return type == EventType::Rotate || type == EventType::Zoom || type == EventType::Resize;
+    }
+
+public:
+    EventQueue() : head(new Node), tail(head.load()) {}
+
+    ~EventQueue() {
+        while (pop()) {
+        }
+        delete tail;
+    }
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    // Вызывается производителем, когда в пустую (с точки зрения потребителя) очередь попало событие.
+    // Задаётся до появления других потоков-производителей, например PostMessage в поток окна
+    void setWakeup(std::function<void()> callback) {
+        wakeup = std::move(callback);
+    }
+
+    void post(Event event) {
+        Node* node = new Node;
+        node->event.emplace(std::move(event));
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+        posted.fetch_add(1, std::memory_order_relaxed);
+
+        if (!wakePending.exchange(true, std::memory_order_acq_rel) && wakeup) {
+            wakeup();
+        }
+    }
+
+    // Отдаёт обработчику всё накопленное. Подряд идущие повороты, приближения и изменения
+    // размера сливаются в одно событие, поэтому на кадр приходится не больше одного обновления камеры.
+    // Повороты и приближение независимы, так что чередование Rotate/Zoom тоже сливается.
+    size_t dispatch(IEventHandler& handler) {
+        // Сброс - RMW, а не store: store и следующая за ним загрузка tail->next могут переставиться
+        // (x86 так делает), и тогда производитель увидит ещё true и не разбудит, а потребитель
+        // не увидит его узел. Обмен упорядочен с exchange в post: либо потребитель видит узел,
+        // либо производитель видит false и будит
+        wakePending.exchange(false, std::memory_order_acq_rel);
+
+        std::optional<Event> rotate;
+        std::optional<Event> zoom;
+        std::optional<Event> resize;
+        size_t count = 0;
+
+        auto flush = [&] {
+            for (auto* pending : {&resize, &rotate, &zoom}) {
+                if (*pending) {
+                    handler.handleEvent(**pending);
+                    pending->reset();
+                    ++count;
+                }
+            }
+        };
+
+        while (auto event = pop()) {
+            if (!isCoalescable(event->type)) {
+                flush();
+                handler.handleEvent(*event);
+                ++count;
+                continue;
+            }
+
+            auto& pending = event->type == EventType::Rotate ? rotate : (event->type == EventType::Zoom ? zoom : resize);
+            if (pending) {
+                merge(*pending, *event);
+                ++coalesced;
+            } else {
+                pending.emplace(std::move(*event));
+            }
+        }
+        flush();
+
+        dispatched += count;
+        return count;
+    }
+
+    [[nodiscard]] Stats getStats() const {
+        return Stats{posted.load(std::memory_order_relaxed), dispatched, coalesced};
+    }
+};
+
+#endif //OBJVIEWER__EVENTQUEUE_H
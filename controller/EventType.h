@@ -4,6 +4,11 @@
 enum class EventType {
     FileOpen, // Событие открытия файла
     WindowClose, // Событие закрытия окна
+    Rotate, // Поворот камеры мышью, RotateDelta
+    Zoom, // Приближение колесом, ZoomDelta
+    Resize, // Новый размер клиентской области, WindowSize
+    ModelLoaded, // Модель загружена в фоне, LoadedModel
+    ModelLoadFailed, // Ошибка фоновой загрузки, текст ошибки
     CustomEvent // Пользовательское событие
 };
 
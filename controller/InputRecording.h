@@ -0,0 +1,174 @@
+#ifndef OBJVIEWER__INPUTRECORDING_H
+#define OBJVIEWER__INPUTRECORDING_H
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Запись ввода окна с отметками времени для воспроизведения без окна.
+// Пишутся и сырые события мыши (onMouseMove/onMouseWheel), и то, что после слияния в EventQueue
+// дошло до камеры (updateRotation/updateZoom), и границы кадров. Воспроизведение применяет только
+// камеру, размеры и кадры, поэтому кадр N повтора видит ровно ту камеру, что и кадр N записи
+struct InputSample {
+    enum class Kind {
+        MouseDown, // a, b - координаты
+        MouseUp,
+        MouseMove, // a, b - координаты
+        MouseWheel, // a - поворот колеса в единицах WHEEL_DELTA
+        Resize,     // a, b - ширина и высота клиентской области
+        Rotate,     // a, b - аргументы updateRotation
+        Zoom,       // a - аргумент updateZoom
+        Frame       // a - время кадра в записи, мс
+    };
+
+    double seconds = 0.0; // От начала записи
+    Kind kind = Kind::Frame;
+    float a = 0.0f;
+    float b = 0.0f;
+
+    static const char* kindName(Kind kind) {
+        static constexpr const char* names[] = {"down", "up", "move", "wheel", "resize", "rotate", "zoom", "frame"};
+        return names[static_cast<size_t>(kind)];
+    }
+};
+
+// Текстовый формат: строка-заголовок и по строке "секунды вид a b" на событие, чтобы записи
+// можно было читать и править руками
+class InputRecording {
+private:
+    static constexpr const char* Header = "objviewer-input 1";
+
+public:
+    std::vector<InputSample> samples;
+
+    void save(const std::string& filePath) const {
+        std::ofstream file(filePath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + filePath);
+        }
+        file.precision(9);
+        file << Header << '\n';
+        for (const auto& sample : samples) {
+            file << sample.seconds << ' ' << InputSample::kindName(sample.kind) << ' ' << sample.a << ' ' << sample.b << '\n';
+        }
+    }
+
+    static InputRecording load(const std::string& filePath) {
+        std::ifstream file(filePath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + filePath);
+        }
+        std::string line;
+        if (!std::getline(file, line) || line.rfind(Header, 0) != 0) {
+            throw std::runtime_error("Not an input recording: " + filePath);
+        }
+
+        InputRecording recording;
+        InputSample sample;
+        std::string kind;
+        while (file >> sample.seconds >> kind >> sample.a >> sample.b) {
+            bool known = false;
+            for (size_t i = 0; i <= static_cast<size_t>(InputSample::Kind::Frame); ++i) {
+                if (kind == InputSample::kindName(static_cast<InputSample::Kind>(i))) {
+                    sample.kind = static_cast<InputSample::Kind>(i);
+                    known = true;
+                }
+            }
+            if (!known) {
+                throw std::runtime_error("Unknown input event '" + kind + "' in " + filePath);
+            }
+            recording.samples.push_back(sample);
+        }
+        if (!file.eof()) {
+            throw std::runtime_error("Malformed input recording: " + filePath);
+        }
+        return recording;
+    }
+
+    [[nodiscard]] size_t count(InputSample::Kind kind) const {
+        size_t result = 0;
+        for (const auto& sample : samples) {
+            result += sample.kind == kind;
+        }
+        return result;
+    }
+};
+
+// Пишет из потока окна: все источники (оконная процедура, dispatch, render) работают в нём, блокировок нет
+class InputRecorder {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    InputRecording recording;
+    Clock::time_point start = Clock::now();
+
+public:
+    void record(InputSample::Kind kind, float a = 0.0f, float b = 0.0f) {
+        recording.samples.push_back({std::chrono::duration<double>(Clock::now() - start).count(), kind, a, b});
+    }
+
+    [[nodiscard]] const InputRecording& getRecording() const { return recording; }
+};
+
+// Проигрывает запись по кадрам на любом приёмнике с resize/updateRotation/updateZoom
+// (ModelRenderer обоих OpenGL-бэкендов, орбитальная камера программного рендера)
+class InputReplay {
+private:
+    const InputRecording& recording;
+    size_t position = 0;
+    size_t frames = 0;
+
+public:
+    struct Frame {
+        size_t index = 0;
+        double seconds = 0.0;            // Когда кадр был нарисован в записи
+        double recordedMilliseconds = 0.0;
+        size_t rawEvents = 0;            // Сырые события мыши с прошлого кадра
+    };
+
+    explicit InputReplay(const InputRecording& source) : recording(source) {}
+
+    // Применяет к target всё до следующей отметки кадра; false - кадров больше нет.
+    // Хвост записи после последнего кадра не применяется: его результат никто не видел
+    template<typename Target>
+    bool nextFrame(Target& target, Frame& frame) {
+        frame.rawEvents = 0;
+        for (size_t i = position; i < recording.samples.size(); ++i) {
+            if (recording.samples[i].kind == InputSample::Kind::Frame) {
+                for (; position < i; ++position) {
+                    const auto& sample = recording.samples[position];
+                    switch (sample.kind) {
+                        case InputSample::Kind::Resize:
+                            target.resize(static_cast<int>(sample.a), static_cast<int>(sample.b));
+                            break;
+                        case InputSample::Kind::Rotate:
+                            target.updateRotation(sample.a, sample.b);
+                            break;
+                        case InputSample::Kind::Zoom:
+                            target.updateZoom(sample.a);
+                            break;
+                        default:
+                            ++frame.rawEvents;
+                            break;
+                    }
+                }
+                const auto& marker = recording.samples[position++];
+                frame.index = frames++;
+                frame.seconds = marker.seconds;
+                frame.recordedMilliseconds = marker.a;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void rewind() {
+        position = 0;
+        frames = 0;
+    }
+};
+
+#endif //OBJVIEWER__INPUTRECORDING_H
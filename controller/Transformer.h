@@ -4,6 +4,7 @@
 #include <vector>
 #include "Triangle.h"
 #include "../model/loaders/ILoader.h"
+#include "../core/Trace.h"
 
 class Transformer {
 public:
@@ -11,6 +12,7 @@ public:
     static std::vector<Triangle> transformTriangles(
             const std::vector<ILoader::Triangle>& baseTriangles
     ) {
+        OBJVIEWER_TRACE_SCOPE("Transformer::transformTriangles");
         std::vector<Triangle> transformedTriangles;
 
         for (const auto& baseTriangle : baseTriangles) {
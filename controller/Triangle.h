@@ -3,6 +3,7 @@
 
 #include <array>
 #include "../model/math/Vector3D.h"
+#include "../model/math/Matrix4x4.h"
 
 class Triangle {
 public:
@@ -51,6 +52,47 @@ public:
         vertices[2].y += centerY;
     }
 
+    // Преобразование вершин матрицей с перспективным делением (вид-проекция камеры)
+    void applyMatrix(const VecMath::Matrix4x4<float>& matrix) {
+        for (auto& vertex : vertices) {
+            float x = matrix.m00 * vertex.x + matrix.m01 * vertex.y + matrix.m02 * vertex.z + matrix.m03;
+            float y = matrix.m10 * vertex.x + matrix.m11 * vertex.y + matrix.m12 * vertex.z + matrix.m13;
+            float z = matrix.m20 * vertex.x + matrix.m21 * vertex.y + matrix.m22 * vertex.z + matrix.m23;
+            float w = matrix.m30 * vertex.x + matrix.m31 * vertex.y + matrix.m32 * vertex.z + matrix.m33;
+            float invW = w != 0.0f ? 1.0f / w : 1.0f;
+            vertex = Vertex{x * invW, y * invW, z * invW};
+        }
+    }
+
+    // Преобразование модели: вершины и нормали (нормали - обратной транспонированной
+    // матрицей, поэтому неравномерный масштаб их не искажает)
+    void applyTransform(const VecMath::Matrix4x4<float>& matrix) {
+        applyTransform(matrix, matrix.inverseTranspose());
+    }
+
+    // normalMatrix - matrix.inverseTranspose(), посчитанная один раз для всего меша
+    void applyTransform(const VecMath::Matrix4x4<float>& matrix, const VecMath::Matrix4x4<float>& normalMatrix) {
+        for (auto& vertex : vertices) {
+            vertex = Vertex{
+                    matrix.m00 * vertex.x + matrix.m01 * vertex.y + matrix.m02 * vertex.z + matrix.m03,
+                    matrix.m10 * vertex.x + matrix.m11 * vertex.y + matrix.m12 * vertex.z + matrix.m13,
+                    matrix.m20 * vertex.x + matrix.m21 * vertex.y + matrix.m22 * vertex.z + matrix.m23
+            };
+        }
+        // Нормали - матрицей нормалей, иначе неравномерный масштаб их искривляет
+        const VecMath::Matrix4x4<float>& n = normalMatrix;
+        for (auto& normal : normals) {
+            normal = VecMath::Vector3D<float>(
+                    n.m00 * normal.x + n.m01 * normal.y + n.m02 * normal.z,
+                    n.m10 * normal.x + n.m11 * normal.y + n.m12 * normal.z,
+                    n.m20 * normal.x + n.m21 * normal.y + n.m22 * normal.z
+            );
+            normal.normalize();
+        }
+        averageNormal = (normals[0] + normals[1] + normals[2]) / 3.0f;
+        averageNormal.normalize();
+    }
+
     // Масштабирование вершин
     void scale(float scaleFactor) {
         vertices[0].x *= scaleFactor;
@@ -0,0 +1,521 @@
+#ifndef OBJVIEWER_ASYNCFILEREADER_H
+#define OBJVIEWER_ASYNCFILEREADER_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "Trace.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define OBJVIEWER_HAS_IO_URING 1
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
+
+// Последовательное чтение файла большими выровненными блоками с опережением.
+// Пока потребитель (парсер) разбирает один блок, следующие уже читаются в кольцо буферов:
+// на Linux через io_uring, иначе отдельным потоком. Размер кольца ограничивает память.
+class AsyncFileReader {
+public:
+    enum class Backend {
+        IoUring,
+        Thread
+    };
+
+    struct Options {
+        size_t blockSize = 1 << 20;
+        size_t queueDepth = 4;
+        bool allowIoUring = true;
+    };
+
+    struct Stats {
+        Backend backend = Backend::Thread;
+        uint64_t bytesRead = 0;
+        size_t blocks = 0;
+        double waitSeconds = 0.0; // Сколько потребитель простоял в ожидании данных
+    };
+
+    static const char* backendName(Backend backend) {
+        return backend == Backend::IoUring ? "io_uring" : "thread";
+    }
+
+private:
+    static constexpr size_t Alignment = 4096;
+
+    struct Slot {
+        char* data = nullptr;
+        size_t size = 0;
+        uint64_t offset = 0;
+        bool filled = false;
+    };
+
+    Options options;
+    std::vector<Slot> slots;
+    size_t nextSlot = 0;       // Слот, который отдаётся следующим
+    bool holdingSlot = false;  // Предыдущий слот ещё у потребителя
+    bool finished = false;
+    Stats stats;
+
+    // Фоновый поток
+    std::FILE* file = nullptr;
+    std::thread readerThread;
+    std::mutex mutex;
+    std::condition_variable slotFilled;
+    std::condition_variable slotFreed;
+    bool stopping = false;
+    bool endOfFile = false;
+    std::exception_ptr readerError;
+
+#ifdef OBJVIEWER_HAS_IO_URING
+    // Минимальная обёртка над системными вызовами io_uring без liburing
+    struct Ring {
+        int fd = -1;
+        void* sqMemory = MAP_FAILED;
+        size_t sqMemorySize = 0;
+        void* cqMemory = MAP_FAILED;
+        size_t cqMemorySize = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t sqesSize = 0;
+        unsigned* sqTail = nullptr;
+        unsigned* sqMask = nullptr;
+        unsigned* sqArray = nullptr;
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned* cqMask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+
+        bool open(unsigned entries) {
+            io_uring_params params{};
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd < 0) {
+                return false;
+            }
+            // IORING_OP_READ появился вместе с этим флагом (ядро 5.6)
+            if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+                close();
+                return false;
+            }
+
+            sqMemorySize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqMemorySize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) {
+                sqMemorySize = cqMemorySize = std::max(sqMemorySize, cqMemorySize);
+            }
+
+            sqMemory = mmap(nullptr, sqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            cqMemory = single ? sqMemory
+                              : mmap(nullptr, cqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+            if (sqMemory == MAP_FAILED || cqMemory == MAP_FAILED || sqes == MAP_FAILED) {
+                close();
+                return false;
+            }
+
+            auto* sq = static_cast<char*>(sqMemory);
+            auto* cq = static_cast<char*>(cqMemory);
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        void close() {
+            if (sqes != MAP_FAILED) {
+                munmap(sqes, sqesSize);
+                sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+            }
+            if (cqMemory != MAP_FAILED && cqMemory != sqMemory) {
+                munmap(cqMemory, cqMemorySize);
+            }
+            cqMemory = MAP_FAILED;
+            if (sqMemory != MAP_FAILED) {
+                munmap(sqMemory, sqMemorySize);
+                sqMemory = MAP_FAILED;
+            }
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        void submitRead(int fileFd, char* buffer, unsigned size, uint64_t offset, uint64_t userData) {
+            unsigned tail = *sqTail;
+            unsigned index = tail & *sqMask;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = fileFd;
+            sqe.addr = reinterpret_cast<uint64_t>(buffer);
+            sqe.len = size;
+            sqe.off = offset;
+            sqe.user_data = userData;
+            sqArray[index] = index;
+            std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+
+            while (syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0) < 0) {
+                if (errno != EINTR && errno != EAGAIN) {
+                    throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+                }
+            }
+        }
+
+        bool popCompletion(uint64_t& userData, int& result) {
+            unsigned head = *cqHead;
+            if (head == std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire)) {
+                return false;
+            }
+            const io_uring_cqe& cqe = cqes[head & *cqMask];
+            userData = cqe.user_data;
+            result = cqe.res;
+            std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        void waitCompletion() {
+            if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+        }
+    };
+
+    Ring ring;
+    int fileFd = -1;
+    uint64_t fileSize = 0;
+    uint64_t submitOffset = 0;  // Смещение следующего запроса на чтение
+    size_t submitSlot = 0;      // Слот для следующего запроса
+    size_t inFlight = 0;
+
+    bool openIoUring(const std::string& filePath) {
+        fileFd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileFd < 0) {
+            return false;
+        }
+        struct stat info{};
+        if (fstat(fileFd, &info) != 0 || !S_ISREG(info.st_mode) ||
+            !ring.open(static_cast<unsigned>(options.queueDepth))) {
+            ::close(fileFd);
+            fileFd = -1;
+            return false;
+        }
+        fileSize = static_cast<uint64_t>(info.st_size);
+        posix_fadvise(fileFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        while (inFlight < slots.size() && submitOffset < fileSize) {
+            submitNext();
+        }
+        return true;
+    }
+
+    void submitNext() {
+        Slot& slot = slots[submitSlot];
+        slot.filled = false;
+        slot.offset = submitOffset;
+        slot.size = static_cast<size_t>(std::min<uint64_t>(options.blockSize, fileSize - submitOffset));
+        ring.submitRead(fileFd, slot.data, static_cast<unsigned>(slot.size), submitOffset, submitSlot);
+        submitOffset += slot.size;
+        submitSlot = (submitSlot + 1) % slots.size();
+        ++inFlight;
+    }
+
+    void reapCompletions(bool wait) {
+        uint64_t userData = 0;
+        int result = 0;
+        while (true) {
+            if (!ring.popCompletion(userData, result)) {
+                if (!wait) {
+                    return;
+                }
+                ring.waitCompletion();
+                continue;
+            }
+            --inFlight;
+            if (result < 0) {
+                throw std::runtime_error(std::string("Asynchronous read failed: ") + std::strerror(-result));
+            }
+
+            Slot& slot = slots[userData];
+            // Короткое чтение у обычного файла бывает только в конце; остаток дочитываем синхронно
+            size_t done = static_cast<size_t>(result);
+            while (done < slot.size) {
+                ssize_t count = pread(fileFd, slot.data + done, slot.size - done, static_cast<off_t>(slot.offset + done));
+                if (count <= 0) {
+                    slot.size = done;
+                    break;
+                }
+                done += static_cast<size_t>(count);
+            }
+            slot.filled = true;
+            if (userData == nextSlot) {
+                return;
+            }
+        }
+    }
+#endif
+
+    void readerLoop() {
+        try {
+            for (size_t index = 0;; index = (index + 1) % slots.size()) {
+                Slot& slot = slots[index];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    slotFreed.wait(lock, [&] { return !slot.filled || stopping; });
+                    if (stopping) {
+                        return;
+                    }
+                }
+
+                size_t size;
+                {
+                    OBJVIEWER_TRACE_SCOPE("AsyncFileReader::read");
+                    size = std::fread(slot.data, 1, options.blockSize, file);
+                }
+                if (size < options.blockSize && std::ferror(file)) {
+                    throw std::runtime_error("Failed to read file");
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.size = size;
+                slot.filled = true;
+                if (size < options.blockSize) {
+                    endOfFile = true;
+                }
+                slotFilled.notify_one();
+                if (endOfFile) {
+                    return;
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            readerError = std::current_exception();
+            endOfFile = true;
+            slotFilled.notify_one();
+        }
+    }
+
+    bool openThread(const std::string& filePath) {
+        file = std::fopen(filePath.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        std::setvbuf(file, nullptr, _IONBF, 0); // Блоки и так крупные, промежуточный буфер stdio не нужен
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        stats.backend = Backend::Thread;
+        readerThread = std::thread(&AsyncFileReader::readerLoop, this);
+        return true;
+    }
+
+    void releaseHeldSlot() {
+        if (!holdingSlot) {
+            return;
+        }
+        holdingSlot = false;
+        size_t released = (nextSlot + slots.size() - 1) % slots.size();
+
+#ifdef OBJVIEWER_HAS_IO_URING
+        if (stats.backend == Backend::IoUring) {
+            slots[released].filled = false;
+            if (submitOffset < fileSize) {
+                submitNext();
+            }
+            return;
+        }
+#endif
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[released].filled = false;
+        slotFreed.notify_one();
+    }
+
+public:
+    explicit AsyncFileReader(const std::string& filePath) : AsyncFileReader(filePath, Options{}) {}
+
+    AsyncFileReader(const std::string& filePath, Options readerOptions) : options(readerOptions) {
+        options.blockSize = std::max<size_t>(Alignment, (options.blockSize + Alignment - 1) / Alignment * Alignment);
+        options.queueDepth = std::max<size_t>(2, options.queueDepth);
+
+        slots.resize(options.queueDepth);
+        for (auto& slot : slots) {
+            slot.data = static_cast<char*>(::operator new(options.blockSize, std::align_val_t{Alignment}));
+        }
+
+#ifdef OBJVIEWER_HAS_IO_URING
+        if (options.allowIoUring && openIoUring(filePath)) {
+            stats.backend = Backend::IoUring;
+            return;
+        }
+#endif
+        if (!openThread(filePath)) {
+            freeSlots();
+            throw std::runtime_error("Failed to open file: " + filePath);
+        }
+    }
+
+    ~AsyncFileReader() {
+        if (readerThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            slotFreed.notify_all();
+            readerThread.join();
+        }
+        if (file) {
+            std::fclose(file);
+        }
+#ifdef OBJVIEWER_HAS_IO_URING
+        // Незавершённые запросы пишут в наши буферы - дожидаемся их до освобождения памяти
+        try {
+            while (inFlight > 0) {
+                uint64_t userData = 0;
+                int result = 0;
+                if (ring.popCompletion(userData, result)) {
+                    --inFlight;
+                } else {
+                    ring.waitCompletion();
+                }
+            }
+        } catch (...) {
+        }
+        ring.close();
+        if (fileFd >= 0) {
+            ::close(fileFd);
+        }
+#endif
+        freeSlots();
+    }
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    // Следующий блок файла; пустой - конец файла. Данные действительны до следующего вызова
+    std::string_view next() {
+        OBJVIEWER_TRACE_SCOPE("AsyncFileReader::next");
+        releaseHeldSlot();
+        if (finished) {
+            return {};
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Slot& slot = slots[nextSlot];
+
+#ifdef OBJVIEWER_HAS_IO_URING
+        if (stats.backend == Backend::IoUring) {
+            if (!slot.filled) {
+                if (inFlight == 0) {
+                    finished = true;
+                    return {};
+                }
+                reapCompletions(true);
+            }
+        } else
+#endif
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotFilled.wait(lock, [&] { return slot.filled || endOfFile; });
+            if (!slot.filled) {
+                finished = true;
+                if (readerError) {
+                    std::rethrow_exception(readerError);
+                }
+                return {};
+            }
+        }
+        stats.waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (slot.size == 0) {
+            finished = true;
+            return {};
+        }
+
+        holdingSlot = true;
+        nextSlot = (nextSlot + 1) % slots.size();
+        stats.bytesRead += slot.size;
+        ++stats.blocks;
+        return {slot.data, slot.size};
+    }
+
+    [[nodiscard]] const Stats& getStats() const { return stats; }
+
+private:
+    void freeSlots() {
+        for (auto& slot : slots) {
+            ::operator delete(slot.data, std::align_val_t{Alignment});
+            slot.data = nullptr;
+        }
+    }
+};
+
+// std::istream поверх AsyncFileReader: существующие парсеры с std::getline
+// получают чтение с опережением без изменений. Как и std::ifstream, не бросает
+// исключений при открытии - проверяйте is_open(). Ошибка чтения, наоборот, бросается
+// из парсера (exceptions(badbit)), иначе цикл getline принял бы её за конец файла
+// и модель молча оказалась бы обрезанной
+class AsyncFileStream : public std::istream {
+private:
+    class Buffer : public std::streambuf {
+    public:
+        std::unique_ptr<AsyncFileReader> reader;
+
+    protected:
+        int_type underflow() override {
+            if (!reader) {
+                return traits_type::eof();
+            }
+            std::string_view block = reader->next();
+            if (block.empty()) {
+                return traits_type::eof();
+            }
+            char* begin = const_cast<char*>(block.data());
+            setg(begin, begin, begin + block.size());
+            return traits_type::to_int_type(*gptr());
+        }
+    };
+
+    Buffer buffer;
+
+public:
+    explicit AsyncFileStream(const std::string& filePath, AsyncFileReader::Options options = {}) : std::istream(nullptr) {
+        rdbuf(&buffer);
+        exceptions(std::ios::badbit);
+        try {
+            buffer.reader = std::make_unique<AsyncFileReader>(filePath, options);
+        } catch (const std::exception&) {
+            setstate(std::ios::failbit);
+        }
+    }
+
+    [[nodiscard]] bool is_open() const { return buffer.reader != nullptr; }
+
+    [[nodiscard]] const AsyncFileReader* getReader() const { return buffer.reader.get(); }
+};
+
+#endif //OBJVIEWER_ASYNCFILEREADER_H
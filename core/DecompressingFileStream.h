@@ -0,0 +1,375 @@
+#ifndef OBJVIEWER_DECOMPRESSINGFILESTREAM_H
+#define OBJVIEWER_DECOMPRESSINGFILESTREAM_H
+
+#include <condition_variable>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsyncFileReader.h"
+
+#ifdef OBJVIEWER_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef OBJVIEWER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+// Чтение сжатого файла (.gz, .zst) как обычного std::istream без временного файла.
+// Распаковка идёт в отдельном потоке в кольцо фрагментов, парсер в вызывающем потоке
+// разбирает уже распакованные фрагменты. С диска читается в разы меньше данных.
+// Поддержка форматов включается при сборке: OBJVIEWER_WITH_ZLIB, OBJVIEWER_WITH_ZSTD
+class DecompressingFileStream : public std::istream {
+public:
+    enum class Format {
+        None,
+        Gzip,
+        Zstd
+    };
+
+    struct Options {
+        size_t chunkSize = 256 * 1024; // Размер распакованного фрагмента
+        size_t queueDepth = 4;         // Сколько фрагментов распаковщик может опережать парсер
+        AsyncFileReader::Options input;
+    };
+
+    // Формат по расширению: model.obj.gz -> Gzip
+    static Format detectFormat(const std::string& filePath) {
+        if (endsWith(filePath, ".gz")) {
+            return Format::Gzip;
+        }
+        if (endsWith(filePath, ".zst")) {
+            return Format::Zstd;
+        }
+        return Format::None;
+    }
+
+    // model.obj.gz -> model.obj, чтобы загрузчик выбирался по внутреннему расширению
+    static std::string stripCompressionSuffix(const std::string& filePath) {
+        switch (detectFormat(filePath)) {
+            case Format::Gzip:
+                return filePath.substr(0, filePath.size() - 3);
+            case Format::Zstd:
+                return filePath.substr(0, filePath.size() - 4);
+            default:
+                return filePath;
+        }
+    }
+
+    static bool isSupported(Format format) {
+        switch (format) {
+            case Format::None:
+                return true;
+#ifdef OBJVIEWER_WITH_ZLIB
+            case Format::Gzip:
+                return true;
+#endif
+#ifdef OBJVIEWER_WITH_ZSTD
+            case Format::Zstd:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    static const char* formatName(Format format) {
+        switch (format) {
+            case Format::Gzip:
+                return "gzip";
+            case Format::Zstd:
+                return "zstd";
+            default:
+                return "none";
+        }
+    }
+
+private:
+    static bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() > suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Выдаёт распакованные байты порциями; 0 - поток закончился
+    class Decoder {
+    public:
+        virtual ~Decoder() = default;
+        virtual size_t decode(char* output, size_t capacity) = 0;
+    };
+
+#ifdef OBJVIEWER_WITH_ZLIB
+    class GzipDecoder : public Decoder {
+    private:
+        AsyncFileReader& reader;
+        z_stream stream{};
+        bool inputFinished = false;
+        bool memberOpen = false;
+
+        bool refill() {
+            std::string_view block = reader.next();
+            if (block.empty()) {
+                inputFinished = true;
+                return false;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block.data()));
+            stream.avail_in = static_cast<uInt>(block.size());
+            return true;
+        }
+
+    public:
+        explicit GzipDecoder(AsyncFileReader& input) : reader(input) {
+            // 15 + 32: окно 32 КиБ, автоопределение заголовка gzip/zlib
+            if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+                throw std::runtime_error("Failed to initialize gzip decoder");
+            }
+        }
+
+        ~GzipDecoder() override {
+            inflateEnd(&stream);
+        }
+
+        size_t decode(char* output, size_t capacity) override {
+            stream.next_out = reinterpret_cast<Bytef*>(output);
+            stream.avail_out = static_cast<uInt>(capacity);
+
+            while (stream.avail_out > 0) {
+                if (stream.avail_in == 0 && (inputFinished || !refill())) {
+                    if (memberOpen) {
+                        throw std::runtime_error("Truncated gzip stream");
+                    }
+                    break;
+                }
+
+                memberOpen = true;
+                int result = inflate(&stream, Z_NO_FLUSH);
+                if (result == Z_STREAM_END) {
+                    // Файл может состоять из нескольких склеенных gzip-членов
+                    memberOpen = false;
+                    if (stream.avail_in == 0 && !refill()) {
+                        break;
+                    }
+                    inflateReset(&stream);
+                } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                    throw std::runtime_error(std::string("Corrupt gzip stream: ") + (stream.msg ? stream.msg : "unknown error"));
+                }
+            }
+            return capacity - stream.avail_out;
+        }
+    };
+#endif
+
+#ifdef OBJVIEWER_WITH_ZSTD
+    class ZstdDecoder : public Decoder {
+    private:
+        AsyncFileReader& reader;
+        ZSTD_DStream* stream = nullptr;
+        ZSTD_inBuffer input{nullptr, 0, 0};
+        bool inputFinished = false;
+        bool frameOpen = false;
+
+    public:
+        explicit ZstdDecoder(AsyncFileReader& source) : reader(source), stream(ZSTD_createDStream()) {
+            if (!stream) {
+                throw std::runtime_error("Failed to initialize zstd decoder");
+            }
+        }
+
+        ~ZstdDecoder() override {
+            ZSTD_freeDStream(stream);
+        }
+
+        size_t decode(char* output, size_t capacity) override {
+            ZSTD_outBuffer out{output, capacity, 0};
+            while (out.pos < out.size) {
+                if (input.pos == input.size) {
+                    std::string_view block = inputFinished ? std::string_view() : reader.next();
+                    if (block.empty()) {
+                        inputFinished = true;
+                        if (frameOpen) {
+                            // Декодер мог придержать часть кадра во внутреннем буфере
+                            size_t before = out.pos;
+                            size_t result = ZSTD_decompressStream(stream, &out, &input);
+                            if (ZSTD_isError(result)) {
+                                throw std::runtime_error(std::string("Corrupt zstd stream: ") + ZSTD_getErrorName(result));
+                            }
+                            frameOpen = result != 0;
+                            if (out.pos == before && frameOpen) {
+                                throw std::runtime_error("Truncated zstd stream");
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    input = {block.data(), block.size(), 0};
+                }
+
+                // Возвращает 0 на границе кадра; следующие кадры декодируются тем же вызовом
+                size_t result = ZSTD_decompressStream(stream, &out, &input);
+                if (ZSTD_isError(result)) {
+                    throw std::runtime_error(std::string("Corrupt zstd stream: ") + ZSTD_getErrorName(result));
+                }
+                frameOpen = result != 0;
+            }
+            return out.pos;
+        }
+    };
+#endif
+
+    struct Chunk {
+        std::vector<char> data;
+        size_t size = 0;
+        bool filled = false;
+    };
+
+    class Buffer : public std::streambuf {
+    public:
+        Options options;
+        std::unique_ptr<AsyncFileReader> reader;
+        std::unique_ptr<Decoder> decoder;
+        std::vector<Chunk> chunks;
+        size_t nextChunk = 0;
+        bool holdingChunk = false;
+
+        std::thread decoderThread;
+        std::mutex mutex;
+        std::condition_variable chunkFilled;
+        std::condition_variable chunkFreed;
+        bool stopping = false;
+        bool finished = false;
+        std::exception_ptr error;
+
+        ~Buffer() override {
+            if (decoderThread.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                chunkFreed.notify_all();
+                decoderThread.join();
+            }
+        }
+
+        void start() {
+            chunks.resize(std::max<size_t>(2, options.queueDepth));
+            for (auto& chunk : chunks) {
+                chunk.data.resize(options.chunkSize);
+            }
+            decoderThread = std::thread(&Buffer::decodeLoop, this);
+        }
+
+        void decodeLoop() {
+            try {
+                for (size_t index = 0;; index = (index + 1) % chunks.size()) {
+                    Chunk& chunk = chunks[index];
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        chunkFreed.wait(lock, [&] { return !chunk.filled || stopping; });
+                        if (stopping) {
+                            return;
+                        }
+                    }
+
+                    size_t size;
+                    {
+                        OBJVIEWER_TRACE_SCOPE("DecompressingFileStream::decode");
+                        size = decoder->decode(chunk.data.data(), chunk.data.size());
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (size == 0) {
+                        finished = true;
+                        chunkFilled.notify_one();
+                        return;
+                    }
+                    chunk.size = size;
+                    chunk.filled = true;
+                    chunkFilled.notify_one();
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+                finished = true;
+                chunkFilled.notify_one();
+            }
+        }
+
+    protected:
+        int_type underflow() override {
+            OBJVIEWER_TRACE_SCOPE("DecompressingFileStream::underflow");
+            if (!decoder) {
+                return traits_type::eof();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            if (holdingChunk) {
+                holdingChunk = false;
+                chunks[(nextChunk + chunks.size() - 1) % chunks.size()].filled = false;
+                chunkFreed.notify_one();
+            }
+
+            Chunk& chunk = chunks[nextChunk];
+            chunkFilled.wait(lock, [&] { return chunk.filled || finished; });
+            if (!chunk.filled) {
+                if (error) {
+                    // Поток выставлен на exceptions(badbit), поэтому ошибка дойдёт до парсера как есть
+                    std::rethrow_exception(error);
+                }
+                return traits_type::eof();
+            }
+
+            holdingChunk = true;
+            nextChunk = (nextChunk + 1) % chunks.size();
+            setg(chunk.data.data(), chunk.data.data(), chunk.data.data() + chunk.size);
+            return traits_type::to_int_type(*gptr());
+        }
+    };
+
+    Buffer buffer;
+
+public:
+    // Как и std::ifstream, не бросает при отсутствии файла - проверяйте is_open().
+    // Неподдерживаемый формат и ошибки распаковки - std::runtime_error
+    explicit DecompressingFileStream(const std::string& filePath) : DecompressingFileStream(filePath, Options{}) {}
+
+    DecompressingFileStream(const std::string& filePath, Options options) : std::istream(nullptr) {
+        rdbuf(&buffer);
+        exceptions(std::ios::badbit);
+        buffer.options = options;
+
+        Format format = detectFormat(filePath);
+        if (!isSupported(format)) {
+            throw std::runtime_error(std::string(formatName(format)) + " support is not compiled in: " + filePath);
+        }
+
+        try {
+            buffer.reader = std::make_unique<AsyncFileReader>(filePath, options.input);
+        } catch (const std::exception&) {
+            setstate(std::ios::failbit);
+            return;
+        }
+
+        switch (format) {
+#ifdef OBJVIEWER_WITH_ZLIB
+            case Format::Gzip:
+                buffer.decoder = std::make_unique<GzipDecoder>(*buffer.reader);
+                break;
+#endif
+#ifdef OBJVIEWER_WITH_ZSTD
+            case Format::Zstd:
+                buffer.decoder = std::make_unique<ZstdDecoder>(*buffer.reader);
+                break;
+#endif
+            default:
+                throw std::runtime_error("Not a compressed file: " + filePath);
+        }
+        buffer.start();
+    }
+
+    [[nodiscard]] bool is_open() const { return buffer.decoder != nullptr; }
+};
+
+#endif //OBJVIEWER_DECOMPRESSINGFILESTREAM_H
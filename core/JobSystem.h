@@ -0,0 +1,412 @@
+#ifndef OBJVIEWER_JOBSYSTEM_H
+#define OBJVIEWER_JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Общий для всего проекта планировщик задач с перехватом работы (work stealing).
+// У каждого рабочего потока своя очередь: свои задачи он берёт с конца (LIFO, горячий кэш),
+// чужие забирает с начала (FIFO, самые крупные куски). Поток, ждущий группу задач,
+// сам выполняет задачи, поэтому вложенные parallelFor не блокируют пул.
+class JobSystem {
+public:
+    // Набор задач, окончания которых можно дождаться. Первое исключение из задач
+    // пробрасывается из wait()
+    class TaskGroup {
+    private:
+        friend class JobSystem;
+        std::atomic<size_t> pending{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        // Переход pending 1 -> 0 делается под waitMutex: ждущий, увидев 0 под этим мьютексом,
+        // знает, что последняя задача уже не обращается к группе, и может её уничтожить
+        std::mutex waitMutex;
+        std::condition_variable finished;
+
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+    };
+
+    // Граф задач: задача запускается, когда завершены все её зависимости
+    class TaskGraph {
+    public:
+        using TaskId = size_t;
+
+    private:
+        friend class JobSystem;
+        struct Node {
+            std::function<void()> work;
+            std::vector<TaskId> dependents;
+            size_t dependencyCount = 0;
+            std::atomic<size_t> remaining{0};
+        };
+        std::deque<Node> nodes;
+
+    public:
+        TaskId add(std::function<void()> work, std::initializer_list<TaskId> dependencies = {}) {
+            return add(std::move(work), std::vector<TaskId>(dependencies));
+        }
+
+        TaskId add(std::function<void()> work, const std::vector<TaskId>& dependencies) {
+            TaskId id = nodes.size();
+            nodes.emplace_back();
+            nodes.back().work = std::move(work);
+            for (TaskId dependency : dependencies) {
+                nodes[dependency].dependents.push_back(id);
+                ++nodes.back().dependencyCount;
+            }
+            return id;
+        }
+
+        [[nodiscard]] size_t size() const { return nodes.size(); }
+    };
+
+    struct Stats {
+        size_t executed = 0;
+        size_t stolen = 0;
+    };
+
+private:
+    struct Job {
+        std::function<void()> work;
+        TaskGroup* group = nullptr;
+    };
+
+    // Попыток найти задачу перед тем, как ждущий поток уснёт на группе
+    static constexpr int WaitSpins = 64;
+    // Уснувший в wait() поток раз в этот интервал снова ищет чужие задачи
+    static constexpr std::chrono::milliseconds WaitRecheck{1};
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::atomic<size_t> executed{0};
+        std::atomic<size_t> stolen{0};
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queuedJobs{0};
+    std::atomic<size_t> sleepingWorkers{0};
+    std::atomic<size_t> nextExternalQueue{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+
+    struct WorkerIdentity {
+        const JobSystem* owner = nullptr;
+        int index = -1;
+    };
+
+    static WorkerIdentity& identity() {
+        thread_local WorkerIdentity current;
+        return current;
+    }
+
+    // Номер рабочего потока этого планировщика, либо -1 для внешних потоков
+    [[nodiscard]] int currentWorker() const {
+        const auto& current = identity();
+        return current.owner == this ? current.index : -1;
+    }
+
+    void push(Job job) {
+        int self = currentWorker();
+        size_t target = self >= 0 ? static_cast<size_t>(self)
+                                  : nextExternalQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->jobs.push_back(std::move(job));
+        }
+        queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+
+        if (sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wakeCondition.notify_one();
+        }
+    }
+
+    bool tryPop(size_t index, Job& job) {
+        auto& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return false;
+        }
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    bool trySteal(size_t index, Job& job) {
+        auto& queue = *queues[index];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.jobs.empty()) {
+            return false;
+        }
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    bool tryRunOne() {
+        if (queuedJobs.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        int self = currentWorker();
+        size_t count = queues.size();
+        size_t start = self >= 0 ? static_cast<size_t>(self) : nextExternalQueue.load(std::memory_order_relaxed) % count;
+
+        Job job;
+        bool found = self >= 0 && tryPop(start, job);
+        bool stolen = false;
+        for (size_t attempt = 0; !found && attempt < 2; ++attempt) {
+            for (size_t offset = self >= 0 ? 1 : 0; offset < count && !found; ++offset) {
+                // Вторая попытка блокирующая: try_lock мог промахнуться на занятой очереди
+                size_t victim = (start + offset) % count;
+                found = attempt == 0 ? trySteal(victim, job) : tryPop(victim, job);
+            }
+            stolen = found;
+        }
+        if (!found) {
+            return false;
+        }
+
+        queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+        execute(job);
+
+        auto& stats = *queues[self >= 0 ? static_cast<size_t>(self) : 0];
+        stats.executed.fetch_add(1, std::memory_order_relaxed);
+        if (stolen && self >= 0) {
+            stats.stolen.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    static void execute(Job& job) {
+        try {
+            job.work();
+        } catch (...) {
+            if (job.group) {
+                std::lock_guard<std::mutex> lock(job.group->errorMutex);
+                if (!job.group->error) {
+                    job.group->error = std::current_exception();
+                }
+            }
+        }
+        if (job.group) {
+            finish(*job.group);
+        }
+    }
+
+    static void finish(TaskGroup& group) {
+        size_t pending = group.pending.load(std::memory_order_relaxed);
+        while (pending > 1 && !group.pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel)) {
+        }
+        if (pending > 1) {
+            return;
+        }
+        // Возможно, последняя задача группы: уменьшение и пробуждение под мьютексом ждущего
+        std::lock_guard<std::mutex> lock(group.waitMutex);
+        if (group.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            group.finished.notify_all();
+        }
+    }
+
+    void workerLoop(int index) {
+        identity() = WorkerIdentity{this, index};
+
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (tryRunOne()) {
+                continue;
+            }
+
+            sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                wakeCondition.wait(lock, [&] {
+                    return queuedJobs.load(std::memory_order_seq_cst) > 0 || stopping.load(std::memory_order_acquire);
+                });
+            }
+            sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    void scheduleGraphNode(TaskGraph& graph, TaskGraph::TaskId id, TaskGroup& group) {
+        run(group, [this, &graph, id, &group] {
+            auto& node = graph.nodes[id];
+            node.work();
+            for (auto dependent : node.dependents) {
+                if (graph.nodes[dependent].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    scheduleGraphNode(graph, dependent, group);
+                }
+            }
+        });
+    }
+
+public:
+    // threadCount = 0 - по числу аппаратных потоков. Ждущий поток тоже выполняет задачи,
+    // поэтому одного рабочего потока достаточно для корректной работы
+    explicit JobSystem(unsigned threadCount = 0) {
+        unsigned count = threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < count; ++i) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (unsigned i = 0; i < count; ++i) {
+            threads.emplace_back(&JobSystem::workerLoop, this, static_cast<int>(i));
+        }
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping.store(true, std::memory_order_release);
+        }
+        wakeCondition.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Общий экземпляр. Число потоков задаётся до первого обращения через configureGlobal
+    static JobSystem& global() {
+        static JobSystem instance(globalThreadCount());
+        return instance;
+    }
+
+    static void configureGlobal(unsigned threads) {
+        globalThreadCount() = threads;
+    }
+
+    [[nodiscard]] size_t getThreadCount() const { return threads.size(); }
+
+    [[nodiscard]] Stats getStats() const {
+        Stats stats;
+        for (const auto& queue : queues) {
+            stats.executed += queue->executed.load(std::memory_order_relaxed);
+            stats.stolen += queue->stolen.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    // co_await jobs.schedule() - продолжить корутину на рабочем потоке пула
+    auto schedule() {
+        struct Awaiter {
+            JobSystem& jobs;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { jobs.push(Job{[handle] { handle.resume(); }, nullptr}); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    void run(TaskGroup& group, std::function<void()> work) {
+        group.pending.fetch_add(1, std::memory_order_acq_rel);
+        push(Job{std::move(work), &group});
+    }
+
+    // Ждёт группу, выполняя задачи пула вместо простоя. Когда взять нечего, оставшиеся задачи
+    // группы уже выполняются другими потоками: после короткого ожидания поток засыпает до конца
+    // группы, просыпаясь раз в WaitRecheck, чтобы помочь с появившейся за это время работой
+    void wait(TaskGroup& group) {
+        int spins = 0;
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            if (tryRunOne()) {
+                spins = 0;
+            } else if (++spins < WaitSpins) {
+                std::this_thread::yield();
+            } else {
+                std::unique_lock<std::mutex> lock(group.waitMutex);
+                group.finished.wait_for(lock, WaitRecheck, [&] {
+                    return group.pending.load(std::memory_order_acquire) == 0;
+                });
+                spins = 0;
+            }
+        }
+        {
+            // Последняя задача могла обнулить pending и ещё не выйти из finish()
+            std::lock_guard<std::mutex> lock(group.waitMutex);
+        }
+
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(group.errorMutex);
+            std::swap(error, group.error);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // body(begin, end) для непересекающихся отрезков [begin, end), не короче grain (кроме последнего)
+    template<typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body&& body) {
+        if (begin >= end) {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+        size_t count = end - begin;
+        size_t maxChunks = getThreadCount() * 4;
+        size_t chunk = std::max(grain, (count + maxChunks - 1) / maxChunks);
+        if (chunk >= count) {
+            body(begin, end);
+            return;
+        }
+
+        TaskGroup group;
+        for (size_t first = begin + chunk; first < end; first += chunk) {
+            size_t last = std::min(end, first + chunk);
+            run(group, [&body, first, last] { body(first, last); });
+        }
+
+        // Первый отрезок выполняется на вызывающем потоке
+        try {
+            body(begin, std::min(end, begin + chunk));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(group.errorMutex);
+            if (!group.error) {
+                group.error = std::current_exception();
+            }
+        }
+        wait(group);
+    }
+
+    // Выполняет граф целиком и возвращает управление после последней задачи
+    void run(TaskGraph& graph) {
+        TaskGroup group;
+        for (auto& node : graph.nodes) {
+            node.remaining.store(node.dependencyCount, std::memory_order_relaxed);
+        }
+        for (TaskGraph::TaskId id = 0; id < graph.nodes.size(); ++id) {
+            if (graph.nodes[id].dependencyCount == 0) {
+                scheduleGraphNode(graph, id, group);
+            }
+        }
+        wait(group);
+    }
+
+private:
+    static unsigned& globalThreadCount() {
+        static unsigned count = 0;
+        return count;
+    }
+};
+
+#endif //OBJVIEWER_JOBSYSTEM_H
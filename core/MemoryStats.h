@@ -0,0 +1,160 @@
+#ifndef OBJVIEWER_MEMORYSTATS_H
+#define OBJVIEWER_MEMORYSTATS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+// Учёт памяти по подсистемам: текущие и пиковые байты на метку. Считаются ёмкости
+// буферов, которыми владеет подсистема, а не вызовы new, поэтому накладные расходы кучи
+// и временные структуры (таблица сварки вершин) сюда не попадают
+enum class MemoryTag : size_t {
+    ObjModel,       // Пулы OBJModel: вершины, нормали, текстурные координаты, грани
+    MeshAttributes, // Исходные массивы Mesh до сварки: позиции, нормали, UV, грани с индексами
+    MeshVertices,   // Сваренные вершины Mesh (float или PackedVertex), индексы и кластеры
+    RenderCopies,   // Копии геометрии в рендерах: подготовленные вершины, распакованные массивы для GL
+    GpuBuffers,     // Выделенные буферы и текстуры OpenGL (размер, а не заполненная часть)
+    Textures,       // Декодированные текстуры со всеми уровнями mip
+    Count
+};
+
+class MemoryStats {
+public:
+    struct Usage {
+        size_t current = 0;
+        size_t peak = 0;
+    };
+
+    using Snapshot = std::array<Usage, static_cast<size_t>(MemoryTag::Count)>;
+
+private:
+    struct Counter {
+        std::atomic<size_t> current{0};
+        std::atomic<size_t> peak{0};
+
+        void add(size_t bytes) {
+            const size_t now = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            size_t previous = peak.load(std::memory_order_relaxed);
+            while (now > previous && !peak.compare_exchange_weak(previous, now, std::memory_order_relaxed)) {
+            }
+        }
+
+        void subtract(size_t bytes) {
+            current.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] Usage load() const {
+            return Usage{current.load(std::memory_order_relaxed), peak.load(std::memory_order_relaxed)};
+        }
+    };
+
+    std::array<Counter, static_cast<size_t>(MemoryTag::Count)> counters;
+    Counter total; // Пик суммы, а не сумма пиков
+
+public:
+    static MemoryStats& global() {
+        static MemoryStats stats;
+        return stats;
+    }
+
+    static const char* tagName(MemoryTag tag) {
+        static constexpr const char* names[] = {"obj-model", "mesh-attributes", "mesh-vertices", "render-copies", "gpu-buffers", "textures"};
+        return tag < MemoryTag::Count ? names[static_cast<size_t>(tag)] : "unknown";
+    }
+
+    void add(MemoryTag tag, size_t bytes) {
+        counters[static_cast<size_t>(tag)].add(bytes);
+        total.add(bytes);
+    }
+
+    void subtract(MemoryTag tag, size_t bytes) {
+        counters[static_cast<size_t>(tag)].subtract(bytes);
+        total.subtract(bytes);
+    }
+
+    [[nodiscard]] Usage usage(MemoryTag tag) const { return counters[static_cast<size_t>(tag)].load(); }
+    [[nodiscard]] Usage totalUsage() const { return total.load(); }
+
+    [[nodiscard]] Snapshot snapshot() const {
+        Snapshot result;
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = counters[i].load();
+        }
+        return result;
+    }
+
+    // Пики становятся равны текущим значениям, например перед замером очередной загрузки
+    void resetPeaks() {
+        for (auto& counter : counters) {
+            counter.peak.store(counter.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        total.peak.store(total.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    void print(std::ostream& out) const {
+        constexpr double MiB = 1024.0 * 1024.0;
+        const auto all = totalUsage();
+        out << "memory MiB: total " << static_cast<double>(all.current) / MiB << " (peak " << static_cast<double>(all.peak) / MiB << ")";
+        for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); ++i) {
+            const auto tag = usage(static_cast<MemoryTag>(i));
+            out << ", " << tagName(static_cast<MemoryTag>(i)) << ' ' << static_cast<double>(tag.current) / MiB
+                << " (peak " << static_cast<double>(tag.peak) / MiB << ")";
+        }
+        out << '\n';
+    }
+};
+
+// Доля объекта в счётчике MemoryStats: владелец сообщает через set, сколько байт держит сейчас,
+// деструктор снимает их. Копия объекта держит копии буферов и учитывается заново, перемещение
+// передаёт байты. Метка задаётся при создании и при присваивании не меняется
+class MemoryAccount {
+private:
+    MemoryTag tag;
+    size_t bytes = 0;
+
+public:
+    explicit MemoryAccount(MemoryTag accountTag) : tag(accountTag) {}
+
+    MemoryAccount(const MemoryAccount& other) : tag(other.tag) {
+        set(other.bytes);
+    }
+
+    MemoryAccount(MemoryAccount&& other) noexcept : tag(other.tag), bytes(std::exchange(other.bytes, 0)) {}
+
+    MemoryAccount& operator=(const MemoryAccount& other) {
+        set(other.bytes);
+        return *this;
+    }
+
+    MemoryAccount& operator=(MemoryAccount&& other) noexcept {
+        if (this != &other) {
+            set(0);
+            bytes = std::exchange(other.bytes, 0);
+            if (tag != other.tag) {
+                MemoryStats::global().subtract(other.tag, bytes);
+                MemoryStats::global().add(tag, bytes);
+            }
+        }
+        return *this;
+    }
+
+    ~MemoryAccount() {
+        set(0);
+    }
+
+    void set(size_t newBytes) {
+        if (newBytes > bytes) {
+            MemoryStats::global().add(tag, newBytes - bytes);
+        } else if (newBytes < bytes) {
+            MemoryStats::global().subtract(tag, bytes - newBytes);
+        }
+        bytes = newBytes;
+    }
+
+    [[nodiscard]] size_t getBytes() const { return bytes; }
+    [[nodiscard]] MemoryTag getTag() const { return tag; }
+};
+
+#endif //OBJVIEWER_MEMORYSTATS_H
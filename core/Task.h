@@ -0,0 +1,249 @@
+#ifndef OBJVIEWER_TASK_H
+#define OBJVIEWER_TASK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "JobSystem.h"
+
+// Ленивая корутина: тело начинает выполняться при первом co_await на задаче.
+// По завершении управление сразу передаётся ожидающей корутине (symmetric transfer),
+// поэтому длинные цепочки co_await не растят стек.
+template<typename T = void>
+class Task;
+
+namespace TaskDetail {
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto next = handle.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    struct PromiseBase {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    template<typename T>
+    struct Promise : PromiseBase {
+        std::optional<T> value;
+
+        Task<T> get_return_object() noexcept;
+
+        template<typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+        T take() {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return std::move(*value);
+        }
+    };
+
+    template<>
+    struct Promise<void> : PromiseBase {
+        Task<void> get_return_object() noexcept;
+
+        void return_void() noexcept {}
+
+        void take() {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    // Корутина без владельца: стартует сразу и сама уничтожает кадр по завершении
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+}
+
+template<typename T>
+class Task {
+public:
+    using promise_type = TaskDetail::Promise<T>;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    explicit Task(std::coroutine_handle<promise_type> coroutine) noexcept : handle(coroutine) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().take(); }
+        };
+        return Awaiter{handle};
+    }
+};
+
+namespace TaskDetail {
+    template<typename T>
+    Task<T> Promise<T>::get_return_object() noexcept {
+        return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> Promise<void>::get_return_object() noexcept {
+        return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+    }
+}
+
+// Запускает все задачи параллельно на пуле и продолжает корутину, когда завершится последняя.
+// Результаты в порядке задач; первое исключение пробрасывается после завершения всех.
+template<typename T>
+Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> whenAll(JobSystem& jobs, std::vector<Task<T>> tasks) {
+    struct State {
+        std::atomic<size_t> remaining;
+        std::coroutine_handle<> continuation;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        std::vector<std::optional<std::conditional_t<std::is_void_v<T>, bool, T>>> results;
+    };
+
+    State state;
+    state.remaining.store(tasks.size() + 1);
+    state.results.resize(tasks.size());
+
+    struct Awaiter {
+        JobSystem& jobs;
+        std::vector<Task<T>>& tasks;
+        State& state;
+
+        bool await_ready() const noexcept { return tasks.empty(); }
+
+        static TaskDetail::Detached runOne(JobSystem& jobs, Task<T>& task, State& state, size_t index) {
+            co_await jobs.schedule();
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await std::move(task);
+                    state.results[index].emplace(true);
+                } else {
+                    state.results[index].emplace(co_await std::move(task));
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state.errorMutex);
+                if (!state.error) {
+                    state.error = std::current_exception();
+                }
+            }
+            if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                state.continuation.resume();
+            }
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiting) {
+            state.continuation = awaiting;
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                runOne(jobs, tasks[i], state, i);
+            }
+            // Последняя задача могла закончиться раньше цикла - тогда продолжаем без приостановки
+            return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    co_await Awaiter{jobs, tasks, state};
+
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        std::vector<T> values;
+        values.reserve(state.results.size());
+        for (auto& result : state.results) {
+            values.push_back(std::move(*result));
+        }
+        co_return values;
+    }
+}
+
+// Блокирует вызывающий поток до завершения задачи. Для кода вне корутин (main, обработчики окна);
+// из задач JobSystem не вызывается, иначе поток пула простаивает
+template<typename T>
+T syncWait(Task<T> task) {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool done = false;
+    std::exception_ptr error;
+    std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+
+    auto run = [&]() -> TaskDetail::Detached {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+            } else {
+                result.emplace(co_await std::move(task));
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        condition.notify_one();
+    };
+    run();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&] { return done; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*result);
+    }
+}
+
+#endif //OBJVIEWER_TASK_H
@@ -0,0 +1,232 @@
+#ifndef OBJVIEWER_TRACE_H
+#define OBJVIEWER_TRACE_H
+
+#include <iosfwd>
+#include <string>
+
+// Трассировка горячих путей. OBJVIEWER_TRACE_SCOPE("parse") отмечает интервал до конца блока;
+// интервалы пишутся без блокировок в кольцевой буфер своего потока, writeChromeTrace
+// выгружает их в JSON для chrome://tracing и ui.perfetto.dev.
+//
+// Включается определением OBJVIEWER_TRACING (опция CMake OBJVIEWER_TRACING). Без него макросы
+// раскрываются в пустоту, а функции Trace ничего не делают, поэтому вызовы можно не прятать
+// за #ifdef. Имя интервала - строковый литерал или __func__: хранится только указатель.
+// Ставить интервалы стоит на этапы (файл, меш, кадр), а не на отдельные треугольники:
+// один интервал стоит двух чтений steady_clock и трёх записей в кольцо
+
+#ifdef OBJVIEWER_TRACING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace Trace {
+    inline uint64_t nowNanoseconds() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    struct Record {
+        const char* name;
+        uint64_t start;
+        uint64_t duration;
+        uint32_t threadId;
+    };
+
+    // Кольцо одного потока. Пишет только владелец; читатель копирует записи и отбрасывает те,
+    // которые владелец мог перезаписать за время копирования. Выгрузка во время записи
+    // безопасна: поля слотов атомарные, а ненадёжная часть кольца отрезается
+    class ThreadBuffer {
+    public:
+        static constexpr size_t Capacity = 1 << 15;
+
+    private:
+        struct Slot {
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> start{0};
+            std::atomic<uint64_t> duration{0};
+        };
+
+        std::unique_ptr<Slot[]> slots{new Slot[Capacity]};
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> clearedBefore{0};
+        uint32_t threadId;
+
+    public:
+        explicit ThreadBuffer(uint32_t id) : threadId(id) {}
+
+        void push(const char* name, uint64_t start, uint64_t duration) {
+            uint64_t index = written.load(std::memory_order_relaxed);
+            Slot& slot = slots[index & (Capacity - 1)];
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.start.store(start, std::memory_order_relaxed);
+            slot.duration.store(duration, std::memory_order_relaxed);
+            written.store(index + 1, std::memory_order_release);
+        }
+
+        void snapshot(std::vector<Record>& out) const {
+            const uint64_t end = written.load(std::memory_order_acquire);
+            uint64_t begin = std::max(clearedBefore.load(std::memory_order_relaxed), end > Capacity ? end - Capacity : 0);
+            const size_t first = out.size();
+            for (uint64_t index = begin; index < end; ++index) {
+                const Slot& slot = slots[index & (Capacity - 1)];
+                out.push_back({slot.name.load(std::memory_order_acquire), slot.start.load(std::memory_order_acquire),
+                               slot.duration.load(std::memory_order_acquire), threadId});
+            }
+
+            // Запись с номером after перезаписывает after - Capacity: всё до неё включительно ненадёжно
+            const uint64_t after = written.load(std::memory_order_relaxed);
+            if (after >= Capacity && after - Capacity + 1 > begin) {
+                size_t unreliable = static_cast<size_t>(std::min(after - Capacity + 1, end) - begin);
+                out.erase(out.begin() + static_cast<std::ptrdiff_t>(first),
+                          out.begin() + static_cast<std::ptrdiff_t>(first + unreliable));
+            }
+        }
+
+        void clear() {
+            clearedBefore.store(written.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    };
+
+    // Буферы всех потоков. Буфер переживает свой поток, чтобы его интервалы попали в выгрузку
+    class Registry {
+    private:
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+    public:
+        std::atomic<bool> enabled{true};
+
+        static Registry& instance() {
+            static Registry registry;
+            return registry;
+        }
+
+        std::shared_ptr<ThreadBuffer> registerThread() {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.push_back(std::make_shared<ThreadBuffer>(static_cast<uint32_t>(buffers.size() + 1)));
+            return buffers.back();
+        }
+
+        std::vector<Record> collect() {
+            std::vector<Record> records;
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& buffer : buffers) {
+                buffer->snapshot(records);
+            }
+            return records;
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& buffer : buffers) {
+                buffer->clear();
+            }
+        }
+    };
+
+    inline ThreadBuffer& threadBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = Registry::instance().registerThread();
+        return *buffer;
+    }
+
+    class Scope {
+    private:
+        const char* name;
+        uint64_t start;
+
+    public:
+        explicit Scope(const char* scopeName)
+                : name(Registry::instance().enabled.load(std::memory_order_relaxed) ? scopeName : nullptr),
+                  start(name ? nowNanoseconds() : 0) {}
+
+        ~Scope() {
+            if (name) {
+                threadBuffer().push(name, start, nowNanoseconds() - start);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    constexpr bool isCompiledIn() { return true; }
+
+    // Запись можно приостановить во время работы; уже записанное сохраняется
+    inline void setEnabled(bool enabled) { Registry::instance().enabled.store(enabled, std::memory_order_relaxed); }
+
+    inline void clear() { Registry::instance().clear(); }
+
+    // Complete-события ("ph": "X"), время в микросекундах от первого интервала
+    inline void writeChromeTrace(std::ostream& out) {
+        std::vector<Record> records = Registry::instance().collect();
+        std::sort(records.begin(), records.end(), [](const Record& lhs, const Record& rhs) {
+            return lhs.start < rhs.start;
+        });
+        const uint64_t origin = records.empty() ? 0 : records.front().start;
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        char number[64];
+        for (size_t i = 0; i < records.size(); ++i) {
+            const Record& record = records[i];
+            out << (i ? ",\n" : "\n") << "{\"name\":\"";
+            for (const char* c = record.name ? record.name : "?"; *c; ++c) {
+                if (*c == '"' || *c == '\\') {
+                    out << '\\';
+                }
+                out << *c;
+            }
+            std::snprintf(number, sizeof(number), "%.3f", static_cast<double>(record.start - origin) / 1000.0);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << record.threadId << ",\"ts\":" << number;
+            std::snprintf(number, sizeof(number), "%.3f", static_cast<double>(record.duration) / 1000.0);
+            out << ",\"dur\":" << number << '}';
+        }
+        out << "\n]}\n";
+    }
+
+    inline bool writeChromeTrace(const std::string& filePath) {
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        writeChromeTrace(file);
+        return static_cast<bool>(file);
+    }
+
+    // Выгрузка по запросу из окружения: OBJVIEWER_TRACE=путь
+    inline bool writeRequestedTrace() {
+        const char* filePath = std::getenv("OBJVIEWER_TRACE");
+        return filePath && *filePath && writeChromeTrace(std::string(filePath));
+    }
+}
+
+#define OBJVIEWER_TRACE_CONCAT_IMPL(a, b) a##b
+#define OBJVIEWER_TRACE_CONCAT(a, b) OBJVIEWER_TRACE_CONCAT_IMPL(a, b)
+#define OBJVIEWER_TRACE_SCOPE(name) ::Trace::Scope OBJVIEWER_TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#else
+
+namespace Trace {
+    constexpr bool isCompiledIn() { return false; }
+    inline void setEnabled(bool) {}
+    inline void clear() {}
+    inline void writeChromeTrace(std::ostream&) {}
+    inline bool writeChromeTrace(const std::string&) { return false; }
+    inline bool writeRequestedTrace() { return false; }
+}
+
+#define OBJVIEWER_TRACE_SCOPE(name) ((void)0)
+
+#endif
+
+#define OBJVIEWER_TRACE_FUNCTION() OBJVIEWER_TRACE_SCOPE(__func__)
+
+#endif //OBJVIEWER_TRACE_H
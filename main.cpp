@@ -1,3 +1,4 @@
+#include <string>
 #include <unordered_map>
 #include "renders/OpenGLWindow.h"
 #include "models/ModelManager.h"
@@ -19,6 +20,17 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         }
         return 0;
 
+    case WM_PAINT: {
+        //   ,     
+        PAINTSTRUCT ps;
+        BeginPaint(hwnd, &ps);
+        EndPaint(hwnd, &ps);
+        if (window) {
+            window->onPaint();
+        }
+        return 0;
+    }
+
     case WM_LBUTTONDOWN:
         if (window) {
             window->onMouseDown(LOWORD(lParam), HIWORD(lParam));
@@ -72,6 +84,18 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
         //  
         auto window = std::make_unique<OpenGLWindow>();
+
+        // --record-input :         OBJInputReplay
+        std::string commandLine = lpCmdLine ? lpCmdLine : "";
+        std::string recordPath;
+        const std::string recordOption = "--record-input ";
+        if (auto option = commandLine.find(recordOption); option != std::string::npos) {
+            recordPath = commandLine.substr(option + recordOption.size());
+            recordPath.erase(recordPath.find_last_not_of(" \t\"") + 1);
+            recordPath.erase(0, recordPath.find_first_not_of(" \t\""));
+            window->startInputRecording();
+        }
+
         if (!window->create("3D Model Viewer")) {
             MessageBoxA(nullptr, "Failed to create OpenGL window", "Error", MB_OK | MB_ICONERROR);
             return 1;
@@ -83,7 +107,11 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         }
 
         //   
-        return window->runMessageLoop();
+        int exitCode = window->runMessageLoop();
+        if (!recordPath.empty()) {
+            window->saveInputRecording(recordPath);
+        }
+        return exitCode;
     }
     catch (const std::exception& e) {
         MessageBoxA(nullptr, e.what(), "Error", MB_OK | MB_ICONERROR);
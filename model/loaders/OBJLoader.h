@@ -16,6 +16,7 @@ public:
 
 private:
     [[nodiscard]] static std::vector<Triangle> convertToTriangles(std::unique_ptr<OBJModel> objModel) {
+        OBJVIEWER_TRACE_SCOPE("OBJLoader::convertToTriangles");
         std::vector<Triangle> triangles;
 
         const auto& vertices = objModel->getVertices();
@@ -3,6 +3,11 @@
 
 #include "Vector3D.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define OBJVIEWER_MATRIX_SSE
+#include <emmintrin.h>
+#endif
+
 namespace VecMath {
     template<Numeric T>
     class Matrix4x4 {
@@ -80,18 +85,18 @@ namespace VecMath {
             return Matrix4x4(
                     1.0f / (aspect * tanHalfFov), 0.0f, 0.0f, 0.0f,
                     0.0f, 1.0f / tanHalfFov, 0.0f, 0.0f,
-                    0.0f, 0.0f, (near + far) / range, -1.0f,
-                    0.0f, 0.0f, (2.0f * near * far) / range, 0.0f
+                    0.0f, 0.0f, (near + far) / range, (2.0f * near * far) / range,
+                    0.0f, 0.0f, -1.0f, 0.0f
             );
         }
 
         // Ортографическая проекция
         static Matrix4x4 orthographic(float left, float right, float bottom, float top, float near, float far) {
             return Matrix4x4(
-                    2.0f / (right - left), 0.0f, 0.0f, 0.0f,
-                    0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
-                    0.0f, 0.0f, -2.0f / (far - near), 0.0f,
-                    -(right + left) / (right - left), -(top + bottom) / (top - bottom), -(far + near) / (far - near), 1.0f
+                    2.0f / (right - left), 0.0f, 0.0f, -(right + left) / (right - left),
+                    0.0f, 2.0f / (top - bottom), 0.0f, -(top + bottom) / (top - bottom),
+                    0.0f, 0.0f, -2.0f / (far - near), -(far + near) / (far - near),
+                    0.0f, 0.0f, 0.0f, 1.0f
             );
         }
 
@@ -112,10 +117,10 @@ namespace VecMath {
         // Трансляция
         static Matrix4x4 translate(const Vector3D<T>& translation) {
             return Matrix4x4(
-                    1.0f, 0.0f, 0.0f, 0.0f,
-                    0.0f, 1.0f, 0.0f, 0.0f,
-                    0.0f, 0.0f, 1.0f, 0.0f,
-                    translation.x, translation.y, translation.z, 1.0f
+                    1.0f, 0.0f, 0.0f, translation.x,
+                    0.0f, 1.0f, 0.0f, translation.y,
+                    0.0f, 0.0f, 1.0f, translation.z,
+                    0.0f, 0.0f, 0.0f, 1.0f
             );
         }
 
@@ -127,9 +132,9 @@ namespace VecMath {
             const Vector3D<T> n = axis.normalized();
 
             return Matrix4x4(
-                    t * n.x * n.x + c, t * n.x * n.y + s * n.z, t * n.x * n.z - s * n.y, 0.0f,
-                    t * n.x * n.y - s * n.z, t * n.y * n.y + c, t * n.y * n.z + s * n.x, 0.0f,
-                    t * n.x * n.z + s * n.y, t * n.y * n.z - s * n.x, t * n.z * n.z + c, 0.0f,
+                    t * n.x * n.x + c, t * n.x * n.y - s * n.z, t * n.x * n.z + s * n.y, 0.0f,
+                    t * n.x * n.y + s * n.z, t * n.y * n.y + c, t * n.y * n.z - s * n.x, 0.0f,
+                    t * n.x * n.z - s * n.y, t * n.y * n.z + s * n.x, t * n.z * n.z + c, 0.0f,
                     0.0f, 0.0f, 0.0f, 1.0f
             );
         }
@@ -144,6 +149,43 @@ namespace VecMath {
             );
         }
 
+        // Аффинное преобразование: нижняя строка (0, 0, 0, 1)
+        [[nodiscard]] constexpr bool isAffine() const noexcept {
+            return m30 == T(0) && m31 == T(0) && m32 == T(0) && m33 == T(1);
+        }
+
+        [[nodiscard]] constexpr Matrix4x4 transposed() const noexcept {
+            return Matrix4x4(
+                    m00, m10, m20, m30,
+                    m01, m11, m21, m31,
+                    m02, m12, m22, m32,
+                    m03, m13, m23, m33
+            );
+        }
+
+        // Обратная матрица. Для аффинной обращается только блок 3x3, для float общий случай
+        // считается на SSE. Вырожденная матрица даёт нулевую
+        [[nodiscard]] Matrix4x4 inverse() const noexcept {
+            if (isAffine()) {
+                return affineInverse(false);
+            }
+#ifdef OBJVIEWER_MATRIX_SSE
+            if constexpr (std::is_same_v<T, float>) {
+                return inverseSse();
+            }
+#endif
+            return inverseScalar();
+        }
+
+        // Матрица нормалей: обратная транспонированная. Для аффинной перенос на нормали
+        // не влияет, и результат - присоединённая 3x3, делённая на определитель
+        [[nodiscard]] Matrix4x4 inverseTranspose() const noexcept {
+            if (isAffine()) {
+                return affineInverse(true);
+            }
+            return inverse().transposed();
+        }
+
         // Доступ к элементам
         constexpr T* data() noexcept { return m; }
         constexpr const T* data() const noexcept { return m; }
@@ -155,6 +197,179 @@ namespace VecMath {
                       << "[" << mat.m20 << ", " << mat.m21 << ", " << mat.m22 << ", " << mat.m23 << "]\n"
                       << "[" << mat.m30 << ", " << mat.m31 << ", " << mat.m32 << ", " << mat.m33 << "]";
         }
+
+    private:
+        static constexpr Matrix4x4 zero() noexcept {
+            return Matrix4x4(T(0), T(0), T(0), T(0), T(0), T(0), T(0), T(0),
+                             T(0), T(0), T(0), T(0), T(0), T(0), T(0), T(0));
+        }
+
+        // transposeOnly - вернуть обратную транспонированную 3x3 без переноса (матрица нормалей)
+        Matrix4x4 affineInverse(bool transposeOnly) const noexcept {
+            const T c00 = m11 * m22 - m12 * m21;
+            const T c01 = m12 * m20 - m10 * m22;
+            const T c02 = m10 * m21 - m11 * m20;
+            const T det = m00 * c00 + m01 * c01 + m02 * c02;
+            if (det == T(0)) {
+                return zero();
+            }
+
+            const T c10 = m02 * m21 - m01 * m22;
+            const T c11 = m00 * m22 - m02 * m20;
+            const T c12 = m01 * m20 - m00 * m21;
+            const T c20 = m01 * m12 - m02 * m11;
+            const T c21 = m02 * m10 - m00 * m12;
+            const T c22 = m00 * m11 - m01 * m10;
+            const T invDet = T(1) / det;
+
+            if (transposeOnly) {
+                return Matrix4x4(
+                        c00 * invDet, c01 * invDet, c02 * invDet, T(0),
+                        c10 * invDet, c11 * invDet, c12 * invDet, T(0),
+                        c20 * invDet, c21 * invDet, c22 * invDet, T(0),
+                        T(0), T(0), T(0), T(1)
+                );
+            }
+
+            // [A t; 0 1]^-1 = [A^-1, -A^-1 t; 0 1]
+            const T i00 = c00 * invDet, i01 = c10 * invDet, i02 = c20 * invDet;
+            const T i10 = c01 * invDet, i11 = c11 * invDet, i12 = c21 * invDet;
+            const T i20 = c02 * invDet, i21 = c12 * invDet, i22 = c22 * invDet;
+            return Matrix4x4(
+                    i00, i01, i02, -(i00 * m03 + i01 * m13 + i02 * m23),
+                    i10, i11, i12, -(i10 * m03 + i11 * m13 + i12 * m23),
+                    i20, i21, i22, -(i20 * m03 + i21 * m13 + i22 * m23),
+                    T(0), T(0), T(0), T(1)
+            );
+        }
+
+        // Разложение по минорам 2x2: шесть миноров из верхних двух строк и шесть из нижних
+        Matrix4x4 inverseScalar() const noexcept {
+            const T s0 = m00 * m11 - m10 * m01;
+            const T s1 = m00 * m12 - m10 * m02;
+            const T s2 = m00 * m13 - m10 * m03;
+            const T s3 = m01 * m12 - m11 * m02;
+            const T s4 = m01 * m13 - m11 * m03;
+            const T s5 = m02 * m13 - m12 * m03;
+
+            const T c5 = m22 * m33 - m32 * m23;
+            const T c4 = m21 * m33 - m31 * m23;
+            const T c3 = m21 * m32 - m31 * m22;
+            const T c2 = m20 * m33 - m30 * m23;
+            const T c1 = m20 * m32 - m30 * m22;
+            const T c0 = m20 * m31 - m30 * m21;
+
+            const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            if (det == T(0)) {
+                return zero();
+            }
+            const T invDet = T(1) / det;
+
+            return Matrix4x4(
+                    ( m11 * c5 - m12 * c4 + m13 * c3) * invDet,
+                    (-m01 * c5 + m02 * c4 - m03 * c3) * invDet,
+                    ( m31 * s5 - m32 * s4 + m33 * s3) * invDet,
+                    (-m21 * s5 + m22 * s4 - m23 * s3) * invDet,
+
+                    (-m10 * c5 + m12 * c2 - m13 * c1) * invDet,
+                    ( m00 * c5 - m02 * c2 + m03 * c1) * invDet,
+                    (-m30 * s5 + m32 * s2 - m33 * s1) * invDet,
+                    ( m20 * s5 - m22 * s2 + m23 * s1) * invDet,
+
+                    ( m10 * c4 - m11 * c2 + m13 * c0) * invDet,
+                    (-m00 * c4 + m01 * c2 - m03 * c0) * invDet,
+                    ( m30 * s4 - m31 * s2 + m33 * s0) * invDet,
+                    (-m20 * s4 + m21 * s2 - m23 * s0) * invDet,
+
+                    (-m10 * c3 + m11 * c1 - m12 * c0) * invDet,
+                    ( m00 * c3 - m01 * c1 + m02 * c0) * invDet,
+                    (-m30 * s3 + m31 * s1 - m32 * s0) * invDet,
+                    ( m20 * s3 - m21 * s1 + m22 * s0) * invDet
+            );
+        }
+
+#ifdef OBJVIEWER_MATRIX_SSE
+        // Блочное обращение через четыре подматрицы 2x2, каждая в одном регистре.
+        // Столбцы читаются как строки: обращение транспонированной - транспонированная обратная,
+        // поэтому результат записывается обратно в том же порядке
+        template<int X, int Y, int Z, int W>
+        static __m128 shuffle(__m128 a, __m128 b) noexcept {
+            return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        template<int X, int Y, int Z, int W>
+        static __m128 swizzle(__m128 a) noexcept {
+            return shuffle<X, Y, Z, W>(a, a);
+        }
+
+        // A * B для 2x2 в порядке (00, 01, 10, 11)
+        static __m128 mul2x2(__m128 a, __m128 b) noexcept {
+            return _mm_add_ps(_mm_mul_ps(a, swizzle<0, 3, 0, 3>(b)),
+                              _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+        }
+
+        // adj(A) * B
+        static __m128 adjMul2x2(__m128 a, __m128 b) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(a), b),
+                              _mm_mul_ps(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+        }
+
+        // A * adj(B)
+        static __m128 mulAdj2x2(__m128 a, __m128 b) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(a, swizzle<3, 0, 3, 0>(b)),
+                              _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+        }
+
+        Matrix4x4 inverseSse() const noexcept {
+            const __m128 r0 = _mm_loadu_ps(m);
+            const __m128 r1 = _mm_loadu_ps(m + 4);
+            const __m128 r2 = _mm_loadu_ps(m + 8);
+            const __m128 r3 = _mm_loadu_ps(m + 12);
+
+            const __m128 a = _mm_movelh_ps(r0, r1);
+            const __m128 b = _mm_movehl_ps(r1, r0);
+            const __m128 c = _mm_movelh_ps(r2, r3);
+            const __m128 d = _mm_movehl_ps(r3, r2);
+
+            // (|A|, |B|, |C|, |D|)
+            const __m128 detSub = _mm_sub_ps(
+                    _mm_mul_ps(shuffle<0, 2, 0, 2>(r0, r2), shuffle<1, 3, 1, 3>(r1, r3)),
+                    _mm_mul_ps(shuffle<1, 3, 1, 3>(r0, r2), shuffle<0, 2, 0, 2>(r1, r3)));
+            const __m128 detA = swizzle<0, 0, 0, 0>(detSub);
+            const __m128 detB = swizzle<1, 1, 1, 1>(detSub);
+            const __m128 detC = swizzle<2, 2, 2, 2>(detSub);
+            const __m128 detD = swizzle<3, 3, 3, 3>(detSub);
+
+            const __m128 dc = adjMul2x2(d, c);
+            const __m128 ab = adjMul2x2(a, b);
+            __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mul2x2(b, dc));
+            __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mul2x2(c, ab));
+            __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mulAdj2x2(d, ab));
+            __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mulAdj2x2(a, dc));
+
+            // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+            __m128 trace = _mm_mul_ps(ab, swizzle<0, 2, 1, 3>(dc));
+            trace = _mm_add_ps(trace, swizzle<2, 3, 0, 1>(trace));
+            trace = _mm_add_ps(trace, swizzle<1, 0, 3, 2>(trace));
+            const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+            if (_mm_cvtss_f32(detM) == 0.0f) {
+                return zero();
+            }
+
+            const __m128 invDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+            x = _mm_mul_ps(x, invDetM);
+            y = _mm_mul_ps(y, invDetM);
+            z = _mm_mul_ps(z, invDetM);
+            w = _mm_mul_ps(w, invDetM);
+
+            Matrix4x4 result;
+            _mm_storeu_ps(result.m, shuffle<3, 1, 3, 1>(x, y));
+            _mm_storeu_ps(result.m + 4, shuffle<2, 0, 2, 0>(x, y));
+            _mm_storeu_ps(result.m + 8, shuffle<3, 1, 3, 1>(z, w));
+            _mm_storeu_ps(result.m + 12, shuffle<2, 0, 2, 0>(z, w));
+            return result;
+        }
+#endif
     };
 }
 
@@ -6,6 +6,7 @@
 #include <memory>
 #include <optional>
 #include <fstream>
+#include <vector>
 #include "Material.h"
 
 
@@ -21,6 +22,25 @@ public:
         }
 
         auto materials = std::make_unique<MaterialMap>();
+        for (auto& material : parse(file)) {
+            (*materials)[material.name] = std::move(material);
+        }
+        return materials;
+    }
+
+    // Материалы в порядке файла (для MaterialLibrary: номера не зависят от порядка хеш-таблицы).
+    // Повторное newmtl с тем же именем даёт второй элемент; при загрузке в библиотеку побеждает последний
+    static std::optional<std::vector<Material>> loadMaterials(const std::string& filepath) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            return std::nullopt;
+        }
+        return parse(file);
+    }
+
+private:
+    static std::vector<Material> parse(std::istream& file) {
+        std::vector<Material> materials;
         Material currentMaterial;
 
         std::string line;
@@ -31,8 +51,9 @@ public:
 
             if (key == "newmtl") {
                 if (!currentMaterial.name.empty()) {
-                    (*materials)[currentMaterial.name] = currentMaterial;
+                    materials.push_back(currentMaterial);
                 }
+                currentMaterial = Material();
                 iss >> currentMaterial.name;
             } else if (key == "Ka") {
                 iss >> currentMaterial.ambientColor.r >> currentMaterial.ambientColor.g >> currentMaterial.ambientColor.b;
@@ -49,18 +70,18 @@ public:
                 iss >> illumValue;
                 currentMaterial.illum = illumValue > 0;
             } else if (key == "map_Kd") {
-                std::string texturePath;
-                iss >> texturePath;
-                currentMaterial.textureMap = texturePath;
+                // Опции (-s 1 1 1, -bm 0.5 ...) идут перед именем файла, поэтому берётся последнее слово
+                std::string token;
+                while (iss >> token) {
+                    currentMaterial.textureMap = token;
+                }
             }
         }
 
         // Добавляем последний материал
         if (!currentMaterial.name.empty()) {
-            (*materials)[currentMaterial.name] = currentMaterial;
+            materials.push_back(currentMaterial);
         }
-
-        file.close();
         return materials;
     }
 };
@@ -20,6 +20,8 @@
 #include <optional>
 #include <variant>
 #include <string_view>
+#include "../../core/Trace.h"
+#include "../../core/MemoryStats.h"
 
 class OBJModel {
 private:
@@ -45,6 +47,7 @@ private:
 public:
     // Функция для чтения OBJ-файла
     static std::unique_ptr<OBJModel> loadOBJ(const std::string& filepath) {
+        OBJVIEWER_TRACE_SCOPE("OBJModel::loadOBJ");
         std::ifstream file(filepath);
         if (!file.is_open()) {
             std::cerr << "Failed to open file: " << filepath << std::endl;
@@ -118,6 +121,7 @@ public:
         }
 
         file.close();
+        model->updateMemory();
         return model;
     }
 
@@ -142,6 +146,18 @@ private:
 
 
     std::string mtlLib;
+
+    // Учитывается один раз после разбора: пулы растут только внутри loadOBJ
+    MemoryAccount memory{MemoryTag::ObjModel};
+
+    void updateMemory() {
+        size_t bytes = vertices.capacity() * sizeof(Vertex) + normals.capacity() * sizeof(Normal)
+                       + texCoords.capacity() * sizeof(TexCoord) + faces.capacity() * sizeof(Face);
+        for (const auto& face : faces) {
+            bytes += face.vertexIndices.capacity() * sizeof(face.vertexIndices[0]);
+        }
+        memory.set(bytes);
+    }
 };
 
 #endif //OBJVIEWER__OBJMODEL_H
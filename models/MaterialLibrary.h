@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../model/obj/Material.h"
+
+// Materials of one model under dense ids, so meshes and renderers index a vector
+// instead of hashing names. Id 0 is the default material: faces before any usemtl.
+class MaterialLibrary {
+private:
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    std::vector<Material> materials;
+    std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> ids;
+
+public:
+    static constexpr uint32_t DefaultMaterial = 0;
+    static constexpr uint32_t NotFound = ~0u;
+
+    MaterialLibrary() {
+        materials.emplace_back();
+        materials.back().name = "default";
+        ids.emplace(materials.back().name, DefaultMaterial);
+    }
+
+    // Id of the named material; an unknown name gets the next id and default properties.
+    // Lookups of known names do not allocate.
+    uint32_t intern(std::string_view name) {
+        if (auto it = ids.find(name); it != ids.end()) {
+            return it->second;
+        }
+        const auto id = static_cast<uint32_t>(materials.size());
+        materials.emplace_back();
+        materials.back().name = std::string(name);
+        ids.emplace(materials.back().name, id);
+        return id;
+    }
+
+    uint32_t find(std::string_view name) const {
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : NotFound;
+    }
+
+    // Sets the properties of material.name, keeping its id if it was already interned.
+    uint32_t define(const Material& material) {
+        const uint32_t id = intern(material.name);
+        materials[id] = material;
+        return id;
+    }
+
+    const Material& get(uint32_t id) const { return materials[id]; }
+    size_t size() const { return materials.size(); }
+};
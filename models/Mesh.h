@@ -1,6 +1,16 @@
 #pragma once
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <memory_resource>
+#include "MeshOptimizer.h"
+#include "VertexCodec.h"
+#include "MaterialLibrary.h"
+#include "../core/MemoryStats.h"
 
 class Mesh {
 public:
@@ -10,6 +20,44 @@ public:
         float u, v;
     };
 
+    // 16-byte upload format, see VertexCodec.
+    struct PackedVertex {
+        uint16_t px, py, pz, padding;
+        int16_t nx, ny;
+        uint16_t u, v;
+    };
+
+    struct Bounds {
+        std::array<float, 3> min{ 0.0f, 0.0f, 0.0f };
+        std::array<float, 3> max{ 0.0f, 0.0f, 0.0f };
+
+        std::array<float, 3> extent() const {
+            return { max[0] - min[0], max[1] - min[1], max[2] - min[2] };
+        }
+    };
+
+    // Contiguous run of triangles in the index buffer with its own bounds,
+    // used by the occlusion culler.
+    struct Cluster {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        Bounds bounds;
+    };
+
+    static constexpr size_t TrianglesPerCluster = 256;
+
+    // Entry of getEdgeNeighbors() for an edge with no single opposite triangle.
+    static constexpr uint32_t NoNeighbor = ~0u;
+
+    // Triangles of one material, contiguous in the index buffer. Submeshes follow each other
+    // in material id order and clusters never cross them, so a renderer binds the material
+    // once per submesh.
+    struct Submesh {
+        uint32_t material;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
     struct Face {
         std::vector<size_t> vertexIndices;
         std::vector<size_t> normalIndices;
@@ -17,72 +65,447 @@ public:
     };
 
 private:
+    struct VertexKey {
+        size_t position, texCoord, normal;
+
+        bool operator==(const VertexKey& other) const {
+            return position == other.position && texCoord == other.texCoord && normal == other.normal;
+        }
+    };
+
+    struct VertexKeyHash {
+        size_t operator()(const VertexKey& key) const {
+            size_t hash = key.position * 0x9E3779B97F4A7C15ull;
+            hash ^= key.texCoord + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            hash ^= key.normal + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    // Bit pattern of a vertex position, for matching positions across seams.
+    struct PositionHash {
+        size_t operator()(const std::array<uint32_t, 3>& bits) const {
+            size_t hash = bits[0] * 0x9E3779B97F4A7C15ull;
+            hash ^= bits[1] + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            hash ^= bits[2] + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    static constexpr size_t NoIndex = static_cast<size_t>(-1);
+
+    // Faces from firstFace up to the next run use material.
+    struct MaterialRun {
+        size_t firstCorner;
+        uint32_t firstFace;
+        uint32_t material;
+    };
+
     std::string name;
     std::vector<Vertex> vertices;
-    std::vector<Face> faces;
+    std::vector<PackedVertex> packedVertices;
+    std::vector<uint32_t> indices;
+    Bounds bounds;
+    std::vector<Cluster> clusters;
+    std::vector<Submesh> submeshes;
+    std::vector<uint32_t> edgeNeighbors;
+    MeshOptimizer::Report optimizationReport;
+
+    // Raw attributes live in the resource given to the constructor, usually the loader's
+    // per-load arena. Faces are stored flat: one corner per face vertex plus the face sizes.
+    std::pmr::vector<std::array<float, 3>> positions;
+    std::pmr::vector<std::array<float, 3>> normals;
+    std::pmr::vector<std::array<float, 2>> texCoords;
+    std::pmr::vector<VertexKey> corners;
+    std::pmr::vector<uint32_t> faceSizes;
+    std::pmr::vector<MaterialRun> materialRuns;
+    bool attributesReleased = false;
+
+    MemoryAccount attributeMemory{ MemoryTag::MeshAttributes };
+    MemoryAccount vertexMemory{ MemoryTag::MeshVertices };
 
-    std::vector<std::array<float, 3>> positions;
-    std::vector<std::array<float, 3>> normals;
-    std::vector<std::array<float, 2>> texCoords;
+    // Accounts are refreshed when a raw array reallocates and whenever processing settles
+    // the buffers, so the totals do not cost an atomic per parsed element.
+    template<typename T>
+    void append(std::pmr::vector<T>& array, T value) {
+        const bool grows = array.size() == array.capacity();
+        array.push_back(std::move(value));
+        if (grows) {
+            updateAttributeMemory();
+        }
+    }
+
+    void updateAttributeMemory() {
+        attributeMemory.set(positions.capacity() * sizeof(positions[0]) + normals.capacity() * sizeof(normals[0])
+                            + texCoords.capacity() * sizeof(texCoords[0]) + corners.capacity() * sizeof(VertexKey)
+                            + faceSizes.capacity() * sizeof(uint32_t) + materialRuns.capacity() * sizeof(MaterialRun));
+    }
+
+    void updateVertexMemory() {
+        vertexMemory.set(vertices.capacity() * sizeof(Vertex) + packedVertices.capacity() * sizeof(PackedVertex)
+                         + indices.capacity() * sizeof(uint32_t) + clusters.capacity() * sizeof(Cluster)
+                         + submeshes.capacity() * sizeof(Submesh) + edgeNeighbors.capacity() * sizeof(uint32_t));
+    }
 
 public:
-    explicit Mesh(std::string meshName) : name(std::move(meshName)) {}
+    // Raw attributes are allocated from resource until releaseAttributes(); a mesh built
+    // on an arena must be processed and released before the arena goes away.
+    explicit Mesh(std::string meshName, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : name(std::move(meshName)), positions(resource), normals(resource), texCoords(resource),
+          corners(resource), faceSizes(resource), materialRuns(resource) {}
 
     const std::string& getName() const { return name; }
     const std::vector<Vertex>& getVertices() const { return vertices; }
-    const std::vector<Face>& getFaces() const { return faces; }
+    const std::vector<PackedVertex>& getPackedVertices() const { return packedVertices; }
+    const std::vector<uint32_t>& getIndices() const { return indices; }
+    const Bounds& getBounds() const { return bounds; }
+    const std::vector<Cluster>& getClusters() const { return clusters; }
+    const std::vector<Submesh>& getSubmeshes() const { return submeshes; }
+
+    // One entry per index: the triangle across the edge from indices[i] to the next corner
+    // of its triangle, or NoNeighbor on borders and non-manifold edges. Vertices split by
+    // texcoord or normal seams are matched by position, so seams are not borders.
+    const std::vector<uint32_t>& getEdgeNeighbors() const { return edgeNeighbors; }
+    bool isCompressed() const { return !packedVertices.empty(); }
+    size_t getVertexCount() const { return isCompressed() ? packedVertices.size() : vertices.size(); }
+    const MeshOptimizer::Report& getOptimizationReport() const { return optimizationReport; }
+    size_t getFaceCount() const { return faceSizes.size(); }
+
+    bool hasAttributes() const { return !attributesReleased; }
+
+    // Bytes held by the raw attributes and the welded buffers, as reported to MemoryStats.
+    size_t getMemoryBytes() const { return attributeMemory.getBytes() + vertexMemory.getBytes(); }
 
     void addPosition(float x, float y, float z) {
-        positions.push_back({ x, y, z });
+        append(positions, { x, y, z });
     }
 
     void addNormal(float nx, float ny, float nz) {
-        normals.push_back({ nx, ny, nz });
+        append(normals, { nx, ny, nz });
     }
 
     void addTexCoord(float u, float v) {
-        texCoords.push_back({ u, v });
+        append(texCoords, { u, v });
     }
 
+    // Missing texcoord or normal indices of a corner are stored as "none".
     void addFace(const Face& face) {
-        faces.push_back(face);
+        const size_t count = face.vertexIndices.size();
+        for (size_t i = 0; i < count; ++i) {
+            append(corners, VertexKey{
+                face.vertexIndices[i],
+                i < face.texCoordIndices.size() ? face.texCoordIndices[i] : NoIndex,
+                i < face.normalIndices.size() ? face.normalIndices[i] : NoIndex
+            });
+        }
+        append(faceSizes, static_cast<uint32_t>(count));
+    }
+
+    // Faces added from now on use material (a MaterialLibrary id). Switching costs nothing
+    // per face: only the switch points are stored, and switches with no faces between collapse.
+    void setMaterial(uint32_t material) {
+        if (!materialRuns.empty() && materialRuns.back().firstFace == faceSizes.size()) {
+            materialRuns.back().material = material;
+            return;
+        }
+        const uint32_t current = materialRuns.empty() ? MaterialLibrary::DefaultMaterial : materialRuns.back().material;
+        if (material != current) {
+            append(materialRuns, MaterialRun{ corners.size(), static_cast<uint32_t>(faceSizes.size()), material });
+        }
     }
 
+    // Does nothing once the attributes are released: the welded vertices are all that is left.
     void processVertices() {
+        if (attributesReleased) {
+            return;
+        }
+        weldVertices();
+        std::vector<uint32_t> submeshStarts;
+        for (const Submesh& submesh : submeshes) {
+            submeshStarts.push_back(submesh.firstIndex);
+        }
+        optimizationReport = MeshOptimizer::optimize(vertices, indices, submeshStarts);
+        computeBounds();
+        buildClusters();
+        buildEdgeNeighbors();
+        updateAttributeMemory();
+        updateVertexMemory();
+    }
+
+    // Frees positions, normals, texcoords and faces after processVertices. The mesh keeps
+    // rendering from its welded vertices, but has no faces and can no longer be re-welded.
+    void releaseAttributes() {
+        positions.clear();
+        positions.shrink_to_fit();
+        normals.clear();
+        normals.shrink_to_fit();
+        texCoords.clear();
+        texCoords.shrink_to_fit();
+        corners.clear();
+        corners.shrink_to_fit();
+        faceSizes.clear();
+        faceSizes.shrink_to_fit();
+        materialRuns.clear();
+        materialRuns.shrink_to_fit();
+        attributesReleased = true;
+        updateAttributeMemory();
+    }
+
+    // Replaces the float vertices with PackedVertex. Positions keep about
+    // extent / 131070 per axis, normals stay within 0.05 degrees, texcoords keep 11 bits.
+    void compress() {
+        if (vertices.empty()) {
+            return;
+        }
+
+        auto extent = bounds.extent();
+        packedVertices.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex& vertex = vertices[i];
+            PackedVertex& packed = packedVertices[i];
+
+            packed.px = VertexCodec::quantizeUnorm16(vertex.x, bounds.min[0], extent[0]);
+            packed.py = VertexCodec::quantizeUnorm16(vertex.y, bounds.min[1], extent[1]);
+            packed.pz = VertexCodec::quantizeUnorm16(vertex.z, bounds.min[2], extent[2]);
+            packed.padding = 0;
+            VertexCodec::octEncode(vertex.nx, vertex.ny, vertex.nz, packed.nx, packed.ny);
+            packed.u = VertexCodec::floatToHalf(vertex.u);
+            packed.v = VertexCodec::floatToHalf(vertex.v);
+        }
+
         vertices.clear();
+        vertices.shrink_to_fit();
+        updateVertexMemory();
+    }
 
-        for (const auto& face : faces) {
-            size_t vertexCount = face.vertexIndices.size();
+    // Vertex access for CPU paths, independent of the storage format.
+    Vertex getVertex(size_t index) const {
+        if (!isCompressed()) {
+            return vertices[index];
+        }
 
-            for (size_t i = 0; i < vertexCount; ++i) {
-                Vertex vertex{};
+        const PackedVertex& packed = packedVertices[index];
+        auto extent = bounds.extent();
 
-                size_t posIndex = face.vertexIndices[i];
-                if (posIndex < positions.size()) {
-                    vertex.x = positions[posIndex][0];
-                    vertex.y = positions[posIndex][1];
-                    vertex.z = positions[posIndex][2];
+        Vertex vertex{};
+        vertex.x = VertexCodec::dequantizeUnorm16(packed.px, bounds.min[0], extent[0]);
+        vertex.y = VertexCodec::dequantizeUnorm16(packed.py, bounds.min[1], extent[1]);
+        vertex.z = VertexCodec::dequantizeUnorm16(packed.pz, bounds.min[2], extent[2]);
+        VertexCodec::octDecode(packed.nx, packed.ny, vertex.nx, vertex.ny, vertex.nz);
+        vertex.u = VertexCodec::halfToFloat(packed.u);
+        vertex.v = VertexCodec::halfToFloat(packed.v);
+        return vertex;
+    }
+
+private:
+    // Merges identical position/texcoord/normal triples into one vertex and
+    // fan-triangulates every face into the index buffer. The lookup nodes come from a
+    // local arena, so welding allocates a few large blocks instead of one node per vertex.
+    // Faces are emitted grouped by material: the material runs are stably sorted by id and
+    // walked in that order, which keeps file order within a material and yields one
+    // submesh per material however often the file switches.
+    void weldVertices() {
+        vertices.clear();
+        packedVertices.clear();
+        indices.clear();
+        submeshes.clear();
+
+        struct Run {
+            uint32_t material;
+            uint32_t firstFace;
+            uint32_t endFace;
+            size_t firstCorner;
+        };
+        std::vector<Run> runs;
+        runs.reserve(materialRuns.size() + 1);
+        if (materialRuns.empty() || materialRuns.front().firstFace != 0) {
+            runs.push_back({ MaterialLibrary::DefaultMaterial, 0, 0, 0 });
+        }
+        for (const MaterialRun& run : materialRuns) {
+            runs.push_back({ run.material, run.firstFace, 0, run.firstCorner });
+        }
+        for (size_t i = 0; i < runs.size(); ++i) {
+            runs[i].endFace = i + 1 < runs.size() ? runs[i + 1].firstFace : static_cast<uint32_t>(faceSizes.size());
+        }
+        std::stable_sort(runs.begin(), runs.end(), [](const Run& lhs, const Run& rhs) {
+            return lhs.material < rhs.material;
+        });
+
+        std::pmr::monotonic_buffer_resource lookupArena(positions.size() * 48 + 4096);
+        std::pmr::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexLookup(&lookupArena);
+        vertexLookup.reserve(positions.size());
+
+        std::vector<uint32_t> faceIndices;
+        for (const Run& run : runs) {
+            size_t first = run.firstCorner;
+            for (uint32_t faceIndex = run.firstFace; faceIndex < run.endFace; ++faceIndex) {
+                const uint32_t vertexCount = faceSizes[faceIndex];
+                const VertexKey* face = corners.data() + first;
+                first += vertexCount;
+                if (vertexCount < 3) {
+                    continue;
                 }
 
-                if (i < face.texCoordIndices.size()) {
-                    size_t texIndex = face.texCoordIndices[i];
-                    if (texIndex < texCoords.size()) {
-                        vertex.u = texCoords[texIndex][0];
-                        vertex.v = texCoords[texIndex][1];
+                faceIndices.clear();
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    const VertexKey& key = face[i];
+
+                    auto [it, inserted] = vertexLookup.try_emplace(key, static_cast<uint32_t>(vertices.size()));
+                    if (inserted) {
+                        vertices.push_back(makeVertex(key));
                     }
+                    faceIndices.push_back(it->second);
                 }
 
-                if (i < face.normalIndices.size()) {
-                    size_t normIndex = face.normalIndices[i];
-                    if (normIndex < normals.size()) {
-                        vertex.nx = normals[normIndex][0];
-                        vertex.ny = normals[normIndex][1];
-                        vertex.nz = normals[normIndex][2];
-                    }
+                if (submeshes.empty() || submeshes.back().material != run.material) {
+                    submeshes.push_back({ run.material, static_cast<uint32_t>(indices.size()), 0 });
+                }
+                for (size_t i = 1; i + 1 < vertexCount; ++i) {
+                    indices.push_back(faceIndices[0]);
+                    indices.push_back(faceIndices[i]);
+                    indices.push_back(faceIndices[i + 1]);
                 }
+                submeshes.back().indexCount = static_cast<uint32_t>(indices.size()) - submeshes.back().firstIndex;
+            }
+        }
+    }
+
+    void computeBounds() {
+        bounds = Bounds{};
+        if (vertices.empty()) {
+            return;
+        }
+
+        bounds.min = { vertices[0].x, vertices[0].y, vertices[0].z };
+        bounds.max = bounds.min;
+        for (const auto& vertex : vertices) {
+            bounds.min = { std::min(bounds.min[0], vertex.x), std::min(bounds.min[1], vertex.y), std::min(bounds.min[2], vertex.z) };
+            bounds.max = { std::max(bounds.max[0], vertex.x), std::max(bounds.max[1], vertex.y), std::max(bounds.max[2], vertex.z) };
+        }
+    }
 
-                vertices.push_back(vertex);
+    // The index buffer is already in Tipsify order, so fixed-size runs of it
+    // are spatially coherent enough to give useful cluster bounds. Each submesh is
+    // split on its own, so a visible cluster range never spans two materials.
+    void buildClusters() {
+        clusters.clear();
+
+        const size_t clusterIndices = TrianglesPerCluster * 3;
+        for (const Submesh& submesh : submeshes) {
+            const size_t end = static_cast<size_t>(submesh.firstIndex) + submesh.indexCount;
+            for (size_t first = submesh.firstIndex; first < end; first += clusterIndices) {
+                addCluster(first, std::min(clusterIndices, end - first));
             }
         }
     }
+
+    void addCluster(size_t first, size_t count) {
+        Cluster cluster{ static_cast<uint32_t>(first), static_cast<uint32_t>(count), Bounds{} };
+        const Vertex& start = vertices[indices[first]];
+        cluster.bounds.min = { start.x, start.y, start.z };
+        cluster.bounds.max = cluster.bounds.min;
+        for (size_t i = first; i < first + count; ++i) {
+            const Vertex& vertex = vertices[indices[i]];
+            cluster.bounds.min = { std::min(cluster.bounds.min[0], vertex.x), std::min(cluster.bounds.min[1], vertex.y), std::min(cluster.bounds.min[2], vertex.z) };
+            cluster.bounds.max = { std::max(cluster.bounds.max[0], vertex.x), std::max(cluster.bounds.max[1], vertex.y), std::max(cluster.bounds.max[2], vertex.z) };
+        }
+
+        clusters.push_back(cluster);
+    }
+
+    // An edge is shared when exactly two triangles use it in opposite directions, as in a
+    // consistently wound surface; everything else stays NoNeighbor.
+    void buildEdgeNeighbors() {
+        edgeNeighbors.assign(indices.size(), NoNeighbor);
+
+        // Position id = first vertex with the same position bits, found in an open-addressed table
+        size_t capacity = 16;
+        while (capacity < vertices.size() * 2) {
+            capacity *= 2;
+        }
+        std::vector<uint32_t> slots(capacity, NoNeighbor);
+        std::vector<uint32_t> positionOf(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            std::array<uint32_t, 3> bits;
+            std::memcpy(bits.data(), &vertices[i].x, sizeof(bits));
+            for (size_t slot = PositionHash{}(bits) & (capacity - 1);; slot = (slot + 1) & (capacity - 1)) {
+                if (slots[slot] == NoNeighbor) {
+                    slots[slot] = static_cast<uint32_t>(i);
+                    positionOf[i] = static_cast<uint32_t>(i);
+                    break;
+                }
+                if (std::memcmp(&vertices[slots[slot]].x, bits.data(), sizeof(bits)) == 0) {
+                    positionOf[i] = slots[slot];
+                    break;
+                }
+            }
+        }
+
+        // Corners bucketed by the smaller position of their edge, then sorted by the larger one,
+        // so every undirected edge is a run of equal keys
+        auto edgeEnds = [&](size_t corner) {
+            const size_t next = corner % 3 == 2 ? corner - 2 : corner + 1;
+            return std::pair<uint32_t, uint32_t>{ positionOf[indices[corner]], positionOf[indices[next]] };
+        };
+        std::vector<uint32_t> bucketStart(vertices.size() + 1, 0);
+        for (size_t corner = 0; corner < indices.size(); ++corner) {
+            const auto [a, b] = edgeEnds(corner);
+            ++bucketStart[std::min(a, b) + 1];
+        }
+        for (size_t i = 1; i < bucketStart.size(); ++i) {
+            bucketStart[i] += bucketStart[i - 1];
+        }
+        std::vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+        std::vector<std::pair<uint32_t, uint32_t>> bucketed(indices.size()); // Larger position, corner
+        for (size_t corner = 0; corner < indices.size(); ++corner) {
+            const auto [a, b] = edgeEnds(corner);
+            bucketed[fill[std::min(a, b)]++] = { std::max(a, b), static_cast<uint32_t>(corner) };
+        }
+
+        for (size_t bucket = 0; bucket + 1 < bucketStart.size(); ++bucket) {
+            auto first = bucketed.begin() + bucketStart[bucket];
+            auto last = bucketed.begin() + bucketStart[bucket + 1];
+            std::sort(first, last);
+            for (auto run = first; run != last;) {
+                auto runEnd = run + 1;
+                while (runEnd != last && runEnd->first == run->first) {
+                    ++runEnd;
+                }
+                // Exactly two uses in opposite directions; degenerate edges never pair up
+                if (runEnd - run == 2 && run->first != bucket) {
+                    const uint32_t corner = run->second;
+                    const uint32_t other = (run + 1)->second;
+                    const auto [a, b] = edgeEnds(corner);
+                    if (edgeEnds(other) == std::pair<uint32_t, uint32_t>{ b, a }) {
+                        edgeNeighbors[corner] = other / 3;
+                        edgeNeighbors[other] = corner / 3;
+                    }
+                }
+                run = runEnd;
+            }
+        }
+    }
+
+    Vertex makeVertex(const VertexKey& key) const {
+        Vertex vertex{};
+
+        if (key.position < positions.size()) {
+            vertex.x = positions[key.position][0];
+            vertex.y = positions[key.position][1];
+            vertex.z = positions[key.position][2];
+        }
+
+        if (key.texCoord < texCoords.size()) {
+            vertex.u = texCoords[key.texCoord][0];
+            vertex.v = texCoords[key.texCoord][1];
+        }
+
+        if (key.normal < normals.size()) {
+            vertex.nx = normals[key.normal][0];
+            vertex.ny = normals[key.normal][1];
+            vertex.nz = normals[key.normal][2];
+        }
+
+        return vertex;
+    }
 };
\ No newline at end of file
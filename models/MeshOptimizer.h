@@ -0,0 +1,432 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+
+// Index buffer reordering for the post-transform vertex cache and overdraw.
+// Vertex cache: Tipsify (Sander, Nehab, Barczak 2007).
+// Overdraw: clusters produced by Tipsify are sorted front-to-back by how much
+// they face away from the mesh centroid, then vertices are reordered by first use.
+class MeshOptimizer {
+public:
+    static constexpr size_t DefaultCacheSize = 16;
+
+    struct Report {
+        size_t triangleCount = 0;
+        size_t vertexCount = 0;
+        size_t cacheSize = DefaultCacheSize;
+        float acmrBefore = 0.0f;
+        float acmrAfter = 0.0f;
+    };
+
+    // Average cache miss ratio of a FIFO cache: transformed vertices per triangle.
+    static float computeACMR(const std::vector<uint32_t>& indices, size_t vertexCount,
+                             size_t cacheSize = DefaultCacheSize) {
+        if (indices.size() < 3) {
+            return 0.0f;
+        }
+
+        std::vector<size_t> timestamps(vertexCount, 0);
+        size_t time = cacheSize + 1;
+        size_t misses = 0;
+
+        for (uint32_t index : indices) {
+            if (time - timestamps[index] > cacheSize) {
+                timestamps[index] = time++;
+                ++misses;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+
+    // Tipsify. clusterOffsets receives the first triangle of every cluster that
+    // starts after a dead end, which is where the overdraw pass may reorder.
+    static std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                                     size_t cacheSize = DefaultCacheSize,
+                                                     std::vector<uint32_t>* clusterOffsets = nullptr) {
+        const size_t triangleCount = indices.size() / 3;
+        std::vector<uint32_t> result;
+        result.reserve(triangleCount * 3);
+
+        if (clusterOffsets) {
+            clusterOffsets->clear();
+        }
+        if (triangleCount == 0 || vertexCount == 0) {
+            return result;
+        }
+
+        // Vertex -> triangle adjacency in compressed rows.
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            ++liveTriangles[indices[i]];
+        }
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+        }
+
+        std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (size_t k = 0; k < 3; ++k) {
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+
+        std::vector<size_t> timestamps(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEndStack;
+        std::vector<uint32_t> candidates;
+
+        size_t time = cacheSize + 1;
+        size_t cursor = 0;
+        int64_t fanningVertex = 0;
+        bool newCluster = true;
+
+        while (fanningVertex >= 0) {
+            candidates.clear();
+
+            const auto fv = static_cast<uint32_t>(fanningVertex);
+            for (uint32_t a = adjacencyOffsets[fv]; a < adjacencyOffsets[fv + 1]; ++a) {
+                uint32_t t = adjacency[a];
+                if (emitted[t]) {
+                    continue;
+                }
+
+                if (newCluster && clusterOffsets) {
+                    clusterOffsets->push_back(static_cast<uint32_t>(result.size() / 3));
+                }
+                newCluster = false;
+
+                for (size_t k = 0; k < 3; ++k) {
+                    uint32_t v = indices[t * 3 + k];
+                    result.push_back(v);
+                    deadEndStack.push_back(v);
+                    candidates.push_back(v);
+                    --liveTriangles[v];
+
+                    if (time - timestamps[v] > cacheSize) {
+                        timestamps[v] = time++;
+                    }
+                }
+                emitted[t] = true;
+            }
+
+            // Prefer a candidate that will still be in the cache once all of its
+            // remaining triangles are emitted, the oldest such one first.
+            int64_t best = -1;
+            size_t bestPriority = 0;
+            for (uint32_t v : candidates) {
+                if (liveTriangles[v] == 0) {
+                    continue;
+                }
+
+                size_t priority = 0;
+                if (time - timestamps[v] + 2 * liveTriangles[v] <= cacheSize) {
+                    priority = time - timestamps[v];
+                }
+                if (best < 0 || priority > bestPriority) {
+                    best = v;
+                    bestPriority = priority;
+                }
+            }
+
+            if (best < 0) {
+                best = skipDeadEnd(liveTriangles, deadEndStack, cursor);
+                newCluster = true;
+            }
+            fanningVertex = best;
+        }
+
+        return result;
+    }
+
+    // Splits the Tipsify clusters further wherever the local miss ratio stays
+    // within `threshold` of the cluster average, then sorts clusters so that the
+    // ones facing outward from the mesh centre are drawn first.
+    template<typename VertexT>
+    static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<VertexT>& vertices,
+                                 const std::vector<uint32_t>& clusterOffsets,
+                                 size_t cacheSize = DefaultCacheSize, float threshold = 1.05f) {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || clusterOffsets.empty()) {
+            return;
+        }
+
+        std::vector<uint32_t> clusters = splitClusters(indices, vertices.size(), clusterOffsets, cacheSize, threshold);
+        const size_t clusterCount = clusters.size();
+
+        struct ClusterInfo {
+            uint32_t begin, end;
+            float centroid[3];
+            float normal[3];
+            float area;
+            float sortKey;
+        };
+
+        std::vector<ClusterInfo> infos(clusterCount);
+        float meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+        float meshArea = 0.0f;
+
+        for (size_t c = 0; c < clusterCount; ++c) {
+            ClusterInfo& info = infos[c];
+            info.begin = clusters[c];
+            info.end = c + 1 < clusterCount ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+            info.centroid[0] = info.centroid[1] = info.centroid[2] = 0.0f;
+            info.normal[0] = info.normal[1] = info.normal[2] = 0.0f;
+            info.area = 0.0f;
+
+            for (uint32_t t = info.begin; t < info.end; ++t) {
+                const VertexT& a = vertices[indices[t * 3 + 0]];
+                const VertexT& b = vertices[indices[t * 3 + 1]];
+                const VertexT& d = vertices[indices[t * 3 + 2]];
+
+                float e1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+                float e2[3] = {d.x - a.x, d.y - a.y, d.z - a.z};
+                float n[3] = {
+                        e1[1] * e2[2] - e1[2] * e2[1],
+                        e1[2] * e2[0] - e1[0] * e2[2],
+                        e1[0] * e2[1] - e1[1] * e2[0]
+                };
+                float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+                info.normal[0] += n[0];
+                info.normal[1] += n[1];
+                info.normal[2] += n[2];
+                info.centroid[0] += (a.x + b.x + d.x) * area / 3.0f;
+                info.centroid[1] += (a.y + b.y + d.y) * area / 3.0f;
+                info.centroid[2] += (a.z + b.z + d.z) * area / 3.0f;
+                info.area += area;
+            }
+
+            for (size_t k = 0; k < 3; ++k) {
+                meshCentroid[k] += info.centroid[k];
+            }
+            meshArea += info.area;
+
+            if (info.area > 0.0f) {
+                for (float& value : info.centroid) {
+                    value /= info.area;
+                }
+            }
+
+            float length = std::sqrt(info.normal[0] * info.normal[0] +
+                                     info.normal[1] * info.normal[1] +
+                                     info.normal[2] * info.normal[2]);
+            if (length > 0.0f) {
+                for (float& value : info.normal) {
+                    value /= length;
+                }
+            }
+        }
+
+        if (meshArea > 0.0f) {
+            for (float& value : meshCentroid) {
+                value /= meshArea;
+            }
+        }
+
+        for (auto& info : infos) {
+            info.sortKey = (info.centroid[0] - meshCentroid[0]) * info.normal[0] +
+                           (info.centroid[1] - meshCentroid[1]) * info.normal[1] +
+                           (info.centroid[2] - meshCentroid[2]) * info.normal[2];
+        }
+
+        std::stable_sort(infos.begin(), infos.end(), [](const ClusterInfo& lhs, const ClusterInfo& rhs) {
+            return lhs.sortKey > rhs.sortKey;
+        });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (const auto& info : infos) {
+            result.insert(result.end(), indices.begin() + info.begin * 3, indices.begin() + info.end * 3);
+        }
+        indices.swap(result);
+    }
+
+    // Reorders vertices by first use in the index buffer and drops unreferenced ones.
+    template<typename VertexT>
+    static void optimizeVertexFetch(std::vector<VertexT>& vertices, std::vector<uint32_t>& indices) {
+        constexpr uint32_t unused = ~0u;
+        std::vector<uint32_t> remap(vertices.size(), unused);
+        std::vector<VertexT> result;
+        result.reserve(vertices.size());
+
+        for (uint32_t& index : indices) {
+            if (remap[index] == unused) {
+                remap[index] = static_cast<uint32_t>(result.size());
+                result.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        vertices.swap(result);
+    }
+
+    // Runs the full pass: vertex cache, overdraw, vertex fetch. The triangle order is only
+    // replaced when its ACMR beats the input's, so acmrAfter never exceeds acmrBefore.
+    template<typename VertexT>
+    static Report optimize(std::vector<VertexT>& vertices, std::vector<uint32_t>& indices,
+                           size_t cacheSize = DefaultCacheSize) {
+        Report report;
+        report.triangleCount = indices.size() / 3;
+        report.cacheSize = cacheSize;
+        report.acmrBefore = computeACMR(indices, vertices.size(), cacheSize);
+
+        std::vector<uint32_t> clusters;
+        std::vector<uint32_t> reordered = optimizeVertexCache(indices, vertices.size(), cacheSize, &clusters);
+        optimizeOverdraw(reordered, vertices, clusters, cacheSize);
+        if (computeACMR(reordered, vertices.size(), cacheSize) < report.acmrBefore) {
+            indices.swap(reordered);
+        }
+        optimizeVertexFetch(vertices, indices);
+
+        report.vertexCount = vertices.size();
+        report.acmrAfter = computeACMR(indices, vertices.size(), cacheSize);
+        return report;
+    }
+
+    // The same pass on each index range separately, so no triangle moves across a range
+    // border. rangeStarts holds the first index of every range in ascending order, from 0.
+    // Ranges are optimized over a compact local numbering: the cost follows the range size,
+    // not the mesh size, however many ranges there are. A range keeps its input order unless
+    // the reordered one has a lower ACMR, and so does the whole mesh, since the cache carries
+    // over range borders.
+    template<typename VertexT>
+    static Report optimize(std::vector<VertexT>& vertices, std::vector<uint32_t>& indices,
+                           const std::vector<uint32_t>& rangeStarts, size_t cacheSize = DefaultCacheSize) {
+        if (rangeStarts.size() <= 1) {
+            return optimize(vertices, indices, cacheSize);
+        }
+
+        Report report;
+        report.triangleCount = indices.size() / 3;
+        report.cacheSize = cacheSize;
+        report.acmrBefore = computeACMR(indices, vertices.size(), cacheSize);
+
+        const std::vector<uint32_t> input = indices;
+        constexpr uint32_t unused = ~0u;
+        std::vector<uint32_t> localIndex(vertices.size(), unused);
+        std::vector<uint32_t> globalIndex;
+        std::vector<VertexT> localVertices;
+        std::vector<uint32_t> range;
+        std::vector<uint32_t> reordered;
+        std::vector<uint32_t> clusters;
+        for (size_t r = 0; r < rangeStarts.size(); ++r) {
+            const size_t begin = rangeStarts[r];
+            const size_t end = r + 1 < rangeStarts.size() ? rangeStarts[r + 1] : indices.size();
+
+            range.assign(indices.begin() + begin, indices.begin() + end);
+            globalIndex.clear();
+            localVertices.clear();
+            for (uint32_t& index : range) {
+                if (localIndex[index] == unused) {
+                    localIndex[index] = static_cast<uint32_t>(globalIndex.size());
+                    globalIndex.push_back(index);
+                    localVertices.push_back(vertices[index]);
+                }
+                index = localIndex[index];
+            }
+
+            reordered = optimizeVertexCache(range, localVertices.size(), cacheSize, &clusters);
+            optimizeOverdraw(reordered, localVertices, clusters, cacheSize);
+            if (computeACMR(reordered, localVertices.size(), cacheSize) < computeACMR(range, localVertices.size(), cacheSize)) {
+                for (size_t i = 0; i < reordered.size(); ++i) {
+                    indices[begin + i] = globalIndex[reordered[i]];
+                }
+            }
+            for (uint32_t index : globalIndex) {
+                localIndex[index] = unused;
+            }
+        }
+        if (computeACMR(indices, vertices.size(), cacheSize) >= report.acmrBefore) {
+            indices = input;
+        }
+        optimizeVertexFetch(vertices, indices);
+
+        report.vertexCount = vertices.size();
+        report.acmrAfter = computeACMR(indices, vertices.size(), cacheSize);
+        return report;
+    }
+
+private:
+    static int64_t skipDeadEnd(const std::vector<uint32_t>& liveTriangles, std::vector<uint32_t>& deadEndStack,
+                               size_t& cursor) {
+        while (!deadEndStack.empty()) {
+            uint32_t v = deadEndStack.back();
+            deadEndStack.pop_back();
+            if (liveTriangles[v] > 0) {
+                return v;
+            }
+        }
+
+        while (cursor < liveTriangles.size()) {
+            if (liveTriangles[cursor] > 0) {
+                return static_cast<int64_t>(cursor);
+            }
+            ++cursor;
+        }
+
+        return -1;
+    }
+
+    static std::vector<uint32_t> splitClusters(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                               const std::vector<uint32_t>& hardOffsets,
+                                               size_t cacheSize, float threshold) {
+        const size_t triangleCount = indices.size() / 3;
+        std::vector<uint32_t> result;
+        std::vector<size_t> timestamps(vertexCount, 0);
+        size_t time = cacheSize + 1;
+
+        auto simulate = [&](uint32_t t) {
+            size_t misses = 0;
+            for (size_t k = 0; k < 3; ++k) {
+                uint32_t v = indices[t * 3 + k];
+                if (time - timestamps[v] > cacheSize) {
+                    timestamps[v] = time++;
+                    ++misses;
+                }
+            }
+            return misses;
+        };
+        auto flush = [&]() { time += cacheSize + 1; };
+
+        for (size_t c = 0; c < hardOffsets.size(); ++c) {
+            uint32_t begin = hardOffsets[c];
+            uint32_t end = c + 1 < hardOffsets.size() ? hardOffsets[c + 1] : static_cast<uint32_t>(triangleCount);
+
+            flush();
+            size_t clusterMisses = 0;
+            for (uint32_t t = begin; t < end; ++t) {
+                clusterMisses += simulate(t);
+            }
+            float limit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+            result.push_back(begin);
+            flush();
+            size_t misses = 0;
+            uint32_t start = begin;
+            for (uint32_t t = begin; t < end; ++t) {
+                misses += simulate(t);
+                if (t + 1 < end && static_cast<float>(misses) <= limit * static_cast<float>(t - start + 1)) {
+                    result.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    flush();
+                }
+            }
+        }
+
+        return result;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const MeshOptimizer::Report& report) {
+    return os << "triangles: " << report.triangleCount
+              << ", vertices: " << report.vertexCount
+              << ", ACMR(" << report.cacheSize << "): " << report.acmrBefore << " -> " << report.acmrAfter;
+}
@@ -2,12 +2,18 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <algorithm>
 #include "Mesh.h"
+#include "MaterialLibrary.h"
+#include "Texture.h"
 
 class Model3D {
 protected:
     std::vector<std::shared_ptr<Mesh>> meshes;
     std::string name;
+    MaterialLibrary materials;
+    std::vector<std::string> materialLibraries;
+    std::vector<std::shared_ptr<const Texture>> textures; // By material id, null when untextured
 
 public:
     explicit Model3D(std::string modelName) : name(std::move(modelName)) {}
@@ -18,4 +24,46 @@ public:
 	void addMesh(std::shared_ptr<Mesh> mesh) {
 		meshes.push_back(std::move(mesh));
 	}
+
+    // Ids used by the mesh submeshes; properties arrive once the libraries are loaded.
+    MaterialLibrary& getMaterials() { return materials; }
+    const MaterialLibrary& getMaterials() const { return materials; }
+
+    // mtllib entries as written in the file, relative to the model.
+    const std::vector<std::string>& getMaterialLibraries() const { return materialLibraries; }
+    void addMaterialLibrary(std::string libraryPath) {
+        materialLibraries.push_back(std::move(libraryPath));
+    }
+
+    // Diffuse map of a material (map_Kd), nullptr if it has none or it could not be loaded.
+    const Texture* getTexture(uint32_t material) const {
+        return material < textures.size() ? textures[material].get() : nullptr;
+    }
+    void setTexture(uint32_t material, std::shared_ptr<const Texture> texture) {
+        if (material >= textures.size()) {
+            textures.resize(material + 1);
+        }
+        textures[material] = std::move(texture);
+    }
+    bool hasTextures() const {
+        return std::any_of(textures.begin(), textures.end(), [](const auto& texture) { return texture != nullptr; });
+    }
+
+    // Union of the mesh bounds; zero box when there is no geometry.
+    Mesh::Bounds computeBounds() const {
+        Mesh::Bounds result;
+        bool first = true;
+        for (const auto& mesh : meshes) {
+            if (mesh->getVertexCount() == 0) {
+                continue;
+            }
+            const auto& bounds = mesh->getBounds();
+            for (size_t axis = 0; axis < 3; ++axis) {
+                result.min[axis] = first ? bounds.min[axis] : std::min(result.min[axis], bounds.min[axis]);
+                result.max[axis] = first ? bounds.max[axis] : std::max(result.max[axis], bounds.max[axis]);
+            }
+            first = false;
+        }
+        return result;
+    }
 };
@@ -1,5 +1,68 @@
 #include "ModelLoader.h"
 #include "ObjLoader.h"
+#include "../core/AsyncFileReader.h"
+#include "../core/DecompressingFileStream.h"
+#include "../model/obj/MTLParser.h"
+#include <filesystem>
+
+std::shared_ptr<Model3D> ModelLoader::loadModel(const std::string& filePath) {
+    OBJVIEWER_TRACE_SCOPE("ModelLoader::loadModel");
+    auto file = openStream(filePath);
+    LoadArena arena;
+    auto model = parseModel(*file, modelName(filePath), &arena);
+    loadMaterialLibraries(*model, filePath);
+    processMeshes(*model, JobSystem::global());
+    releaseAttributes(*model);
+    return model;
+}
+
+std::unique_ptr<std::istream> ModelLoader::openStream(const std::string& filePath) {
+    if (DecompressingFileStream::detectFormat(filePath) != DecompressingFileStream::Format::None) {
+        auto stream = std::make_unique<DecompressingFileStream>(filePath);
+        if (!stream->is_open()) {
+            throw std::runtime_error("Failed to open file: " + filePath);
+        }
+        return stream;
+    }
+
+    // Read-ahead: the next blocks are read while the parser works on the current one
+    auto stream = std::make_unique<AsyncFileStream>(filePath);
+    if (!stream->is_open()) {
+        throw std::runtime_error("Failed to open file: " + filePath);
+    }
+    return stream;
+}
+
+std::string ModelLoader::modelName(const std::string& filePath) {
+    return std::filesystem::path(DecompressingFileStream::stripCompressionSuffix(filePath)).stem().string();
+}
+
+void ModelLoader::loadMaterialLibraries(Model3D& model, const std::string& filePath) {
+    OBJVIEWER_TRACE_SCOPE("ModelLoader::loadMaterialLibraries");
+    const auto directory = std::filesystem::path(filePath).parent_path();
+    for (const auto& library : model.getMaterialLibraries()) {
+        const auto libraryPath = directory / library;
+        if (auto materials = MTLParser::loadMaterials(libraryPath.string())) {
+            for (auto& material : *materials) {
+                // map_Kd is relative to the library, which may sit in another directory than the model
+                if (!material.textureMap.empty()) {
+                    material.textureMap = (libraryPath.parent_path() / material.textureMap).lexically_normal().string();
+                }
+                model.getMaterials().define(material);
+            }
+        }
+    }
+}
+
+void ModelLoader::processMeshes(const Model3D& model, JobSystem& jobs) {
+    OBJVIEWER_TRACE_SCOPE("ModelLoader::processMeshes");
+    const auto& meshes = model.getMeshes();
+    jobs.parallelFor(0, meshes.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            processMesh(*meshes[i]);
+        }
+    });
+}
 
 std::shared_ptr<ModelLoader> ModelLoader::createLoader(const std::string& extension) {
     auto objLoader = std::make_shared<ObjLoader>();
@@ -8,4 +71,9 @@ std::shared_ptr<ModelLoader> ModelLoader::createLoader(const std::string& extens
     }
 
     throw std::runtime_error("Unsupported file extension: " + extension);
+}
+
+std::shared_ptr<ModelLoader> ModelLoader::createLoaderForFile(const std::string& filePath) {
+    auto sourcePath = DecompressingFileStream::stripCompressionSuffix(filePath);
+    return createLoader(std::filesystem::path(sourcePath).extension().string());
 }
\ No newline at end of file
@@ -1,14 +1,67 @@
 #pragma once
 #include <memory>
+#include <istream>
+#include <memory_resource>
 #include "Model3D.h"
+#include "../core/JobSystem.h"
+#include "../core/Trace.h"
 
 class ModelLoader {
 public:
     virtual ~ModelLoader() = default;
 
-    virtual std::shared_ptr<Model3D> loadModel(const std::string& filePath) = 0;
+    // Reads the file, parses it and processes the meshes on the job system.
+    virtual std::shared_ptr<Model3D> loadModel(const std::string& filePath);
+
+    // Parsing stage only: the returned meshes still need processMesh(). Raw attributes and
+    // parser scratch come from arena; the meshes must be processed and their attributes released
+    // (releaseAttributes) before the arena is destroyed.
+    virtual std::shared_ptr<Model3D> parseModel(std::istream& stream, const std::string& modelName,
+                                                std::pmr::memory_resource* arena) = 0;
+
+    // Same on the default heap resource, for callers that keep the raw faces.
+    std::shared_ptr<Model3D> parseModel(std::istream& stream, const std::string& modelName) {
+        return parseModel(stream, modelName, std::pmr::get_default_resource());
+    }
+
+    // One monotonic arena per load: everything the parser allocates is freed in one shot
+    // when the load returns. The first block is sized for a small model and grows geometrically.
+    class LoadArena : public std::pmr::monotonic_buffer_resource {
+    public:
+        LoadArena() : std::pmr::monotonic_buffer_resource(1 << 20) {}
+    };
+
+    // Drops the raw attributes of every mesh; call once processing is done, before the arena goes.
+    static void releaseAttributes(const Model3D& model) {
+        for (const auto& mesh : model.getMeshes()) {
+            mesh->releaseAttributes();
+        }
+    }
+
+    // Welding, cache optimization, bounds and clusters for one parsed mesh.
+    static void processMesh(Mesh& mesh) {
+        OBJVIEWER_TRACE_SCOPE("ModelLoader::processMesh");
+        mesh.processVertices();
+    }
+
+    static void processMeshes(const Model3D& model, JobSystem& jobs);
+
+    // Fills in the properties of the model's materials from its mtllib files, looked up next
+    // to filePath. Ids stay as parsing assigned them; materials only defined in a library are
+    // appended. Missing libraries leave their materials at the defaults. Texture maps are
+    // resolved against the directory of their library.
+    static void loadMaterialLibraries(Model3D& model, const std::string& filePath);
 
     virtual bool supportsExtension(const std::string& extension) const = 0;
 
     static std::shared_ptr<ModelLoader> createLoader(const std::string& extension);
+
+    // Picks the loader by the inner extension, so model.obj.gz gets the OBJ loader.
+    static std::shared_ptr<ModelLoader> createLoaderForFile(const std::string& filePath);
+
+    // Read-ahead stream over the file; .gz/.zst are decompressed on a separate thread.
+    static std::unique_ptr<std::istream> openStream(const std::string& filePath);
+
+    // File stem without the compression suffix: models/cube.obj.gz -> cube.
+    static std::string modelName(const std::string& filePath);
 };
\ No newline at end of file
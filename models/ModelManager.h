@@ -1,35 +1,229 @@
 #pragma once
 
 #include "ModelLoader.h"
+#include "TextureCache.h"
+#include "../core/JobSystem.h"
+#include "../core/Task.h"
+#include "../core/AsyncFileReader.h"
+#include "../core/DecompressingFileStream.h"
 #include <unordered_map>
 #include <filesystem>
+#include <sstream>
+#include <mutex>
+#include <vector>
 
 class ModelManager {
+public:
+    // Threads that only wait on the disk for loadAsync, started by its first call. Two keep
+    // a read in flight while another load's read is being handed back to the pool.
+    static constexpr unsigned ReadThreads = 2;
+
 private:
     std::unordered_map<std::string, std::shared_ptr<Model3D>> loadedModels;
+    bool compressVertices = false;
+    std::mutex cacheMutex;
+    JobSystem& jobs;
+    std::unique_ptr<JobSystem> reads;
+    std::once_flag readsStarted;
+    TextureCache textures;
+
+    JobSystem& readThreads() {
+        std::call_once(readsStarted, [this] { reads = std::make_unique<JobSystem>(ReadThreads); });
+        return *reads;
+    }
+
+    std::shared_ptr<Model3D> findCached(const std::string& filePath) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = loadedModels.find(filePath);
+        return it != loadedModels.end() ? it->second : nullptr;
+    }
+
+    std::shared_ptr<Model3D> addToCache(const std::string& filePath, std::shared_ptr<Model3D> model) {
+        if (compressVertices) {
+            OBJVIEWER_TRACE_SCOPE("ModelManager::compressVertices");
+            const auto& meshes = model->getMeshes();
+            jobs.parallelFor(0, meshes.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    meshes[i]->compress();
+                }
+            });
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return loadedModels.try_emplace(filePath, std::move(model)).first->second;
+    }
+
+    static std::string readFile(const std::string& filePath) {
+        OBJVIEWER_TRACE_SCOPE("ModelManager::readFile");
+        AsyncFileReader reader(filePath);
+        std::string contents;
+        std::error_code error;
+        auto size = std::filesystem::file_size(filePath, error);
+        if (!error) {
+            contents.reserve(static_cast<size_t>(size));
+        }
+        for (auto block = reader.next(); !block.empty(); block = reader.next()) {
+            contents.append(block);
+        }
+        return contents;
+    }
+
+    static Task<> processMeshAsync(JobSystem& jobs, std::shared_ptr<Mesh> mesh) {
+        co_await jobs.schedule();
+        ModelLoader::processMesh(*mesh);
+    }
+
+    // Diffuse maps of the model's materials through the shared cache, decoded in parallel.
+    // A texture that fails to load leaves its material untextured.
+    void loadTextures(Model3D& model) {
+        OBJVIEWER_TRACE_SCOPE("ModelManager::loadTextures");
+        const auto& materials = model.getMaterials();
+        std::vector<uint32_t> ids;
+        std::vector<std::string> paths;
+        for (uint32_t id = 0; id < materials.size(); ++id) {
+            if (!materials.get(id).textureMap.empty()) {
+                ids.push_back(id);
+                paths.push_back(materials.get(id).textureMap);
+            }
+        }
+        auto loaded = textures.loadAll(paths);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            model.setTexture(ids[i], std::move(loaded[i]));
+        }
+    }
+
+    Task<> loadTexturesAsync(std::shared_ptr<Model3D> model) {
+        co_await jobs.schedule();
+        loadTextures(*model);
+    }
 
 public:
-    ModelManager() = default;
+    explicit ModelManager(JobSystem& jobSystem = JobSystem::global())
+        : jobs(jobSystem), textures(TextureCache::DefaultBudgetBytes, jobSystem) {}
 
+    // Safe to call from several threads; the file is parsed outside the lock.
     std::shared_ptr<Model3D> loadModel(const std::string& filePath) {
+        OBJVIEWER_TRACE_SCOPE("ModelManager::loadModel");
+        if (auto cached = findCached(filePath)) {
+            return cached;
+        }
+
+        auto loader = ModelLoader::createLoaderForFile(filePath);
 
-        if (loadedModels.find(filePath) != loadedModels.end()) {
-            return loadedModels[filePath];
+        auto model = loader->loadModel(filePath);
+        loadTextures(*model);
+
+        return addToCache(filePath, std::move(model));
+    }
+
+    // co_await manager.loadAsync(path). Reading, parsing, per-mesh processing and cache
+    // population are separate jobs, so many loads in flight interleave on the pool
+    // instead of each one holding a thread from start to finish. The read blocks until
+    // EOF, so it runs on the read threads and the pool keeps parsing other models meanwhile.
+    Task<std::shared_ptr<Model3D>> loadAsync(std::string filePath) {
+        if (auto cached = findCached(filePath)) {
+            co_return cached;
         }
 
-        std::filesystem::path path(filePath);
-        std::string extension = path.extension().string();
+        auto loader = ModelLoader::createLoaderForFile(filePath);
+        // Lives in the coroutine frame; only the parse job allocates from it. Declared before
+        // model so that, if a later stage throws, the meshes' raw attributes are freed first
+        ModelLoader::LoadArena arena;
+        std::shared_ptr<Model3D> model;
 
-        auto loader = ModelLoader::createLoader(extension);
+        if (DecompressingFileStream::detectFormat(filePath) != DecompressingFileStream::Format::None) {
+            // Compressed input is parsed as it is inflated instead of being buffered whole;
+            // inflating keeps the thread busy, so this stays on the pool
+            co_await jobs.schedule();
+            auto stream = ModelLoader::openStream(filePath);
+            model = loader->parseModel(*stream, ModelLoader::modelName(filePath), &arena);
+        } else {
+            co_await readThreads().schedule();
+            std::string contents = readFile(filePath);
 
-        auto model = loader->loadModel(filePath);
+            co_await jobs.schedule();
+            std::istringstream stream(std::move(contents));
+            model = loader->parseModel(stream, ModelLoader::modelName(filePath), &arena);
+        }
 
-        loadedModels[filePath] = model;
+        ModelLoader::loadMaterialLibraries(*model, filePath);
 
-        return model;
+        // Textures decode alongside mesh processing; they touch disjoint parts of the model
+        std::vector<Task<>> meshTasks;
+        meshTasks.push_back(loadTexturesAsync(model));
+        for (const auto& mesh : model->getMeshes()) {
+            meshTasks.push_back(processMeshAsync(jobs, mesh));
+        }
+        co_await whenAll(jobs, std::move(meshTasks));
+        ModelLoader::releaseAttributes(*model);
+
+        co_return addToCache(filePath, std::move(model));
+    }
+
+    // Loads all files concurrently; results follow the order of filePaths.
+    Task<std::vector<std::shared_ptr<Model3D>>> loadAllAsync(std::vector<std::string> filePaths) {
+        std::vector<Task<std::shared_ptr<Model3D>>> loads;
+        loads.reserve(filePaths.size());
+        for (auto& filePath : filePaths) {
+            loads.push_back(loadAsync(std::move(filePath)));
+        }
+        co_return co_await whenAll(jobs, std::move(loads));
+    }
+
+    // Loads several files in parallel on the job system; results follow the order of filePaths.
+    // The first failure is rethrown after all loads have finished.
+    std::vector<std::shared_ptr<Model3D>> loadModels(const std::vector<std::string>& filePaths) {
+        std::vector<std::shared_ptr<Model3D>> models(filePaths.size());
+        jobs.parallelFor(0, filePaths.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                models[i] = loadModel(filePaths[i]);
+            }
+        });
+        return models;
+    }
+
+    // Drops one model from the cache, e.g. after a batch job is done with it.
+    void releaseModel(const std::string& filePath) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        loadedModels.erase(filePath);
+    }
+
+    // Decoded textures shared by all models of this manager.
+    TextureCache& getTextureCache() { return textures; }
+
+    // Store newly loaded meshes in the quantized Mesh::PackedVertex format.
+    void setCompressVertices(bool enabled) {
+        compressVertices = enabled;
+    }
+
+    struct CacheMemory {
+        size_t models = 0;
+        size_t meshes = 0;
+        size_t bytes = 0; // Mesh buffers of cached models, also counted in MemoryStats under the mesh tags
+        size_t textures = 0;
+        size_t textureBytes = 0; // Held by the texture cache; textures evicted but still used by models are not included
+    };
+
+    CacheMemory getCacheMemory() {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        CacheMemory usage;
+        usage.models = loadedModels.size();
+        for (const auto& [path, model] : loadedModels) {
+            for (const auto& mesh : model->getMeshes()) {
+                ++usage.meshes;
+                usage.bytes += mesh->getMemoryBytes();
+            }
+        }
+        usage.textures = textures.getTextureCount();
+        usage.textureBytes = textures.getCachedBytes();
+        return usage;
     }
 
     void clearCache() {
-        loadedModels.clear();
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            loadedModels.clear();
+        }
+        textures.clear();
     }
 };
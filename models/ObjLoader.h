@@ -1,76 +1,170 @@
 #pragma once
 
 #include "ModelLoader.h"
-#include <filesystem>
-#include <fstream>  
-#include <sstream>  
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
 class ObjLoader : public ModelLoader {
+private:
+    static constexpr const char* Whitespace = " \t\r\f\v";
+
+    // Next whitespace-separated token of rest; empty at the end of the line.
+    static std::string_view nextToken(std::string_view& rest) {
+        const size_t start = rest.find_first_not_of(Whitespace);
+        if (start == std::string_view::npos) {
+            rest = {};
+            return {};
+        }
+        const size_t end = rest.find_first_of(Whitespace, start);
+        std::string_view token = rest.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+        rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end);
+        return token;
+    }
+
+    static bool parseFloat(std::string_view& rest, float& value) {
+        std::string_view token = nextToken(rest);
+        if (!token.empty() && token.front() == '+') {
+            token.remove_prefix(1);
+        }
+        return !token.empty() && std::from_chars(token.data(), token.data() + token.size(), value).ec == std::errc();
+    }
+
+    // OBJ index to a zero-based index into the count elements read so far: 1 is the first,
+    // -1 the most recent.
+    static size_t parseIndex(std::string_view token, size_t count) {
+        if (!token.empty() && token.front() == '+') {
+            token.remove_prefix(1);
+        }
+        long long value = 0;
+        auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (error != std::errc() || end == token.data()) {
+            throw std::runtime_error("Invalid face index: " + std::string(token));
+        }
+        const long long index = value < 0 ? static_cast<long long>(count) + value : value - 1;
+        if (value == 0 || index < 0 || index >= static_cast<long long>(count)) {
+            throw std::runtime_error("Face index out of range: " + std::string(token));
+        }
+        return static_cast<size_t>(index);
+    }
+
+    // File-wide attribute array. Face indices are global across o/g, so every mesh copies in
+    // the elements its faces use, numbered in its own order; slots maps a global index to
+    // the copy in the mesh that last used it.
+    template<size_t N>
+    struct AttributePool {
+        struct Slot {
+            uint32_t mesh;
+            uint32_t local;
+        };
+
+        std::pmr::vector<std::array<float, N>> values;
+        std::pmr::vector<Slot> slots;
+        uint32_t localCount = 0;
+
+        explicit AttributePool(std::pmr::memory_resource* arena) : values(arena), slots(arena) {}
+
+        void add(const std::array<float, N>& value) {
+            values.push_back(value);
+            slots.push_back({ NoMesh, 0 });
+        }
+
+        template<typename AddToMesh>
+        size_t resolve(std::string_view token, uint32_t mesh, AddToMesh&& addToMesh) {
+            const size_t index = parseIndex(token, values.size());
+            Slot& slot = slots[index];
+            if (slot.mesh != mesh) {
+                slot = { mesh, localCount++ };
+                addToMesh(values[index]);
+            }
+            return slot.local;
+        }
+    };
+
+    static constexpr uint32_t NoMesh = ~0u;
+
 public:
+    using ModelLoader::parseModel;
+
     bool supportsExtension(const std::string& extension) const override {
         return extension == ".obj";
     }
 
-    std::shared_ptr<Model3D> loadModel(const std::string& filePath) override {
-        std::ifstream file(filePath);
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open file: " + filePath);
-        }
+    // Lines are tokenized in place with string_view and from_chars, and the face scratch is
+    // reused, so the only per-element allocations are the arrays growing inside arena.
+    // usemtl interns the name into the model's MaterialLibrary and marks a switch point in
+    // the current mesh; repeating the current material costs one string compare.
+    std::shared_ptr<Model3D> parseModel(std::istream& file, const std::string& modelName,
+                                        std::pmr::memory_resource* arena) override {
+        OBJVIEWER_TRACE_SCOPE("ObjLoader::parseModel");
+        auto model = std::make_shared<Model3D>(modelName);
+        auto currentMesh = std::make_shared<Mesh>("default", arena);
+        uint32_t meshNumber = 0;
+        std::pmr::vector<std::shared_ptr<Mesh>> meshes(arena);
 
-        std::filesystem::path path(filePath);
-        std::string modelName = path.stem().string();
+        AttributePool<3> positions(arena);
+        AttributePool<3> normals(arena);
+        AttributePool<2> texCoords(arena);
 
-        auto model = std::make_shared<Model3D>(modelName);
-        auto currentMesh = std::make_shared<Mesh>("default");
+        std::pmr::string materialName(arena);
+        uint32_t material = MaterialLibrary::DefaultMaterial;
 
-        std::string line;
+        std::pmr::string line(arena);
+        Mesh::Face face;
         while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string token;
-            iss >> token;
+            std::string_view rest = line;
+            const std::string_view token = nextToken(rest);
 
             if (token == "v") {
                 float x, y, z;
-                if (iss >> x >> y >> z) {
-                    currentMesh->addPosition(x, y, z);
+                if (parseFloat(rest, x) && parseFloat(rest, y) && parseFloat(rest, z)) {
+                    positions.add({ x, y, z });
                 }
             }
-            else if (token == "vn") {  
+            else if (token == "vn") {
                 float nx, ny, nz;
-                if (iss >> nx >> ny >> nz) {
-                    currentMesh->addNormal(nx, ny, nz);
+                if (parseFloat(rest, nx) && parseFloat(rest, ny) && parseFloat(rest, nz)) {
+                    normals.add({ nx, ny, nz });
                 }
             }
             else if (token == "vt") {
                 float u, v;
-                if (iss >> u >> v) {
-                    currentMesh->addTexCoord(u, v);
+                if (parseFloat(rest, u) && parseFloat(rest, v)) {
+                    texCoords.add({ u, v });
                 }
             }
             else if (token == "f") {
-                Mesh::Face face;
-                std::string vertexData;
-
-                while (iss >> vertexData) {
-                    std::istringstream vertexStream(vertexData);
-                    std::string indexStr;
+                face.vertexIndices.clear();
+                face.texCoordIndices.clear();
+                face.normalIndices.clear();
 
-                    if (std::getline(vertexStream, indexStr, '/')) {
-                        if (!indexStr.empty()) {
-                            face.vertexIndices.push_back(std::stoul(indexStr) - 1);
-                        }
+                for (std::string_view vertexData = nextToken(rest); !vertexData.empty(); vertexData = nextToken(rest)) {
+                    // v, v/vt, v//vn or v/vt/vn; empty parts are skipped
+                    std::array<std::string_view, 3> parts{};
+                    for (size_t part = 0; part < parts.size() && !vertexData.empty(); ++part) {
+                        const size_t slash = vertexData.find('/');
+                        parts[part] = vertexData.substr(0, slash);
+                        vertexData = slash == std::string_view::npos ? std::string_view{} : vertexData.substr(slash + 1);
                     }
 
-                    if (std::getline(vertexStream, indexStr, '/')) {
-                        if (!indexStr.empty()) {
-                            face.texCoordIndices.push_back(std::stoul(indexStr) - 1);
-                        }
+                    Mesh& mesh = *currentMesh;
+                    if (!parts[0].empty()) {
+                        face.vertexIndices.push_back(positions.resolve(parts[0], meshNumber, [&](const auto& p) {
+                            mesh.addPosition(p[0], p[1], p[2]);
+                        }));
                     }
-
-                    if (std::getline(vertexStream, indexStr, '/')) {
-                        if (!indexStr.empty()) {
-                            face.normalIndices.push_back(std::stoul(indexStr) - 1);
-                        }
+                    if (!parts[1].empty()) {
+                        face.texCoordIndices.push_back(texCoords.resolve(parts[1], meshNumber, [&](const auto& t) {
+                            mesh.addTexCoord(t[0], t[1]);
+                        }));
+                    }
+                    if (!parts[2].empty()) {
+                        face.normalIndices.push_back(normals.resolve(parts[2], meshNumber, [&](const auto& n) {
+                            mesh.addNormal(n[0], n[1], n[2]);
+                        }));
                     }
                 }
 
@@ -78,24 +172,42 @@ public:
                     currentMesh->addFace(face);
                 }
             }
+            else if (token == "usemtl") {
+                const std::string_view name = nextToken(rest);
+                if (name != materialName) {
+                    materialName = name;
+                    material = name.empty() ? MaterialLibrary::DefaultMaterial : model->getMaterials().intern(name);
+                    currentMesh->setMaterial(material);
+                }
+            }
+            else if (token == "mtllib") {
+                for (std::string_view library = nextToken(rest); !library.empty(); library = nextToken(rest)) {
+                    model->addMaterialLibrary(std::string(library));
+                }
+            }
             else if (token == "o" || token == "g") {
-                if (!currentMesh->getFaces().empty()) {
-                    currentMesh->processVertices();
-                    model->addMesh(currentMesh);
+                if (currentMesh->getFaceCount() != 0) {
+                    meshes.push_back(currentMesh);
                 }
 
-                std::string meshName;
-                iss >> meshName;
+                std::string meshName(nextToken(rest));
                 if (meshName.empty()) {
-                    meshName = "unnamed_" + std::to_string(model->getMeshes().size());
+                    meshName = "unnamed_" + std::to_string(meshes.size());
                 }
-                currentMesh = std::make_shared<Mesh>(meshName);
+                // A new mesh starts with an empty local numbering and keeps the current material
+                currentMesh = std::make_shared<Mesh>(std::move(meshName), arena);
+                currentMesh->setMaterial(material);
+                positions.localCount = normals.localCount = texCoords.localCount = 0;
+                ++meshNumber;
             }
         }
 
-        if (!currentMesh->getFaces().empty()) {
-            currentMesh->processVertices();
-            model->addMesh(currentMesh);
+        if (currentMesh->getFaceCount() != 0) {
+            meshes.push_back(currentMesh);
+        }
+
+        for (const auto& mesh : meshes) {
+            model->addMesh(mesh);
         }
 
         return model;
@@ -0,0 +1,138 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "../core/MemoryStats.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define OBJVIEWER_TEXTURE_SSE
+#include <emmintrin.h>
+#endif
+
+// Decoded RGBA8 image with its whole mip chain in one buffer, level 0 first.
+// Rows run bottom to top, as OBJ texture coordinates and glTexImage2D expect.
+class Texture {
+public:
+    struct Level {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        size_t offset = 0; // Bytes into getData()
+    };
+
+private:
+    std::vector<uint8_t> pixels;
+    std::vector<Level> levels;
+    uint64_t contentHash = 0;
+    MemoryAccount memory{MemoryTag::Textures};
+
+    static uint8_t average(const uint8_t* a, const uint8_t* b, const uint8_t* c, const uint8_t* d, size_t channel) {
+        return static_cast<uint8_t>((a[channel] + b[channel] + c[channel] + d[channel] + 2) >> 2);
+    }
+
+    // Output columns [begin, end) of one row
+    static void downsampleRow(const uint8_t* row0, const uint8_t* row1, uint32_t width, uint8_t* out, uint32_t begin, uint32_t end) {
+        for (uint32_t x = begin; x < end; ++x) {
+            const uint32_t x0 = 2 * x;
+            const uint32_t x1 = std::min(x0 + 1, width - 1);
+            for (size_t channel = 0; channel < 4; ++channel) {
+                out[x * 4 + channel] = average(row0 + x0 * 4, row0 + x1 * 4, row1 + x0 * 4, row1 + x1 * 4, channel);
+            }
+        }
+    }
+
+public:
+    // rgba holds width * height pixels; the mip levels are generated here.
+    Texture(uint32_t width, uint32_t height, std::vector<uint8_t> rgba, uint64_t hash) : pixels(std::move(rgba)), contentHash(hash) {
+        size_t total = 0;
+        for (uint32_t w = width, h = height;; w = std::max(w / 2, 1u), h = std::max(h / 2, 1u)) {
+            levels.push_back({w, h, total});
+            total += static_cast<size_t>(w) * h * 4;
+            if (w == 1 && h == 1) {
+                break;
+            }
+        }
+        pixels.resize(total);
+        for (size_t i = 1; i < levels.size(); ++i) {
+            const Level& source = levels[i - 1];
+            downsample(pixels.data() + source.offset, source.width, source.height, pixels.data() + levels[i].offset);
+        }
+        pixels.shrink_to_fit();
+        memory.set(pixels.capacity());
+    }
+
+    // 2x2 box filter into a max(width / 2, 1) x max(height / 2, 1) image. A side of one texel is
+    // averaged with itself; on odd sides the last row or column is dropped, like GL mip sizes.
+    static void downsample(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination) {
+        const uint32_t outWidth = std::max(width / 2, 1u);
+        const uint32_t outHeight = std::max(height / 2, 1u);
+        for (uint32_t y = 0; y < outHeight; ++y) {
+            const uint8_t* row0 = source + static_cast<size_t>(2 * y) * width * 4;
+            const uint8_t* row1 = source + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * width * 4;
+            uint8_t* out = destination + static_cast<size_t>(y) * outWidth * 4;
+            uint32_t x = 0;
+#ifdef OBJVIEWER_TEXTURE_SSE
+            // Four output texels from eight source texels of each row, summed in 16 bits
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i rounding = _mm_set1_epi16(2);
+            auto pairSums = [&](__m128i top, __m128i bottom) {
+                const __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+                const __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+                return _mm_unpacklo_epi64(_mm_add_epi16(low, _mm_srli_si128(low, 8)), _mm_add_epi16(high, _mm_srli_si128(high, 8)));
+            };
+            for (; 2 * x + 8 <= width; x += 4) {
+                const auto* top = reinterpret_cast<const __m128i*>(row0 + static_cast<size_t>(2 * x) * 4);
+                const auto* bottom = reinterpret_cast<const __m128i*>(row1 + static_cast<size_t>(2 * x) * 4);
+                const __m128i first = pairSums(_mm_loadu_si128(top), _mm_loadu_si128(bottom));
+                const __m128i second = pairSums(_mm_loadu_si128(top + 1), _mm_loadu_si128(bottom + 1));
+                const __m128i packed = _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(first, rounding), 2),
+                                                        _mm_srli_epi16(_mm_add_epi16(second, rounding), 2));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + static_cast<size_t>(x) * 4), packed);
+            }
+#endif
+            downsampleRow(row0, row1, width, out, x, outWidth);
+        }
+    }
+
+    // The same filter without SIMD, as a reference for downsample.
+    static void downsampleScalar(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination) {
+        const uint32_t outWidth = std::max(width / 2, 1u);
+        const uint32_t outHeight = std::max(height / 2, 1u);
+        for (uint32_t y = 0; y < outHeight; ++y) {
+            downsampleRow(source + static_cast<size_t>(2 * y) * width * 4,
+                          source + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * width * 4,
+                          width, destination + static_cast<size_t>(y) * outWidth * 4, 0, outWidth);
+        }
+    }
+
+    // FNV-1a; the cache keys decoded textures by the hash of the file they came from.
+    static uint64_t hashContent(const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    uint32_t getWidth() const { return levels.front().width; }
+    uint32_t getHeight() const { return levels.front().height; }
+    size_t getLevelCount() const { return levels.size(); }
+    const Level& getLevel(size_t level) const { return levels[level]; }
+    const uint8_t* getData(size_t level = 0) const { return pixels.data() + levels[level].offset; }
+    uint64_t getContentHash() const { return contentHash; }
+    size_t getMemoryBytes() const { return memory.getBytes(); }
+
+    // Nearest texel of a level with repeat wrapping, packed like FrameBuffer::packColor.
+    uint32_t sample(float u, float v, size_t level) const {
+        const Level& chosen = levels[std::min(level, levels.size() - 1)];
+        u -= std::floor(u);
+        v -= std::floor(v);
+        const uint32_t x = std::min(static_cast<uint32_t>(u * static_cast<float>(chosen.width)), chosen.width - 1);
+        const uint32_t y = std::min(static_cast<uint32_t>(v * static_cast<float>(chosen.height)), chosen.height - 1);
+        uint32_t texel;
+        std::memcpy(&texel, pixels.data() + chosen.offset + (static_cast<size_t>(y) * chosen.width + x) * 4, sizeof(texel));
+        return texel;
+    }
+};
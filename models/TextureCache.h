@@ -0,0 +1,204 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Texture.h"
+#include "TextureDecoder.h"
+#include "../core/JobSystem.h"
+#include "../core/Trace.h"
+
+// Decoded textures shared by every model of a ModelManager. A path that was loaded before
+// is a lookup; a new path whose file has the same bytes as a cached one (a copy under
+// another name or directory) is hashed but not decoded again. Decoding and mip generation
+// run on the job system outside the lock.
+//
+// The budget bounds what the cache alone keeps alive: past it, the least recently used
+// textures are dropped from the cache, but models holding them keep them until released.
+class TextureCache {
+public:
+    static constexpr size_t DefaultBudgetBytes = 256ull * 1024 * 1024;
+
+    struct Stats {
+        size_t requests = 0;
+        size_t pathHits = 0;    // Path seen before
+        size_t contentHits = 0; // New path, same file content as a cached texture
+        size_t decoded = 0;
+        size_t failed = 0;      // Missing, unreadable or unsupported files
+        size_t evicted = 0;
+    };
+
+private:
+    struct Entry {
+        std::shared_ptr<const Texture> texture;
+        std::list<uint64_t>::iterator recent;
+    };
+
+    std::unordered_map<std::string, uint64_t> paths;  // Normalized path -> content hash
+    std::unordered_map<uint64_t, Entry> textures;     // Content hash -> texture
+    std::list<uint64_t> recentlyUsed;                 // Most recent first
+    size_t budgetBytes;
+    size_t cachedBytes = 0;
+    Stats stats;
+    std::mutex mutex;
+    JobSystem& jobs;
+
+    static std::string normalize(const std::string& filePath) {
+        std::error_code error;
+        auto path = std::filesystem::weakly_canonical(filePath, error);
+        return error ? std::filesystem::path(filePath).lexically_normal().string() : path.string();
+    }
+
+    static bool readFile(const std::string& filePath, std::vector<uint8_t>& contents) {
+        std::ifstream file(filePath, std::ios::binary);
+        std::error_code error;
+        const auto size = std::filesystem::file_size(filePath, error);
+        if (!file.is_open() || error) {
+            return false;
+        }
+        contents.resize(static_cast<size_t>(size));
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size())));
+    }
+
+    // Caller holds the lock
+    std::shared_ptr<const Texture> findLocked(uint64_t hash) {
+        auto it = textures.find(hash);
+        if (it == textures.end()) {
+            return nullptr;
+        }
+        recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, it->second.recent);
+        return it->second.texture;
+    }
+
+    // Caller holds the lock. Keeps at least the newest texture even if it alone is over budget.
+    void evictLocked() {
+        while (cachedBytes > budgetBytes && recentlyUsed.size() > 1) {
+            auto it = textures.find(recentlyUsed.back());
+            cachedBytes -= it->second.texture->getMemoryBytes();
+            textures.erase(it);
+            recentlyUsed.pop_back();
+            ++stats.evicted;
+        }
+    }
+
+public:
+    explicit TextureCache(size_t budget = DefaultBudgetBytes, JobSystem& jobSystem = JobSystem::global())
+        : budgetBytes(budget), jobs(jobSystem) {}
+
+    // nullptr if the file is missing or cannot be decoded; safe to call from several threads.
+    std::shared_ptr<const Texture> load(const std::string& filePath) {
+        OBJVIEWER_TRACE_SCOPE("TextureCache::load");
+        const std::string key = normalize(filePath);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.requests;
+            if (auto it = paths.find(key); it != paths.end()) {
+                if (auto texture = findLocked(it->second)) {
+                    ++stats.pathHits;
+                    return texture;
+                }
+                // Evicted since; loaded again below
+                paths.erase(it);
+            }
+        }
+
+        std::vector<uint8_t> contents;
+        if (!readFile(key, contents)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.failed;
+            return nullptr;
+        }
+        const uint64_t hash = Texture::hashContent(contents.data(), contents.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (auto texture = findLocked(hash)) {
+                paths[key] = hash;
+                ++stats.contentHits;
+                return texture;
+            }
+        }
+
+        auto image = TextureDecoder::decode(contents.data(), contents.size());
+        contents = {};
+        if (!image) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.failed;
+            return nullptr;
+        }
+        auto texture = std::make_shared<const Texture>(image->width, image->height, std::move(image->rgba), hash);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.decoded;
+        paths[key] = hash;
+        // Another thread may have decoded the same content meanwhile; the first one stays
+        if (auto existing = findLocked(hash)) {
+            return existing;
+        }
+        recentlyUsed.push_front(hash);
+        textures.emplace(hash, Entry{texture, recentlyUsed.begin()});
+        cachedBytes += texture->getMemoryBytes();
+        evictLocked();
+        return texture;
+    }
+
+    // Decodes in parallel; results follow the order of filePaths, repeated paths are loaded once.
+    std::vector<std::shared_ptr<const Texture>> loadAll(const std::vector<std::string>& filePaths) {
+        OBJVIEWER_TRACE_SCOPE("TextureCache::loadAll");
+        std::vector<std::string> unique;
+        std::unordered_map<std::string, size_t> slots;
+        std::vector<size_t> slotOf(filePaths.size());
+        for (size_t i = 0; i < filePaths.size(); ++i) {
+            auto [it, inserted] = slots.try_emplace(filePaths[i], unique.size());
+            if (inserted) {
+                unique.push_back(filePaths[i]);
+            }
+            slotOf[i] = it->second;
+        }
+
+        std::vector<std::shared_ptr<const Texture>> loaded(unique.size());
+        jobs.parallelFor(0, unique.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                loaded[i] = load(unique[i]);
+            }
+        });
+
+        std::vector<std::shared_ptr<const Texture>> result(filePaths.size());
+        for (size_t i = 0; i < filePaths.size(); ++i) {
+            result[i] = loaded[slotOf[i]];
+        }
+        return result;
+    }
+
+    void setBudget(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        budgetBytes = bytes;
+        evictLocked();
+    }
+
+    size_t getCachedBytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cachedBytes;
+    }
+
+    size_t getTextureCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return textures.size();
+    }
+
+    Stats getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        paths.clear();
+        textures.clear();
+        recentlyUsed.clear();
+        cachedBytes = 0;
+    }
+};
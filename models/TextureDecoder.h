@@ -0,0 +1,365 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef OBJVIEWER_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+// Image files to RGBA8 without external libraries: PNG (8-bit, not interlaced), TGA
+// (true colour and grey, plain or RLE), binary PPM/PGM and uncompressed 24/32-bit BMP.
+// Compressed PNG data needs zlib (OBJVIEWER_WITH_ZLIB); without it only stored deflate
+// blocks are read, as ImageWriter writes them. Anything else decodes to nullopt.
+class TextureDecoder {
+public:
+    struct Image {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> rgba; // Bottom row first, like Texture
+    };
+
+    static constexpr uint32_t MaxDimension = 16384;
+
+    static std::optional<Image> decode(const uint8_t* data, size_t size) {
+        if (size >= 8 && std::memcmp(data, "\x89PNG\r\n\x1A\n", 8) == 0) {
+            return decodePNG(data, size);
+        }
+        if (size >= 2 && data[0] == 'B' && data[1] == 'M') {
+            return decodeBMP(data, size);
+        }
+        if (size >= 2 && data[0] == 'P' && (data[1] == '5' || data[1] == '6')) {
+            return decodePNM(data, size);
+        }
+        // TGA has no signature; its header is checked field by field
+        return decodeTGA(data, size);
+    }
+
+private:
+    static uint32_t readBig32(const uint8_t* p) {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+
+    static uint32_t readLittle16(const uint8_t* p) {
+        return p[0] | (uint32_t(p[1]) << 8);
+    }
+
+    static uint32_t readLittle32(const uint8_t* p) {
+        return p[0] | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    static std::optional<Image> allocate(uint32_t width, uint32_t height) {
+        if (width == 0 || height == 0 || width > MaxDimension || height > MaxDimension) {
+            return std::nullopt;
+        }
+        Image image;
+        image.width = width;
+        image.height = height;
+        image.rgba.resize(static_cast<size_t>(width) * height * 4);
+        return image;
+    }
+
+    // Decoders write rows top to bottom and flip once at the end
+    static void flipRows(Image& image) {
+        const size_t stride = static_cast<size_t>(image.width) * 4;
+        std::vector<uint8_t> row(stride);
+        for (uint32_t top = 0, bottom = image.height - 1; top < bottom; ++top, --bottom) {
+            uint8_t* a = image.rgba.data() + top * stride;
+            uint8_t* b = image.rgba.data() + bottom * stride;
+            std::memcpy(row.data(), a, stride);
+            std::memcpy(a, b, stride);
+            std::memcpy(b, row.data(), stride);
+        }
+    }
+
+    // zlib stream into exactly expected bytes
+    static bool inflate(const std::vector<uint8_t>& compressed, std::vector<uint8_t>& out, size_t expected) {
+        out.resize(expected);
+#ifdef OBJVIEWER_WITH_ZLIB
+        uLongf length = static_cast<uLongf>(expected);
+        return uncompress(out.data(), &length, compressed.data(), static_cast<uLong>(compressed.size())) == Z_OK && length == expected;
+#else
+        if (compressed.size() < 2 || (compressed[0] & 0x0F) != 8 || (compressed[1] & 0x20) != 0) {
+            return false;
+        }
+        size_t in = 2;
+        size_t written = 0;
+        for (bool last = false; !last;) {
+            if (in + 5 > compressed.size()) {
+                return false;
+            }
+            const uint8_t header = compressed[in];
+            last = (header & 1) != 0;
+            if ((header >> 1) != 0) {
+                return false; // Huffman-coded block
+            }
+            const uint32_t length = readLittle16(&compressed[in + 1]);
+            if ((length ^ readLittle16(&compressed[in + 3])) != 0xFFFF || in + 5 + length > compressed.size() || written + length > expected) {
+                return false;
+            }
+            std::memcpy(out.data() + written, &compressed[in + 5], length);
+            in += 5 + length;
+            written += length;
+        }
+        return written == expected;
+#endif
+    }
+
+    static uint8_t paeth(int a, int b, int c) {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : (pb <= pc ? b : c));
+    }
+
+    static std::optional<Image> decodePNG(const uint8_t* data, size_t size) {
+        uint32_t width = 0, height = 0;
+        uint8_t colorType = 0;
+        std::vector<uint8_t> palette;
+        std::vector<uint8_t> paletteAlpha;
+        std::vector<uint8_t> compressed;
+        bool header = false;
+
+        for (size_t at = 8; at + 12 <= size;) {
+            const uint32_t length = readBig32(data + at);
+            if (length > size - at - 12) {
+                return std::nullopt;
+            }
+            const uint8_t* type = data + at + 4;
+            const uint8_t* chunk = data + at + 8;
+            if (std::memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+                width = readBig32(chunk);
+                height = readBig32(chunk + 4);
+                colorType = chunk[9];
+                // 8 bits per channel, deflate, standard filters, no interlacing
+                if (chunk[8] != 8 || chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0) {
+                    return std::nullopt;
+                }
+                header = true;
+            } else if (std::memcmp(type, "PLTE", 4) == 0) {
+                palette.assign(chunk, chunk + length);
+            } else if (std::memcmp(type, "tRNS", 4) == 0) {
+                paletteAlpha.assign(chunk, chunk + length);
+            } else if (std::memcmp(type, "IDAT", 4) == 0) {
+                compressed.insert(compressed.end(), chunk, chunk + length);
+            } else if (std::memcmp(type, "IEND", 4) == 0) {
+                break;
+            }
+            at += 12 + length;
+        }
+
+        size_t channels;
+        switch (colorType) {
+            case 0: channels = 1; break; // Grey
+            case 2: channels = 3; break; // RGB
+            case 3: channels = 1; break; // Palette index
+            case 4: channels = 2; break; // Grey and alpha
+            case 6: channels = 4; break; // RGBA
+            default: return std::nullopt;
+        }
+        auto image = allocate(width, height);
+        if (!header || !image || (colorType == 3 && palette.size() < 3)) {
+            return std::nullopt;
+        }
+
+        const size_t stride = width * channels;
+        std::vector<uint8_t> raw;
+        if (!inflate(compressed, raw, (stride + 1) * height)) {
+            return std::nullopt;
+        }
+
+        std::vector<uint8_t> previous(stride, 0);
+        for (uint32_t y = 0; y < height; ++y) {
+            const uint8_t filter = raw[y * (stride + 1)];
+            uint8_t* row = &raw[y * (stride + 1) + 1];
+            for (size_t i = 0; i < stride; ++i) {
+                const int left = i >= channels ? row[i - channels] : 0;
+                const int up = previous[i];
+                const int upLeft = i >= channels ? previous[i - channels] : 0;
+                switch (filter) {
+                    case 0: break;
+                    case 1: row[i] = static_cast<uint8_t>(row[i] + left); break;
+                    case 2: row[i] = static_cast<uint8_t>(row[i] + up); break;
+                    case 3: row[i] = static_cast<uint8_t>(row[i] + ((left + up) >> 1)); break;
+                    case 4: row[i] = static_cast<uint8_t>(row[i] + paeth(left, up, upLeft)); break;
+                    default: return std::nullopt;
+                }
+            }
+
+            uint8_t* out = image->rgba.data() + static_cast<size_t>(y) * width * 4;
+            for (uint32_t x = 0; x < width; ++x, out += 4) {
+                const uint8_t* in = row + x * channels;
+                switch (colorType) {
+                    case 0: out[0] = out[1] = out[2] = in[0]; out[3] = 255; break;
+                    case 2: out[0] = in[0]; out[1] = in[1]; out[2] = in[2]; out[3] = 255; break;
+                    case 3: {
+                        const size_t entry = in[0];
+                        if (entry * 3 + 2 >= palette.size()) {
+                            return std::nullopt;
+                        }
+                        std::memcpy(out, &palette[entry * 3], 3);
+                        out[3] = entry < paletteAlpha.size() ? paletteAlpha[entry] : 255;
+                        break;
+                    }
+                    case 4: out[0] = out[1] = out[2] = in[0]; out[3] = in[1]; break;
+                    default: std::memcpy(out, in, 4); break;
+                }
+            }
+            std::memcpy(previous.data(), row, stride);
+        }
+        flipRows(*image);
+        return image;
+    }
+
+    static std::optional<Image> decodeTGA(const uint8_t* data, size_t size) {
+        if (size < 18) {
+            return std::nullopt;
+        }
+        const uint8_t imageType = data[2];
+        const uint32_t depth = data[16];
+        const bool rle = imageType == 10 || imageType == 11;
+        const bool grey = imageType == 3 || imageType == 11;
+        if (data[1] != 0 || (imageType != 2 && imageType != 3 && !rle) || (grey ? depth != 8 : depth != 24 && depth != 32)) {
+            return std::nullopt;
+        }
+        auto image = allocate(readLittle16(data + 12), readLittle16(data + 14));
+        if (!image) {
+            return std::nullopt;
+        }
+
+        const size_t bytesPerPixel = depth / 8;
+        size_t at = 18 + data[0];
+        auto convert = [&](const uint8_t* in, uint8_t* out) {
+            if (grey) {
+                out[0] = out[1] = out[2] = in[0];
+                out[3] = 255;
+            } else {
+                out[0] = in[2];
+                out[1] = in[1];
+                out[2] = in[0];
+                out[3] = bytesPerPixel == 4 ? in[3] : 255;
+            }
+        };
+
+        // Pixels in file order; rows are flipped below if the file is stored top down
+        const size_t count = static_cast<size_t>(image->width) * image->height;
+        uint8_t* out = image->rgba.data();
+        for (size_t pixel = 0; pixel < count;) {
+            size_t run = 1;
+            bool repeated = false;
+            if (rle) {
+                if (at >= size) {
+                    return std::nullopt;
+                }
+                repeated = (data[at] & 0x80) != 0;
+                run = std::min<size_t>((data[at] & 0x7F) + 1, count - pixel);
+                ++at;
+            }
+            const size_t needed = repeated ? bytesPerPixel : run * bytesPerPixel;
+            if (at + needed > size) {
+                return std::nullopt;
+            }
+            for (size_t i = 0; i < run; ++i, ++pixel) {
+                convert(data + at + (repeated ? 0 : i * bytesPerPixel), out + pixel * 4);
+            }
+            at += needed;
+        }
+        // Descriptor bit 5: first row is the top one
+        if (data[17] & 0x20) {
+            flipRows(*image);
+        }
+        return image;
+    }
+
+    static std::optional<Image> decodePNM(const uint8_t* data, size_t size) {
+        const bool grey = data[1] == '5';
+        size_t at = 2;
+        auto number = [&]() -> long {
+            while (at < size) {
+                if (data[at] == '#') {
+                    while (at < size && data[at] != '\n') {
+                        ++at;
+                    }
+                } else if (std::isspace(data[at])) {
+                    ++at;
+                } else {
+                    break;
+                }
+            }
+            long value = 0;
+            const size_t start = at;
+            for (; at < size && std::isdigit(data[at]) && value < 1000000; ++at) {
+                value = value * 10 + (data[at] - '0');
+            }
+            return at > start ? value : -1;
+        };
+        const long width = number();
+        const long height = number();
+        const long maxValue = number();
+        if (width <= 0 || height <= 0 || maxValue != 255 || at >= size) {
+            return std::nullopt;
+        }
+        ++at; // Single whitespace before the samples
+        auto image = allocate(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+        const size_t channels = grey ? 1 : 3;
+        if (!image || size - at < static_cast<size_t>(width) * height * channels) {
+            return std::nullopt;
+        }
+        const uint8_t* in = data + at;
+        uint8_t* out = image->rgba.data();
+        for (size_t pixel = 0; pixel < static_cast<size_t>(width) * height; ++pixel, in += channels, out += 4) {
+            out[0] = in[0];
+            out[1] = in[grey ? 0 : 1];
+            out[2] = in[grey ? 0 : 2];
+            out[3] = 255;
+        }
+        flipRows(*image);
+        return image;
+    }
+
+    static std::optional<Image> decodeBMP(const uint8_t* data, size_t size) {
+        if (size < 54) {
+            return std::nullopt;
+        }
+        const uint32_t pixelOffset = readLittle32(data + 10);
+        const auto width = static_cast<int32_t>(readLittle32(data + 18));
+        const auto height = static_cast<int32_t>(readLittle32(data + 22));
+        const uint32_t bitCount = readLittle16(data + 28);
+        const uint32_t compression = readLittle32(data + 30);
+        if (width <= 0 || height == 0 || height == INT32_MIN || (bitCount != 24 && bitCount != 32) || compression != 0) {
+            return std::nullopt;
+        }
+        // Negative height: rows are stored top down
+        const bool topDown = height < 0;
+        auto image = allocate(static_cast<uint32_t>(width), static_cast<uint32_t>(topDown ? -height : height));
+        if (!image) {
+            return std::nullopt;
+        }
+        const size_t bytesPerPixel = bitCount / 8;
+        const size_t stride = (static_cast<size_t>(image->width) * bytesPerPixel + 3) & ~size_t(3);
+        if (pixelOffset > size || size - pixelOffset < stride * image->height) {
+            return std::nullopt;
+        }
+        for (uint32_t y = 0; y < image->height; ++y) {
+            const uint8_t* in = data + pixelOffset + static_cast<size_t>(y) * stride;
+            uint8_t* out = image->rgba.data() + static_cast<size_t>(y) * image->width * 4;
+            for (uint32_t x = 0; x < image->width; ++x, in += bytesPerPixel, out += 4) {
+                // The fourth byte of 32-bit BI_RGB is unused, so the image is opaque
+                out[0] = in[2];
+                out[1] = in[1];
+                out[2] = in[0];
+                out[3] = 255;
+            }
+        }
+        if (topDown) {
+            flipRows(*image);
+        }
+        return image;
+    }
+};
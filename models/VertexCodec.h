@@ -0,0 +1,134 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// Encodings used by the compact vertex format:
+// positions as unorm16 inside the mesh AABB, normals octahedral in 2 x snorm16,
+// texture coordinates as IEEE half floats.
+class VertexCodec {
+public:
+    static uint16_t quantizeUnorm16(float value, float minimum, float extent) {
+        float t = extent > 0.0f ? (value - minimum) / extent : 0.0f;
+        t = std::clamp(t, 0.0f, 1.0f);
+        return static_cast<uint16_t>(std::lround(t * 65535.0f));
+    }
+
+    static float dequantizeUnorm16(uint16_t value, float minimum, float extent) {
+        return minimum + static_cast<float>(value) * (1.0f / 65535.0f) * extent;
+    }
+
+    static int16_t quantizeSnorm16(float value) {
+        value = std::clamp(value, -1.0f, 1.0f);
+        return static_cast<int16_t>(std::lround(value * 32767.0f));
+    }
+
+    static float dequantizeSnorm16(int16_t value) {
+        return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+    }
+
+    static void octEncode(float nx, float ny, float nz, int16_t& ex, int16_t& ey) {
+        float sum = std::fabs(nx) + std::fabs(ny) + std::fabs(nz);
+        if (sum == 0.0f) {
+            ex = ey = 0;
+            return;
+        }
+
+        float x = nx / sum;
+        float y = ny / sum;
+        if (nz < 0.0f) {
+            float wrappedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float wrappedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = wrappedX;
+            y = wrappedY;
+        }
+
+        ex = quantizeSnorm16(x);
+        ey = quantizeSnorm16(y);
+    }
+
+    // Same arithmetic as octDecode() in the packed vertex shader.
+    static void octDecode(int16_t ex, int16_t ey, float& nx, float& ny, float& nz) {
+        float x = dequantizeSnorm16(ex);
+        float y = dequantizeSnorm16(ey);
+        float z = 1.0f - std::fabs(x) - std::fabs(y);
+        float t = std::max(-z, 0.0f);
+        x += x >= 0.0f ? -t : t;
+        y += y >= 0.0f ? -t : t;
+
+        float length = std::sqrt(x * x + y * y + z * z);
+        nx = x / length;
+        ny = y / length;
+        nz = z / length;
+    }
+
+    // float -> binary16, round to nearest even, with denormals, infinities and NaN.
+    static uint16_t floatToHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        uint32_t exponent = (bits >> 23) & 0xFFu;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+
+        if (exponent == 0xFFu) {
+            return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+        }
+
+        int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+        if (halfExponent >= 0x1F) {
+            return static_cast<uint16_t>(sign | 0x7C00u);
+        }
+
+        if (halfExponent <= 0) {
+            if (halfExponent < -10) {
+                return static_cast<uint16_t>(sign);
+            }
+            mantissa |= 0x800000u;
+            uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+                ++half;
+            }
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+            ++half; // may carry into the exponent, which is the correct rounding
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    static float halfToFloat(uint16_t value) {
+        uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+        uint32_t exponent = (value >> 10) & 0x1Fu;
+        uint32_t mantissa = value & 0x3FFu;
+        uint32_t bits;
+
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = sign;
+            } else {
+                exponent = 127 - 15 + 1;
+                while ((mantissa & 0x400u) == 0) {
+                    mantissa <<= 1;
+                    --exponent;
+                }
+                bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+            }
+        } else if (exponent == 0x1F) {
+            bits = sign | 0x7F800000u | (mantissa << 13);
+        } else {
+            bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+        }
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+};
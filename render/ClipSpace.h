@@ -0,0 +1,81 @@
+#ifndef OBJVIEWER_CLIPSPACE_H
+#define OBJVIEWER_CLIPSPACE_H
+
+#include <cstddef>
+
+// Вершина в однородных координатах отсечения (соглашение OpenGL: -w <= z <= w)
+struct ClipVertex {
+    float x, y, z, w;
+    float intensity;
+    float u, v;
+};
+
+namespace ClipSpace {
+    // m - матрица 4x4 в столбцовом порядке (Matrix4x4::data(), glm::value_ptr)
+    inline ClipVertex transform(const float* m, float x, float y, float z) {
+        return ClipVertex{
+                m[0] * x + m[4] * y + m[8] * z + m[12],
+                m[1] * x + m[5] * y + m[9] * z + m[13],
+                m[2] * x + m[6] * y + m[10] * z + m[14],
+                m[3] * x + m[7] * y + m[11] * z + m[15],
+                0.0f, 0.0f, 0.0f
+        };
+    }
+
+    // out = a * b, все матрицы в столбцовом порядке
+    inline void multiply(const float* a, const float* b, float* out) {
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; ++k) {
+                    sum += a[k * 4 + row] * b[column * 4 + k];
+                }
+                out[column * 4 + row] = sum;
+            }
+        }
+    }
+
+    inline ClipVertex lerp(const ClipVertex& a, const ClipVertex& b, float t) {
+        return ClipVertex{
+                a.x + (b.x - a.x) * t,
+                a.y + (b.y - a.y) * t,
+                a.z + (b.z - a.z) * t,
+                a.w + (b.w - a.w) * t,
+                a.intensity + (b.intensity - a.intensity) * t,
+                a.u + (b.u - a.u) * t,
+                a.v + (b.v - a.v) * t
+        };
+    }
+
+    // Отсечение треугольника ближней плоскостью z = -w.
+    // Возвращает число вершин выпуклого многоугольника в out (0, 3 или 4).
+    inline size_t clipNear(const ClipVertex (&in)[3], ClipVertex (&out)[4]) {
+        size_t count = 0;
+        for (size_t i = 0; i < 3; ++i) {
+            const ClipVertex& current = in[i];
+            const ClipVertex& next = in[(i + 1) % 3];
+            float dc = current.z + current.w;
+            float dn = next.z + next.w;
+
+            if (dc >= 0.0f) {
+                out[count++] = current;
+            }
+            if ((dc >= 0.0f) != (dn >= 0.0f)) {
+                out[count++] = lerp(current, next, dc / (dc - dn));
+            }
+        }
+        return count;
+    }
+
+    // Все вершины по одну внешнюю сторону одной из плоскостей отсечения
+    inline bool isTriviallyOutside(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) {
+        return (a.x > a.w && b.x > b.w && c.x > c.w) ||
+               (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+               (a.y > a.w && b.y > b.w && c.y > c.w) ||
+               (a.y < -a.w && b.y < -b.w && c.y < -c.w) ||
+               (a.z > a.w && b.z > b.w && c.z > c.w) ||
+               (a.z < -a.w && b.z < -b.w && c.z < -c.w);
+    }
+}
+
+#endif //OBJVIEWER_CLIPSPACE_H
@@ -0,0 +1,49 @@
+#ifndef OBJVIEWER_FRAMEBUFFER_H
+#define OBJVIEWER_FRAMEBUFFER_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Буфер кадра программного растеризатора: цвет RGBA8 (R в младшем байте) и глубина [0, 1]
+class FrameBuffer {
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> color;
+    std::vector<float> depth;
+
+public:
+    FrameBuffer() = default;
+    FrameBuffer(int w, int h) { resize(w, h); }
+
+    void resize(int w, int h) {
+        width = std::max(w, 0);
+        height = std::max(h, 0);
+        color.assign(static_cast<size_t>(width) * height, 0);
+        depth.assign(static_cast<size_t>(width) * height, 1.0f);
+    }
+
+    void clear(uint32_t clearColor, float clearDepth = 1.0f) {
+        std::fill(color.begin(), color.end(), clearColor);
+        std::fill(depth.begin(), depth.end(), clearDepth);
+    }
+
+    static constexpr uint32_t packColor(float r, float g, float b, float a = 1.0f) {
+        auto channel = [](float value) {
+            value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+            return static_cast<uint32_t>(value * 255.0f + 0.5f);
+        };
+        return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+    }
+
+    [[nodiscard]] int getWidth() const { return width; }
+    [[nodiscard]] int getHeight() const { return height; }
+
+    [[nodiscard]] uint32_t* colorData() { return color.data(); }
+    [[nodiscard]] const uint32_t* colorData() const { return color.data(); }
+    [[nodiscard]] float* depthData() { return depth.data(); }
+    [[nodiscard]] const float* depthData() const { return depth.data(); }
+};
+
+#endif //OBJVIEWER_FRAMEBUFFER_H
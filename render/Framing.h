@@ -0,0 +1,71 @@
+#ifndef OBJVIEWER_FRAMING_H
+#define OBJVIEWER_FRAMING_H
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "../model/math/Vector3D.h"
+#include "../model/math/Matrix4x4.h"
+#include "../models/Mesh.h"
+
+// Автоматическая установка камеры по габаритам модели
+class Framing {
+public:
+    struct View {
+        VecMath::Vector3D<float> eye;
+        VecMath::Vector3D<float> target;
+        float nearPlane;
+        float farPlane;
+        VecMath::Matrix4x4<float> view;
+        VecMath::Matrix4x4<float> projection;
+        VecMath::Matrix4x4<float> viewProjection;
+    };
+
+    // yaw - поворот вокруг вертикальной оси, pitch - наклон (радианы).
+    // Описанная сфера габаритов целиком помещается в кадр при любом угле.
+    static View fitBounds(const Mesh::Bounds& bounds, float aspect,
+                          float yaw = 0.6f, float pitch = 0.45f, float fovY = 0.7f) {
+        VecMath::Vector3D<float> center{
+                (bounds.min[0] + bounds.max[0]) * 0.5f,
+                (bounds.min[1] + bounds.max[1]) * 0.5f,
+                (bounds.min[2] + bounds.max[2]) * 0.5f
+        };
+        auto extent = bounds.extent();
+        float radius = 0.5f * std::sqrt(extent[0] * extent[0] + extent[1] * extent[1] + extent[2] * extent[2]);
+        radius = std::max(radius, 1e-4f);
+
+        float fovX = 2.0f * std::atan(std::tan(fovY * 0.5f) * aspect);
+        float distance = radius / std::sin(std::min(fovX, fovY) * 0.5f);
+
+        VecMath::Vector3D<float> direction{
+                std::cos(pitch) * std::sin(yaw),
+                std::sin(pitch),
+                std::cos(pitch) * std::cos(yaw)
+        };
+
+        View result;
+        result.target = center;
+        result.eye = center + direction * distance;
+        result.nearPlane = std::max(distance - radius * 1.01f, distance * 1e-3f);
+        result.farPlane = distance + radius * 1.01f;
+        result.view = VecMath::Matrix4x4<float>::lookAt(result.eye, result.target, VecMath::Vector3D<float>{0.0f, 1.0f, 0.0f});
+        result.projection = VecMath::Matrix4x4<float>::perspective(fovY, aspect, result.nearPlane, result.farPlane);
+        result.viewProjection = result.projection * result.view;
+        return result;
+    }
+
+    // count видов по кругу с равным шагом по yaw; расстояние одинаковое для всех кадров
+    static std::vector<View> turntable(const Mesh::Bounds& bounds, float aspect, size_t count,
+                                       float pitch = 0.45f, float fovY = 0.7f) {
+        constexpr float TwoPi = 6.28318530718f;
+        std::vector<View> views;
+        views.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            float yaw = TwoPi * static_cast<float>(i) / static_cast<float>(count);
+            views.push_back(fitBounds(bounds, aspect, yaw, pitch, fovY));
+        }
+        return views;
+    }
+};
+
+#endif //OBJVIEWER_FRAMING_H
@@ -0,0 +1,134 @@
+#ifndef OBJVIEWER_IMAGEWRITER_H
+#define OBJVIEWER_IMAGEWRITER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+#include "FrameBuffer.h"
+
+// Запись кадра в PPM (P6) или PNG без внешних библиотек.
+// PNG сжимается блоками deflate без компрессии: файл больше, но кодирование почти бесплатно.
+class ImageWriter {
+private:
+    static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+        static const auto table = [] {
+            std::vector<uint32_t> values(256);
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                values[n] = c;
+            }
+            return values;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    static void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static void appendChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+        appendBigEndian(out, static_cast<uint32_t>(data.size()));
+        size_t typeStart = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        appendBigEndian(out, crc32(out.data() + typeStart, out.size() - typeStart));
+    }
+
+    static std::ofstream open(const std::string& filePath) {
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + filePath);
+        }
+        return file;
+    }
+
+public:
+    static std::vector<uint8_t> encodePNG(const FrameBuffer& frame) {
+        const int width = frame.getWidth();
+        const int height = frame.getHeight();
+        const uint32_t* pixels = frame.colorData();
+
+        // Строки RGB с нулевым фильтром
+        std::vector<uint8_t> raw;
+        raw.reserve(static_cast<size_t>(height) * (static_cast<size_t>(width) * 3 + 1));
+        for (int y = 0; y < height; ++y) {
+            raw.push_back(0);
+            for (int x = 0; x < width; ++x) {
+                uint32_t pixel = pixels[static_cast<size_t>(y) * width + x];
+                raw.push_back(static_cast<uint8_t>(pixel));
+                raw.push_back(static_cast<uint8_t>(pixel >> 8));
+                raw.push_back(static_cast<uint8_t>(pixel >> 16));
+            }
+        }
+
+        std::vector<uint8_t> zlib = {0x78, 0x01};
+        uint32_t adlerA = 1, adlerB = 0;
+        for (uint8_t byte : raw) {
+            adlerA = (adlerA + byte) % 65521u;
+            adlerB = (adlerB + adlerA) % 65521u;
+        }
+
+        size_t offset = 0;
+        do {
+            size_t blockSize = std::min<size_t>(65535, raw.size() - offset);
+            bool last = offset + blockSize == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back(static_cast<uint8_t>(blockSize));
+            zlib.push_back(static_cast<uint8_t>(blockSize >> 8));
+            zlib.push_back(static_cast<uint8_t>(~blockSize));
+            zlib.push_back(static_cast<uint8_t>(~blockSize >> 8));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+            offset += blockSize;
+        } while (offset < raw.size());
+        appendBigEndian(zlib, (adlerB << 16) | adlerA);
+
+        std::vector<uint8_t> header;
+        appendBigEndian(header, static_cast<uint32_t>(width));
+        appendBigEndian(header, static_cast<uint32_t>(height));
+        header.insert(header.end(), {8, 2, 0, 0, 0}); // 8 бит, RGB
+
+        std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        appendChunk(png, "IHDR", header);
+        appendChunk(png, "IDAT", zlib);
+        appendChunk(png, "IEND", {});
+        return png;
+    }
+
+    static void writePNG(const std::string& filePath, const FrameBuffer& frame) {
+        auto data = encodePNG(frame);
+        auto file = open(filePath);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    static void writePPM(const std::string& filePath, const FrameBuffer& frame) {
+        auto file = open(filePath);
+        file << "P6\n" << frame.getWidth() << " " << frame.getHeight() << "\n255\n";
+
+        std::vector<uint8_t> row(static_cast<size_t>(frame.getWidth()) * 3);
+        for (int y = 0; y < frame.getHeight(); ++y) {
+            const uint32_t* pixels = frame.colorData() + static_cast<size_t>(y) * frame.getWidth();
+            for (int x = 0; x < frame.getWidth(); ++x) {
+                row[x * 3 + 0] = static_cast<uint8_t>(pixels[x]);
+                row[x * 3 + 1] = static_cast<uint8_t>(pixels[x] >> 8);
+                row[x * 3 + 2] = static_cast<uint8_t>(pixels[x] >> 16);
+            }
+            file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+        }
+    }
+};
+
+#endif //OBJVIEWER_IMAGEWRITER_H
@@ -0,0 +1,94 @@
+#ifndef OBJVIEWER_MESHREGISTRY_H
+#define OBJVIEWER_MESHREGISTRY_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Ссылка на меш, загруженный в бэкенд рендера. Геометрия живёт в бэкенде
+// в его собственном формате, наружу выдаётся только номер слота и поколение
+struct MeshHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0; // 0 - пустая ссылка
+
+    [[nodiscard]] bool isValid() const { return generation != 0; }
+    bool operator==(const MeshHandle&) const = default;
+};
+
+// Запись кадра: что нарисовать. Сама геометрия в кадр не передаётся
+struct DrawRecord {
+    MeshHandle mesh;
+};
+
+// Плотное хранилище ресурсов бэкенда по MeshHandle. Освобождённые слоты
+// переиспользуются, устаревшая ссылка на слот отличается по поколению
+template<typename Resource>
+class MeshRegistry {
+private:
+    struct Slot {
+        std::optional<Resource> resource;
+        uint32_t generation = 1;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t count = 0;
+
+public:
+    MeshHandle add(Resource resource) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        slots[index].resource.emplace(std::move(resource));
+        ++count;
+        return MeshHandle{index, slots[index].generation};
+    }
+
+    [[nodiscard]] Resource* find(MeshHandle handle) {
+        if (handle.index >= slots.size()) {
+            return nullptr;
+        }
+        Slot& slot = slots[handle.index];
+        return slot.generation == handle.generation && slot.resource ? &*slot.resource : nullptr;
+    }
+
+    bool remove(MeshHandle handle) {
+        if (!find(handle)) {
+            return false;
+        }
+        Slot& slot = slots[handle.index];
+        slot.resource.reset();
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        freeSlots.push_back(handle.index);
+        --count;
+        return true;
+    }
+
+    template<typename Function>
+    void forEach(Function&& function) {
+        for (auto& slot : slots) {
+            if (slot.resource) {
+                function(*slot.resource);
+            }
+        }
+    }
+
+    void clear() {
+        for (uint32_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].resource) {
+                remove(MeshHandle{i, slots[i].generation});
+            }
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+};
+
+#endif //OBJVIEWER_MESHREGISTRY_H
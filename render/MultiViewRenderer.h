@@ -0,0 +1,120 @@
+#ifndef OBJVIEWER_MULTIVIEWRENDERER_H
+#define OBJVIEWER_MULTIVIEWRENDERER_H
+
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+#include "../core/JobSystem.h"
+#include "../core/MemoryStats.h"
+#include "SoftwareRasterizer.h"
+#include "OcclusionCuller.h"
+#include "FrameBuffer.h"
+#include "../model/math/Vector3D.h"
+#include "../model/math/Matrix4x4.h"
+#include "../models/Model3D.h"
+
+// Рендер одной модели с нескольких камер (турнтейбл).
+// Вершины распаковываются и освещаются один раз в prepare(), затем каждый вид
+// только умножается на свою матрицу и растеризуется в отдельный буфер, виды - параллельно на JobSystem.
+class MultiViewRenderer {
+public:
+    struct Stats {
+        size_t views = 0;
+        double prepareSeconds = 0.0;
+        double renderSeconds = 0.0;
+        SoftwareRasterizer::Stats raster;
+    };
+
+private:
+    JobSystem& jobs;
+    VecMath::Vector3D<float> lightDirection{0.0f, 0.0f, 1.0f};
+    VecMath::Vector3D<float> baseColor{0.8f, 0.8f, 0.8f};
+    uint32_t clearColor = FrameBuffer::packColor(0.2f, 0.2f, 0.2f);
+    bool occlusionCulling = true;
+
+    const Model3D* model = nullptr;
+    std::vector<SoftwareRasterizer::PreparedMesh> preparedMeshes;
+    MemoryAccount memory{MemoryTag::RenderCopies};
+    Stats stats;
+
+    SoftwareRasterizer makeRasterizer() const {
+        SoftwareRasterizer rasterizer;
+        rasterizer.setLightDirection(lightDirection);
+        rasterizer.setBaseColor(baseColor);
+        return rasterizer;
+    }
+
+public:
+    explicit MultiViewRenderer(JobSystem& jobSystem = JobSystem::global()) : jobs(jobSystem) {}
+
+    // Освещение считается при подготовке, поэтому меняется только до prepare()
+    void setLightDirection(const VecMath::Vector3D<float>& direction) { lightDirection = direction; }
+    void setBaseColor(const VecMath::Vector3D<float>& color) { baseColor = color; }
+    void setClearColor(uint32_t color) { clearColor = color; }
+    void setOcclusionCulling(bool enabled) { occlusionCulling = enabled; }
+
+    [[nodiscard]] const Stats& getStats() const { return stats; }
+
+    // Модель должна жить до последнего render()
+    void prepare(const Model3D& source) {
+        const auto start = std::chrono::steady_clock::now();
+
+        model = &source;
+        const auto& meshes = source.getMeshes();
+        SoftwareRasterizer rasterizer = makeRasterizer();
+        preparedMeshes.resize(meshes.size());
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            rasterizer.prepareMesh(*meshes[i], preparedMeshes[i]);
+        }
+        size_t preparedBytes = 0;
+        for (const auto& prepared : preparedMeshes) {
+            preparedBytes += prepared.vertices.capacity() * sizeof(prepared.vertices[0]);
+        }
+        memory.set(preparedBytes);
+
+        stats = Stats{};
+        stats.prepareSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // targets[i] получает вид viewProjections[i]; размеры буферов задаёт вызывающий
+    void render(const std::vector<VecMath::Matrix4x4<float>>& viewProjections, std::vector<FrameBuffer>& targets) {
+        if (!model) {
+            throw std::logic_error("MultiViewRenderer::render called before prepare");
+        }
+        if (targets.size() != viewProjections.size()) {
+            throw std::invalid_argument("MultiViewRenderer::render: view and target counts differ");
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::mutex statsMutex;
+
+        jobs.parallelFor(0, viewProjections.size(), 1, [&](size_t begin, size_t end) {
+            SoftwareRasterizer rasterizer = makeRasterizer();
+            OcclusionCuller culler;
+            if (occlusionCulling) {
+                rasterizer.setOcclusionCuller(&culler);
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                targets[i].clear(clearColor);
+                rasterizer.setViewProjection(viewProjections[i]);
+                rasterizer.drawPrepared(*model, preparedMeshes, targets[i]);
+            }
+
+            const auto& s = rasterizer.getStats();
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.raster.trianglesSubmitted += s.trianglesSubmitted;
+            stats.raster.trianglesBackfaceCulled += s.trianglesBackfaceCulled;
+            stats.raster.trianglesFrustumCulled += s.trianglesFrustumCulled;
+            stats.raster.trianglesRasterized += s.trianglesRasterized;
+            stats.raster.pixelsShaded += s.pixelsShaded;
+            stats.raster.transformMilliseconds += s.transformMilliseconds;
+        });
+
+        stats.views += viewProjections.size();
+        stats.renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+#endif //OBJVIEWER_MULTIVIEWRENDERER_H
@@ -0,0 +1,510 @@
+#ifndef OBJVIEWER_OCCLUSIONCULLER_H
+#define OBJVIEWER_OCCLUSIONCULLER_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "ClipSpace.h"
+#include "../core/Trace.h"
+#include "../models/Model3D.h"
+
+// Программное отсечение перекрытых объектов.
+// Крупнейшие меши растеризуются в грубый буфер глубины, по нему строится
+// min/max-пирамида, и границы мешей и кластеров проверяются по ней до основного рендера.
+class OcclusionCuller {
+public:
+    struct Range {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    struct MeshVisibility {
+        bool visible = true;
+        std::vector<Range> ranges; // Видимые диапазоны индексов, смежные объединены
+    };
+
+    // Меш со своей матрицей: viewProjection уже умножена на матрицу модели
+    struct Instance {
+        const Mesh* mesh;
+        const float* viewProjection;
+    };
+
+    struct Stats {
+        size_t meshesTested = 0;
+        size_t meshesOccluded = 0;
+        size_t meshesOutsideFrustum = 0;
+        size_t clustersTested = 0;
+        size_t clustersOccluded = 0;
+        size_t occluderTriangles = 0;
+        size_t trianglesTotal = 0;
+        size_t trianglesOccluded = 0;
+        size_t trianglesOutsideFrustum = 0;
+
+        // Доля треугольников кадра, отброшенных по перекрытию
+        [[nodiscard]] float occludedFraction() const {
+            return trianglesTotal ? static_cast<float>(trianglesOccluded) / static_cast<float>(trianglesTotal) : 0.0f;
+        }
+    };
+
+private:
+    enum class Result {
+        Visible,
+        Occluded,
+        OutsideFrustum
+    };
+
+    // minDepth - ближайшая глубина окклюдеров в текселе, maxDepth - глубина, за которой
+    // тексель закрыт целиком (1, если ни один треугольник не покрывает его полностью)
+    struct Level {
+        int width, height;
+        std::vector<float> minDepth;
+        std::vector<float> maxDepth;
+    };
+
+    int width;
+    int height;
+    size_t occluderTriangleBudget;
+    bool enabled = true;
+    // Покрытие базового уровня одним мешем, отдельно для каждой ориентации треугольников на экране
+    enum CoverageFlags : uint8_t {
+        Covered = 1,         // Центр текселя внутри треугольника
+        CrossesBoundary = 2  // Через тексель проходит ребро границы объединения
+    };
+
+    struct CoverageLayer {
+        std::vector<uint8_t> flags;
+        std::vector<float> farDepth; // Самая дальняя глубина задевающих тексель треугольников
+    };
+
+    struct TexelRect {
+        int minX, minY, maxX, maxY;
+    };
+
+    std::vector<Level> levels;
+    CoverageLayer coverage[2];
+    TexelRect meshRect{};
+    std::vector<int8_t> triangleState;
+    std::vector<Instance> modelInstances;
+    std::vector<ClipVertex> transformed;
+    Stats stats;
+
+    // Прямоугольник на экране и ближайшая глубина AABB
+    struct ScreenRect {
+        float minX, minY, maxX, maxY;
+        float minDepth;
+        bool crossesNear;
+    };
+
+    static bool projectBounds(const Mesh::Bounds& bounds, const float* viewProjection, ScreenRect& rect) {
+        rect = {1.0f, 1.0f, -1.0f, -1.0f, 1.0f, false};
+
+        for (int corner = 0; corner < 8; ++corner) {
+            float x = (corner & 1) ? bounds.max[0] : bounds.min[0];
+            float y = (corner & 2) ? bounds.max[1] : bounds.min[1];
+            float z = (corner & 4) ? bounds.max[2] : bounds.min[2];
+            ClipVertex v = ClipSpace::transform(viewProjection, x, y, z);
+
+            if (v.w <= 1e-5f || v.z < -v.w) {
+                rect.crossesNear = true;
+                continue;
+            }
+
+            float invW = 1.0f / v.w;
+            float nx = v.x * invW;
+            float ny = v.y * invW;
+            float depth = v.z * invW * 0.5f + 0.5f;
+
+            rect.minX = std::min(rect.minX, nx);
+            rect.maxX = std::max(rect.maxX, nx);
+            rect.minY = std::min(rect.minY, ny);
+            rect.maxY = std::max(rect.maxY, ny);
+            rect.minDepth = std::min(rect.minDepth, depth);
+        }
+
+        return !rect.crossesNear;
+    }
+
+    static bool isOutsideFrustum(const Mesh::Bounds& bounds, const float* viewProjection) {
+        int outside[6] = {0, 0, 0, 0, 0, 0};
+        for (int corner = 0; corner < 8; ++corner) {
+            float x = (corner & 1) ? bounds.max[0] : bounds.min[0];
+            float y = (corner & 2) ? bounds.max[1] : bounds.min[1];
+            float z = (corner & 4) ? bounds.max[2] : bounds.min[2];
+            ClipVertex v = ClipSpace::transform(viewProjection, x, y, z);
+
+            outside[0] += v.x > v.w;
+            outside[1] += v.x < -v.w;
+            outside[2] += v.y > v.w;
+            outside[3] += v.y < -v.w;
+            outside[4] += v.z > v.w;
+            outside[5] += v.z < -v.w;
+        }
+        return std::any_of(std::begin(outside), std::end(outside), [](int count) { return count == 8; });
+    }
+
+    void clearDepth() {
+        Level& base = levels.front();
+        std::fill(base.minDepth.begin(), base.minDepth.end(), 1.0f);
+        std::fill(base.maxDepth.begin(), base.maxDepth.end(), 1.0f);
+    }
+
+    // Растеризация без отсечения нелицевых граней: в minDepth остаётся ближайшая глубина по центру
+    // текселя. maxDepth меша получает тексель, только если тот целиком внутри объединения его
+    // треугольников одной ориентации на экране: центр текселя покрыт, и через тексель не проходит
+    // ни одно ребро границы объединения. Внутренние рёбра (соседи по Mesh::getEdgeNeighbors
+    // с той же ориентацией лежат по разные стороны) границей не считаются, поэтому плотная
+    // сетка закрывает тексели, хотя ни один её треугольник не покрывает тексель сам
+    void rasterizeOccluder(const Mesh& mesh, const float* viewProjection) {
+        const auto& indices = mesh.getIndices();
+        const auto& neighbors = mesh.getEdgeNeighbors();
+
+        transformed.resize(mesh.getVertexCount());
+        for (size_t i = 0; i < transformed.size(); ++i) {
+            Mesh::Vertex vertex = mesh.getVertex(i);
+            transformed[i] = ClipSpace::transform(viewProjection, vertex.x, vertex.y, vertex.z);
+        }
+
+        // 0 - треугольник не растеризуется, ±1 - ориентация на экране, 2 - отсечён ближней плоскостью
+        const size_t triangleCount = indices.size() / 3;
+        triangleState.assign(triangleCount, 0);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const ClipVertex& a = transformed[indices[t * 3]];
+            const ClipVertex& b = transformed[indices[t * 3 + 1]];
+            const ClipVertex& c = transformed[indices[t * 3 + 2]];
+            if (ClipSpace::isTriviallyOutside(a, b, c)) {
+                continue;
+            }
+            if (a.z < -a.w || b.z < -b.w || c.z < -c.w) {
+                triangleState[t] = 2;
+                continue;
+            }
+            // Площадь в текселях, с тем же порогом вырожденности, что в rasterizeDepth
+            float area = (b.x / b.w - a.x / a.w) * (c.y / c.w - a.y / a.w) - (c.x / c.w - a.x / a.w) * (b.y / b.w - a.y / a.w);
+            area *= 0.25f * static_cast<float>(width) * static_cast<float>(height);
+            if (std::fabs(area) >= 1e-8f) {
+                triangleState[t] = area > 0.0f ? 1 : -1;
+            }
+        }
+
+        meshRect = {width, height, -1, -1};
+        for (size_t t = 0; t < triangleCount; ++t) {
+            if (triangleState[t] == 0) {
+                continue;
+            }
+            ClipVertex triangle[3] = {transformed[indices[t * 3]], transformed[indices[t * 3 + 1]], transformed[indices[t * 3 + 2]]};
+            ++stats.occluderTriangles;
+
+            if (triangleState[t] != 2) {
+                // Ребро k идёт от вершины k к следующей, в rasterizeDepth оно напротив вершины (k + 2) % 3
+                bool boundary[3];
+                for (size_t k = 0; k < 3; ++k) {
+                    uint32_t neighbor = t * 3 + k < neighbors.size() ? neighbors[t * 3 + k] : Mesh::NoNeighbor;
+                    boundary[(k + 2) % 3] = neighbor == Mesh::NoNeighbor || triangleState[neighbor] != triangleState[t];
+                }
+                rasterizeDepth(triangle[0], triangle[1], triangle[2], boundary);
+                continue;
+            }
+
+            // Рёбра отсечённого многоугольника - граница, диагонали веера внутри него - нет
+            ClipVertex polygon[4];
+            size_t count = ClipSpace::clipNear(triangle, polygon);
+            for (size_t k = 1; k + 1 < count; ++k) {
+                bool boundary[3] = {true, k + 2 == count, k == 1};
+                rasterizeDepth(polygon[0], polygon[k], polygon[k + 1], boundary);
+            }
+        }
+
+        // Перенос закрытых текселей меша в maxDepth и очистка буферов покрытия
+        Level& base = levels.front();
+        for (int y = std::max(meshRect.minY, 0); y <= meshRect.maxY; ++y) {
+            for (int x = std::max(meshRect.minX, 0); x <= meshRect.maxX; ++x) {
+                size_t index = static_cast<size_t>(y) * width + x;
+                for (auto& layer : coverage) {
+                    if (layer.flags[index] == Covered) {
+                        base.maxDepth[index] = std::min(base.maxDepth[index], layer.farDepth[index]);
+                    }
+                    layer.flags[index] = 0;
+                    layer.farDepth[index] = 0.0f;
+                }
+            }
+        }
+    }
+
+    // boundary[k] - ребро напротив вершины k лежит на границе объединения. Проверки по углам
+    // текселя сделаны через смещение функции ребра на половину текселя (inset), глубина -
+    // через наклон плоскости треугольника, так что тексель получает самую дальнюю глубину
+    // треугольника в своих пределах, а не значение в центре
+    void rasterizeDepth(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c, const bool (&boundary)[3]) {
+        Level& target = levels.front();
+        auto toScreen = [&](const ClipVertex& v, float& sx, float& sy, float& sz) {
+            float invW = 1.0f / v.w;
+            sx = (v.x * invW * 0.5f + 0.5f) * static_cast<float>(target.width);
+            sy = (0.5f - v.y * invW * 0.5f) * static_cast<float>(target.height);
+            sz = v.z * invW * 0.5f + 0.5f;
+        };
+
+        float x0, y0, z0, x1, y1, z1, x2, y2, z2;
+        toScreen(a, x0, y0, z0);
+        toScreen(b, x1, y1, z1);
+        toScreen(c, x2, y2, z2);
+        bool edge0 = boundary[0], edge1 = boundary[1], edge2 = boundary[2];
+
+        float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+        if (std::fabs(area) < 1e-8f) {
+            return;
+        }
+        CoverageLayer& layer = coverage[area > 0.0f ? 0 : 1];
+        if (area < 0.0f) {
+            std::swap(x1, x2);
+            std::swap(y1, y2);
+            std::swap(z1, z2);
+            std::swap(edge1, edge2);
+            area = -area;
+        }
+
+        int minX = std::max(0, static_cast<int>(std::floor(std::min({x0, x1, x2}))));
+        int maxX = std::min(target.width - 1, static_cast<int>(std::floor(std::max({x0, x1, x2}))));
+        int minY = std::max(0, static_cast<int>(std::floor(std::min({y0, y1, y2}))));
+        int maxY = std::min(target.height - 1, static_cast<int>(std::floor(std::max({y0, y1, y2}))));
+        if (minX > maxX || minY > maxY) {
+            return;
+        }
+        meshRect = {std::min(meshRect.minX, minX), std::min(meshRect.minY, minY),
+                    std::max(meshRect.maxX, maxX), std::max(meshRect.maxY, maxY)};
+
+        float invArea = 1.0f / area;
+        // Наибольшее изменение функции ребра и глубины от центра до угла текселя; запас на округление
+        float inset0 = 0.5f * (std::fabs(x2 - x1) + std::fabs(y2 - y1)) * 1.0001f + 1e-4f;
+        float inset1 = 0.5f * (std::fabs(x0 - x2) + std::fabs(y0 - y2)) * 1.0001f + 1e-4f;
+        float inset2 = 0.5f * (std::fabs(x1 - x0) + std::fabs(y1 - y0)) * 1.0001f + 1e-4f;
+        float depthX = -((y2 - y1) * z0 + (y0 - y2) * z1 + (y1 - y0) * z2) * invArea;
+        float depthY = ((x2 - x1) * z0 + (x0 - x2) * z1 + (x1 - x0) * z2) * invArea;
+        float depthSpread = 0.5f * (std::fabs(depthX) + std::fabs(depthY));
+        float vertexFarthest = std::max({z0, z1, z2});
+
+        for (int y = minY; y <= maxY; ++y) {
+            float py = static_cast<float>(y) + 0.5f;
+            for (int x = minX; x <= maxX; ++x) {
+                float px = static_cast<float>(x) + 0.5f;
+                float w0 = (x2 - x1) * (py - y1) - (y2 - y1) * (px - x1);
+                float w1 = (x0 - x2) * (py - y2) - (y0 - y2) * (px - x2);
+                float w2 = (x1 - x0) * (py - y0) - (y1 - y0) * (px - x0);
+                if (w0 < -inset0 || w1 < -inset1 || w2 < -inset2) {
+                    continue; // Треугольник не задевает тексель
+                }
+
+                size_t index = static_cast<size_t>(y) * target.width + x;
+                float depth = (w0 * z0 + w1 * z1 + w2 * z2) * invArea;
+                if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f) {
+                    target.minDepth[index] = std::min(target.minDepth[index], depth);
+                    layer.flags[index] |= Covered;
+                }
+                if ((edge0 && w0 <= inset0) || (edge1 && w1 <= inset1) || (edge2 && w2 <= inset2)) {
+                    layer.flags[index] |= CrossesBoundary;
+                }
+                float farthest = std::min({1.0f, depth + depthSpread, vertexFarthest});
+                layer.farDepth[index] = std::max(layer.farDepth[index], farthest);
+            }
+        }
+    }
+
+    void buildHierarchy() {
+        for (size_t l = 1; l < levels.size(); ++l) {
+            const Level& src = levels[l - 1];
+            Level& dst = levels[l];
+
+            for (int y = 0; y < dst.height; ++y) {
+                for (int x = 0; x < dst.width; ++x) {
+                    float nearest = 1.0f;
+                    float farthest = 0.0f;
+                    for (int dy = 0; dy < 2; ++dy) {
+                        for (int dx = 0; dx < 2; ++dx) {
+                            int sx = std::min(x * 2 + dx, src.width - 1);
+                            int sy = std::min(y * 2 + dy, src.height - 1);
+                            size_t index = static_cast<size_t>(sy) * src.width + sx;
+                            nearest = std::min(nearest, src.minDepth[index]);
+                            farthest = std::max(farthest, src.maxDepth[index]);
+                        }
+                    }
+                    size_t index = static_cast<size_t>(y) * dst.width + x;
+                    dst.minDepth[index] = nearest;
+                    dst.maxDepth[index] = farthest;
+                }
+            }
+        }
+    }
+
+    Result test(const Mesh::Bounds& bounds, const float* viewProjection) const {
+        if (isOutsideFrustum(bounds, viewProjection)) {
+            return Result::OutsideFrustum;
+        }
+
+        ScreenRect rect{};
+        if (!projectBounds(bounds, viewProjection, rect)) {
+            return Result::Visible;
+        }
+
+        const Level& base = levels.front();
+        int x0 = std::max(0, static_cast<int>(std::floor((rect.minX * 0.5f + 0.5f) * base.width)));
+        int x1 = std::min(base.width - 1, static_cast<int>(std::floor((rect.maxX * 0.5f + 0.5f) * base.width)));
+        int y0 = std::max(0, static_cast<int>(std::floor((0.5f - rect.maxY * 0.5f) * base.height)));
+        int y1 = std::min(base.height - 1, static_cast<int>(std::floor((0.5f - rect.minY * 0.5f) * base.height)));
+        if (x0 > x1 || y0 > y1) {
+            return Result::OutsideFrustum;
+        }
+
+        // Уровень, на котором прямоугольник занимает не больше 2x2 текселей
+        size_t level = 0;
+        while (level + 1 < levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+            ++level;
+        }
+
+        const Level& lod = levels[level];
+        float nearest = 1.0f;
+        float farthest = 0.0f;
+        for (int y = y0 >> level; y <= std::min(y1 >> level, lod.height - 1); ++y) {
+            for (int x = x0 >> level; x <= std::min(x1 >> level, lod.width - 1); ++x) {
+                size_t index = static_cast<size_t>(y) * lod.width + x;
+                nearest = std::min(nearest, lod.minDepth[index]);
+                farthest = std::max(farthest, lod.maxDepth[index]);
+            }
+        }
+
+        constexpr float epsilon = 1e-5f;
+        if (rect.minDepth <= nearest) {
+            return Result::Visible; // Ближе всех окклюдеров в области
+        }
+        return rect.minDepth > farthest + epsilon ? Result::Occluded : Result::Visible;
+    }
+
+public:
+    explicit OcclusionCuller(int w = 256, int h = 128, size_t triangleBudget = 32768)
+            : width(std::max(w, 1)), height(std::max(h, 1)), occluderTriangleBudget(triangleBudget) {
+        int lw = width;
+        int lh = height;
+        while (true) {
+            levels.push_back(Level{lw, lh,
+                                   std::vector<float>(static_cast<size_t>(lw) * lh, 1.0f),
+                                   std::vector<float>(static_cast<size_t>(lw) * lh, 1.0f)});
+            if (lw == 1 && lh == 1) {
+                break;
+            }
+            lw = std::max(1, (lw + 1) / 2);
+            lh = std::max(1, (lh + 1) / 2);
+        }
+        for (auto& layer : coverage) {
+            layer.flags.assign(static_cast<size_t>(width) * height, 0);
+            layer.farDepth.assign(static_cast<size_t>(width) * height, 0.0f);
+        }
+    }
+
+    void setEnabled(bool value) { enabled = value; }
+    [[nodiscard]] bool isEnabled() const { return enabled; }
+
+    [[nodiscard]] const Stats& getStats() const { return stats; }
+
+    // viewProjection - матрица 4x4 в столбцовом порядке, модель в мировых координатах
+    void cull(const Model3D& model, const float* viewProjection, std::vector<MeshVisibility>& visibility) {
+        modelInstances.clear();
+        for (const auto& mesh : model.getMeshes()) {
+            modelInstances.push_back(Instance{mesh.get(), viewProjection});
+        }
+        cull(modelInstances, visibility);
+    }
+
+    // Меши с разными матрицами модели; visibility[i] соответствует instances[i]
+    void cull(const std::vector<Instance>& instances, std::vector<MeshVisibility>& visibility) {
+        OBJVIEWER_TRACE_SCOPE("OcclusionCuller::cull");
+        visibility.resize(instances.size());
+        stats = Stats{};
+
+        for (size_t i = 0; i < instances.size(); ++i) {
+            visibility[i].visible = true;
+            visibility[i].ranges.assign(1, Range{0, static_cast<uint32_t>(instances[i].mesh->getIndices().size())});
+            stats.trianglesTotal += instances[i].mesh->getIndices().size() / 3;
+        }
+
+        if (!enabled) {
+            return;
+        }
+
+        // Окклюдеры: меши с наибольшей площадью проекции, пока не исчерпан бюджет треугольников
+        std::vector<std::pair<float, size_t>> candidates;
+        for (size_t i = 0; i < instances.size(); ++i) {
+            ScreenRect rect{};
+            if (!projectBounds(instances[i].mesh->getBounds(), instances[i].viewProjection, rect)) {
+                continue;
+            }
+            float area = std::max(0.0f, rect.maxX - rect.minX) * std::max(0.0f, rect.maxY - rect.minY);
+            candidates.emplace_back(area, i);
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first;
+        });
+
+        clearDepth();
+        size_t budgetLeft = occluderTriangleBudget;
+        for (const auto& [area, index] : candidates) {
+            size_t triangles = instances[index].mesh->getIndices().size() / 3;
+            if (triangles > budgetLeft && stats.occluderTriangles > 0) {
+                continue;
+            }
+            rasterizeOccluder(*instances[index].mesh, instances[index].viewProjection);
+            budgetLeft -= std::min(budgetLeft, triangles);
+        }
+        buildHierarchy();
+
+        for (size_t i = 0; i < instances.size(); ++i) {
+            const Mesh& mesh = *instances[i].mesh;
+            const float* viewProjection = instances[i].viewProjection;
+            MeshVisibility& result = visibility[i];
+            size_t meshTriangles = mesh.getIndices().size() / 3;
+
+            ++stats.meshesTested;
+            Result meshResult = test(mesh.getBounds(), viewProjection);
+            if (meshResult != Result::Visible) {
+                result.visible = false;
+                result.ranges.clear();
+                if (meshResult == Result::Occluded) {
+                    ++stats.meshesOccluded;
+                    stats.trianglesOccluded += meshTriangles;
+                } else {
+                    ++stats.meshesOutsideFrustum;
+                    stats.trianglesOutsideFrustum += meshTriangles;
+                }
+                continue;
+            }
+
+            const auto& clusters = mesh.getClusters();
+            if (clusters.size() < 2) {
+                continue;
+            }
+
+            result.ranges.clear();
+            for (const auto& cluster : clusters) {
+                ++stats.clustersTested;
+                Result clusterResult = test(cluster.bounds, viewProjection);
+                if (clusterResult == Result::Occluded) {
+                    ++stats.clustersOccluded;
+                    stats.trianglesOccluded += cluster.indexCount / 3;
+                    continue;
+                }
+                if (clusterResult == Result::OutsideFrustum) {
+                    stats.trianglesOutsideFrustum += cluster.indexCount / 3;
+                    continue;
+                }
+
+                if (!result.ranges.empty() &&
+                    result.ranges.back().firstIndex + result.ranges.back().indexCount == cluster.firstIndex) {
+                    result.ranges.back().indexCount += cluster.indexCount;
+                } else {
+                    result.ranges.push_back(Range{cluster.firstIndex, cluster.indexCount});
+                }
+            }
+            result.visible = !result.ranges.empty();
+        }
+    }
+};
+
+#endif //OBJVIEWER_OCCLUSIONCULLER_H
@@ -0,0 +1,223 @@
+#ifndef OBJVIEWER_RENDERSTATS_H
+#define OBJVIEWER_RENDERSTATS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// Счётчики одного кадра, общие для всех бэкендов. Что бэкенд измерить не может
+// (отсечение задних граней и закрашенные пиксели на GPU), остаётся нулём
+struct FrameStats {
+    enum Stage : size_t {
+        Setup,      // Очистка, камера, список отрисовки
+        Cull,       // Отсечение по пирамиде видимости и перекрытию
+        Transform,  // Преобразование вершин на CPU
+        Draw,       // Растеризация у программных бэкендов, отправка команд у GPU
+        Present,    // Вывод готового кадра
+        StageCount
+    };
+
+    size_t trianglesSubmitted = 0;
+    size_t trianglesBackfaceCulled = 0;
+    size_t trianglesFrustumCulled = 0;
+    size_t trianglesOccluded = 0;
+    size_t trianglesRasterized = 0;
+    size_t pixelsShaded = 0;
+    size_t drawCalls = 0;
+    size_t stateChanges = 0;  // Смены программы, текстуры, материала или смешивания между вызовами отрисовки
+    size_t bufferUploads = 0; // Загрузки геометрии и констант в бэкенд, в том числе между кадрами
+    std::array<double, StageCount> stageMilliseconds{};
+    double frameMilliseconds = 0.0;
+
+    static const char* stageName(Stage stage) {
+        static constexpr const char* names[StageCount] = {"setup", "cull", "transform", "draw", "present"};
+        return stage < StageCount ? names[stage] : "unknown";
+    }
+};
+
+// Время последних кадров в скользящем окне. Процентили точные: окно сортируется
+// при запросе, а не раскладывается по корзинам, поэтому запрашивать их стоит раз в секунду, а не каждый кадр
+class FrameTimeHistogram {
+public:
+    struct Summary {
+        size_t frames = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+private:
+    std::vector<double> samples;
+    size_t capacity;
+    size_t next = 0;
+
+    // Ближайший ранг: наименьшее значение, не меньше которого p% выборки
+    static double rank(const std::vector<double>& sorted, double percent) {
+        double position = std::ceil(percent / 100.0 * static_cast<double>(sorted.size()));
+        size_t index = static_cast<size_t>(std::clamp(position, 1.0, static_cast<double>(sorted.size()))) - 1;
+        return sorted[index];
+    }
+
+public:
+    explicit FrameTimeHistogram(size_t windowSize = 512) : capacity(std::max<size_t>(windowSize, 1)) {
+        samples.reserve(capacity);
+    }
+
+    void add(double milliseconds) {
+        if (samples.size() < capacity) {
+            samples.push_back(milliseconds);
+        } else {
+            samples[next] = milliseconds;
+        }
+        next = (next + 1) % capacity;
+    }
+
+    void clear() {
+        samples.clear();
+        next = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return samples.size(); }
+    [[nodiscard]] size_t windowSize() const { return capacity; }
+
+    [[nodiscard]] double percentile(double percent) const {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        return rank(sorted, percent);
+    }
+
+    [[nodiscard]] Summary summarize() const {
+        Summary summary;
+        if (samples.empty()) {
+            return summary;
+        }
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for (double sample : sorted) {
+            total += sample;
+        }
+        summary.frames = sorted.size();
+        summary.mean = total / static_cast<double>(sorted.size());
+        summary.p50 = rank(sorted, 50.0);
+        summary.p95 = rank(sorted, 95.0);
+        summary.p99 = rank(sorted, 99.0);
+        summary.max = sorted.back();
+        return summary;
+    }
+};
+
+// Статистика кадров бэкенда: бэкенд заполняет frame() между beginFrame и endFrame,
+// этапы замеряет через time(). Счётчики, добавленные вне кадра (загрузка меша),
+// попадают в следующий кадр. Бюджет кадра задаётся в миллисекундах, превышения считаются
+class RenderStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class StageTimer {
+    private:
+        FrameStats* frame;
+        FrameStats::Stage stage;
+        Clock::time_point start;
+
+    public:
+        StageTimer(FrameStats& target, FrameStats::Stage timedStage)
+                : frame(&target), stage(timedStage), start(Clock::now()) {}
+
+        ~StageTimer() {
+            frame->stageMilliseconds[stage] += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+    };
+
+private:
+    FrameStats current;
+    FrameStats last;
+    FrameTimeHistogram frameTimes;
+    Clock::time_point frameStart{};
+    size_t frames = 0;
+    size_t framesOverBudget = 0;
+    double budgetMilliseconds = 0.0;
+
+public:
+    explicit RenderStats(size_t windowSize = 512) : frameTimes(windowSize) {}
+
+    void beginFrame() { frameStart = Clock::now(); }
+
+    // Счётчики текущего, ещё не законченного кадра
+    [[nodiscard]] FrameStats& frame() { return current; }
+
+    [[nodiscard]] StageTimer time(FrameStats::Stage stage) { return StageTimer(current, stage); }
+
+    void endFrame() {
+        current.frameMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+        frameTimes.add(current.frameMilliseconds);
+        ++frames;
+        if (budgetMilliseconds > 0.0 && current.frameMilliseconds > budgetMilliseconds) {
+            ++framesOverBudget;
+        }
+        last = current;
+        current = FrameStats{};
+    }
+
+    // 0 - без бюджета
+    void setFrameBudget(double milliseconds) { budgetMilliseconds = milliseconds; }
+    [[nodiscard]] double getFrameBudget() const { return budgetMilliseconds; }
+    [[nodiscard]] size_t getFramesOverBudget() const { return framesOverBudget; }
+
+    // Превышает ли p95 окна бюджет; без бюджета всегда false
+    [[nodiscard]] bool isOverBudget() const {
+        return budgetMilliseconds > 0.0 && frameTimes.percentile(95.0) > budgetMilliseconds;
+    }
+
+    [[nodiscard]] const FrameStats& lastFrame() const { return last; }
+    [[nodiscard]] const FrameTimeHistogram& getFrameTimes() const { return frameTimes; }
+    [[nodiscard]] size_t getFrameCount() const { return frames; }
+
+    void reset() {
+        current = FrameStats{};
+        last = FrameStats{};
+        frameTimes.clear();
+        frames = 0;
+        framesOverBudget = 0;
+    }
+
+    void print(std::ostream& out) const {
+        const auto summary = frameTimes.summarize();
+        out << "frames " << frames << " (window " << summary.frames << "), frame ms"
+            << " mean " << summary.mean << " p50 " << summary.p50 << " p95 " << summary.p95
+            << " p99 " << summary.p99 << " max " << summary.max;
+        if (budgetMilliseconds > 0.0) {
+            out << ", budget " << budgetMilliseconds << " ms, over budget " << framesOverBudget;
+        }
+        out << '\n';
+
+        out << "last frame: triangles " << last.trianglesSubmitted << " submitted, "
+            << last.trianglesBackfaceCulled << " back-face culled, "
+            << last.trianglesFrustumCulled << " frustum culled, "
+            << last.trianglesOccluded << " occluded, "
+            << last.trianglesRasterized << " rasterized; pixels " << last.pixelsShaded
+            << "; draw calls " << last.drawCalls << ", state changes " << last.stateChanges
+            << ", buffer uploads " << last.bufferUploads << '\n';
+
+        out << "stage ms:";
+        for (size_t stage = 0; stage < FrameStats::StageCount; ++stage) {
+            out << ' ' << FrameStats::stageName(static_cast<FrameStats::Stage>(stage)) << ' ' << last.stageMilliseconds[stage];
+        }
+        out << '\n';
+    }
+};
+
+#endif //OBJVIEWER_RENDERSTATS_H
@@ -3,25 +3,82 @@
 
 #include <string>
 #include <memory>
+#include <functional>
+#include <vector>
 #include "../model/obj/OBJModel.h"
+#include "../model/math/Matrix4x4.h"
+#include "Camera.h"
+#include "MeshRegistry.h"
 #include "../controller/IEventHandler.h"
+#include "../controller/EventQueue.h"
 #include "../model/loaders/ILoader.h"
 #include "../controller/Triangle.h"
+#include "../core/Trace.h"
+#include "RenderStats.h"
 
+// Интерфейс рендера с удержанием ресурсов: геометрия загружается один раз через createMesh,
+// бэкенд хранит её в удобном ему виде, а кадр состоит только из коротких записей draw(handle).
+// Кадр строит функция из setFrameCallback - бэкенд вызывает её, когда ему нужно перерисоваться
 class Renderer {
+private:
+    std::function<void(Renderer&)> frameCallback;
+    std::vector<DrawRecord> drawList;
+
+protected:
+    RenderStats renderStats; // Заполняется бэкендом в каждом кадре
+
+    // Список записей текущего кадра; вызывается бэкендом в начале кадра
+    const std::vector<DrawRecord>& collectDrawList() {
+        drawList.clear();
+        if (frameCallback) {
+            frameCallback(*this);
+        }
+        return drawList;
+    }
+
 public:
     virtual ~Renderer() = default;
     IEventHandler* eventHandler{nullptr};
+    EventQueue* eventQueue{nullptr};
 
     virtual void setEventHandler(IEventHandler* handler) = 0;
+    void setEventQueue(EventQueue* queue) { eventQueue = queue; }
+
+    void postEvent(Event event) {
+        if (eventQueue) {
+            eventQueue->post(std::move(event));
+        } else if (eventHandler) {
+            eventHandler->handleEvent(event);
+        }
+    }
+
+    void dispatchEvents() {
+        if (eventQueue && eventHandler) {
+            eventQueue->dispatch(*eventHandler);
+        }
+    }
     virtual void setCamera(std::shared_ptr<Camera> camera) = 0;
 
     [[nodiscard]] virtual bool initialize() = 0;
-    virtual void render(const std::vector<Triangle>& triangles) = 0;
     virtual void cleanup() = 0;
-    virtual void updateModel(std::vector<Triangle>) = 0;
     virtual void run() = 0;
 
+    // Ресурсы: треугольники копируются в бэкенд, вызывающий может их сразу освободить
+    [[nodiscard]] virtual MeshHandle createMesh(const std::vector<Triangle>& triangles) = 0;
+    virtual void destroyMesh(MeshHandle mesh) = 0;
+    virtual void updateTransform(MeshHandle mesh, const VecMath::Matrix4x4<float>& transform) = 0;
+
+    // Кадр
+    void setFrameCallback(std::function<void(Renderer&)> callback) { frameCallback = std::move(callback); }
+    void draw(MeshHandle mesh) { drawList.push_back(DrawRecord{mesh}); }
+    virtual void requestFrame() = 0;
+
+    virtual void showError(const std::string& message) = 0;
+
+    // Счётчики и время кадров; бюджет кадра задаётся через getRenderStats().setFrameBudget
+    [[nodiscard]] RenderStats& getRenderStats() { return renderStats; }
+    [[nodiscard]] const RenderStats& getRenderStats() const { return renderStats; }
+
     [[nodiscard]] virtual bool isInitialized() const { return true; }
 };
 
@@ -0,0 +1,370 @@
+#ifndef OBJVIEWER_SOFTWARERASTERIZER_H
+#define OBJVIEWER_SOFTWARERASTERIZER_H
+
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include "ClipSpace.h"
+#include "FrameBuffer.h"
+#include "OcclusionCuller.h"
+#include "../model/math/Vector3D.h"
+#include "../model/math/Matrix4x4.h"
+#include "../models/Model3D.h"
+
+// Программный растеризатор без оконной системы: z-буфер, освещение по Гуро.
+// Подмеши, у материала которых есть текстура (Model3D::getTexture), текстурируются
+// с перспективной коррекцией; уровень mip выбирается на треугольник
+class SoftwareRasterizer {
+public:
+    struct Stats {
+        size_t trianglesSubmitted = 0;
+        size_t trianglesBackfaceCulled = 0;
+        size_t trianglesFrustumCulled = 0;
+        size_t trianglesRasterized = 0;
+        size_t pixelsShaded = 0;
+        double transformMilliseconds = 0.0; // Умножение вершин на матрицу, остальное время - растеризация
+    };
+
+    // Вершины меша в мировых координатах (w = 1) с уже посчитанным освещением.
+    // От камеры не зависят, поэтому для нескольких видов готовятся один раз
+    struct PreparedMesh {
+        const Mesh* mesh = nullptr;
+        std::vector<ClipVertex> vertices;
+    };
+
+private:
+    VecMath::Matrix4x4<float> viewProjection;
+    VecMath::Vector3D<float> lightDirection{0.0f, 0.0f, 1.0f};
+    VecMath::Vector3D<float> baseColor{0.8f, 0.8f, 0.8f};
+    float ambient = 0.2f;
+    bool backfaceCulling = true;
+    OcclusionCuller* occlusionCuller = nullptr;
+    const Model3D* texturedModel = nullptr; // Модель текущего drawModel, если у неё есть текстуры
+    std::vector<OcclusionCuller::MeshVisibility> visibility;
+    PreparedMesh prepared;
+    std::vector<ClipVertex> transformed;
+    Stats stats;
+
+    struct ScreenVertex {
+        float x, y, z;
+        float intensity;
+        float invW;   // Для перспективной коррекции текстурных координат
+        float u, v;   // Уже умножены на invW
+    };
+
+    static ScreenVertex toScreen(const ClipVertex& v, int width, int height) {
+        float invW = 1.0f / v.w;
+        return ScreenVertex{
+                (v.x * invW * 0.5f + 0.5f) * static_cast<float>(width),
+                (0.5f - v.y * invW * 0.5f) * static_cast<float>(height),
+                v.z * invW * 0.5f + 0.5f,
+                v.intensity,
+                invW,
+                v.u * invW,
+                v.v * invW
+        };
+    }
+
+    // Уровень mip по отношению площади треугольника в текселях к его площади в пикселях
+    static size_t mipLevel(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c, int64_t area, const Texture& texture) {
+        const float ua = a.u / a.invW, va = a.v / a.invW;
+        const float ub = b.u / b.invW, vb = b.v / b.invW;
+        const float uc = c.u / c.invW, vc = c.v / c.invW;
+        const float texels = std::abs((ub - ua) * (vc - va) - (uc - ua) * (vb - va)) *
+                             static_cast<float>(texture.getWidth()) * static_cast<float>(texture.getHeight());
+        const float pixels = static_cast<float>(area) / static_cast<float>(SubpixelScale * SubpixelScale);
+        if (texels <= pixels) {
+            return 0;
+        }
+        return std::min(static_cast<size_t>(0.5f * std::log2(texels / pixels)), texture.getLevelCount() - 1);
+    }
+
+    float shade(float nx, float ny, float nz) const {
+        float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (length == 0.0f) {
+            return -1.0f; // Нормали нет - освещение считается по грани
+        }
+        float diffuse = (nx * lightDirection.x + ny * lightDirection.y + nz * lightDirection.z) / length;
+        return ambient + std::max(0.0f, diffuse);
+    }
+
+    float shadeFace(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) const {
+        float e1x = b.x - a.x, e1y = b.y - a.y, e1z = b.z - a.z;
+        float e2x = c.x - a.x, e2y = c.y - a.y, e2z = c.z - a.z;
+        float intensity = shade(e1y * e2z - e1z * e2y, e1z * e2x - e1x * e2z, e1x * e2y - e1y * e2x);
+        return intensity < 0.0f ? ambient : intensity;
+    }
+
+    // Вершины привязываются к сетке 1/16 пикселя, рёберные функции считаются
+    // в целых числах с правилом "верхний-левый", поэтому соседние треугольники стыкуются без щелей
+    static constexpr int SubpixelBits = 4;
+    static constexpr int64_t SubpixelScale = 1 << SubpixelBits;
+
+    static bool isTopLeft(int64_t dx, int64_t dy) {
+        return (dy == 0 && dx > 0) || dy < 0;
+    }
+
+    template <bool Textured>
+    void rasterizeTriangle(const ScreenVertex& a, ScreenVertex b, ScreenVertex c, const Texture* texture, FrameBuffer& target) {
+        auto snap = [](float value) { return static_cast<int64_t>(std::lround(value * static_cast<float>(SubpixelScale))); };
+
+        int64_t ax = snap(a.x), ay = snap(a.y);
+        int64_t bx = snap(b.x), by = snap(b.y);
+        int64_t cx = snap(c.x), cy = snap(c.y);
+
+        // Экран с осью y вниз: лицевые (против часовой стрелки в NDC) треугольники имеют отрицательную площадь
+        int64_t area = (bx - ax) * (cy - ay) - (cx - ax) * (by - ay);
+        if (area == 0) {
+            return;
+        }
+        if (area > 0) {
+            if (backfaceCulling) {
+                ++stats.trianglesBackfaceCulled;
+                return;
+            }
+        } else {
+            std::swap(b, c);
+            std::swap(bx, cx);
+            std::swap(by, cy);
+            area = -area;
+        }
+
+        const int width = target.getWidth();
+        const int height = target.getHeight();
+        int minX = std::max<int64_t>(0, std::min({ax, bx, cx}) >> SubpixelBits);
+        int maxX = static_cast<int>(std::min<int64_t>(width - 1, std::max({ax, bx, cx}) >> SubpixelBits));
+        int minY = std::max<int64_t>(0, std::min({ay, by, cy}) >> SubpixelBits);
+        int maxY = static_cast<int>(std::min<int64_t>(height - 1, std::max({ay, by, cy}) >> SubpixelBits));
+        if (minX > maxX || minY > maxY) {
+            return;
+        }
+
+        ++stats.trianglesRasterized;
+
+        // w0 - ребро b->c, w1 - ребро c->a, w2 - ребро a->b; внутри треугольника все >= 0
+        const int64_t bias0 = isTopLeft(cx - bx, cy - by) ? 0 : -1;
+        const int64_t bias1 = isTopLeft(ax - cx, ay - cy) ? 0 : -1;
+        const int64_t bias2 = isTopLeft(bx - ax, by - ay) ? 0 : -1;
+
+        const int64_t step0 = -(cy - by) * SubpixelScale;
+        const int64_t step1 = -(ay - cy) * SubpixelScale;
+        const int64_t step2 = -(by - ay) * SubpixelScale;
+
+        const float invArea = 1.0f / static_cast<float>(area);
+        const size_t level = Textured ? mipLevel(a, b, c, area, *texture) : 0;
+        uint32_t* color = target.colorData();
+        float* depth = target.depthData();
+
+        for (int y = minY; y <= maxY; ++y) {
+            int64_t py = static_cast<int64_t>(y) * SubpixelScale + SubpixelScale / 2;
+            int64_t px = static_cast<int64_t>(minX) * SubpixelScale + SubpixelScale / 2;
+            int64_t w0 = (cx - bx) * (py - by) - (cy - by) * (px - bx) + bias0;
+            int64_t w1 = (ax - cx) * (py - cy) - (ay - cy) * (px - cx) + bias1;
+            int64_t w2 = (bx - ax) * (py - ay) - (by - ay) * (px - ax) + bias2;
+
+            size_t row = static_cast<size_t>(y) * width;
+            for (int x = minX; x <= maxX; ++x, w0 += step0, w1 += step1, w2 += step2) {
+                if ((w0 | w1 | w2) < 0) {
+                    continue;
+                }
+
+                float l0 = static_cast<float>(w0 - bias0) * invArea;
+                float l1 = static_cast<float>(w1 - bias1) * invArea;
+                float l2 = 1.0f - l0 - l1;
+                float z = l0 * a.z + l1 * b.z + l2 * c.z;
+                float& stored = depth[row + x];
+                if (z < 0.0f || z >= stored) {
+                    continue;
+                }
+                stored = z;
+
+                float intensity = l0 * a.intensity + l1 * b.intensity + l2 * c.intensity;
+                if constexpr (Textured) {
+                    // Текстура заменяет базовый цвет, как map_Kd заменяет Kd
+                    const float w = 1.0f / (l0 * a.invW + l1 * b.invW + l2 * c.invW);
+                    const uint32_t texel = texture->sample((l0 * a.u + l1 * b.u + l2 * c.u) * w, (l0 * a.v + l1 * b.v + l2 * c.v) * w, level);
+                    const float scale = intensity / 255.0f;
+                    color[row + x] = FrameBuffer::packColor(static_cast<float>(texel & 0xFF) * scale, static_cast<float>((texel >> 8) & 0xFF) * scale,
+                                                            static_cast<float>((texel >> 16) & 0xFF) * scale);
+                } else {
+                    color[row + x] = FrameBuffer::packColor(baseColor.x * intensity, baseColor.y * intensity, baseColor.z * intensity);
+                }
+                ++stats.pixelsShaded;
+            }
+        }
+    }
+
+public:
+    void setViewProjection(const VecMath::Matrix4x4<float>& matrix) { viewProjection = matrix; }
+    [[nodiscard]] const VecMath::Matrix4x4<float>& getViewProjection() const { return viewProjection; }
+
+    // Направление на источник света в мировых координатах
+    void setLightDirection(const VecMath::Vector3D<float>& direction) { lightDirection = direction.normalized(); }
+    void setBaseColor(const VecMath::Vector3D<float>& color) { baseColor = color; }
+    void setBackfaceCulling(bool enabled) { backfaceCulling = enabled; }
+
+    // Отсечение перекрытых мешей и кластеров перед растеризацией (nullptr - выключено)
+    void setOcclusionCuller(OcclusionCuller* culler) { occlusionCuller = culler; }
+
+    [[nodiscard]] const Stats& getStats() const { return stats; }
+    void resetStats() { stats = Stats{}; }
+
+    void drawModel(const Model3D& model, FrameBuffer& target) {
+        const auto& meshes = model.getMeshes();
+        texturedModel = model.hasTextures() ? &model : nullptr;
+
+        if (occlusionCuller) {
+            occlusionCuller->cull(model, viewProjection.data(), visibility);
+            for (size_t i = 0; i < meshes.size(); ++i) {
+                if (visibility[i].visible) {
+                    drawMesh(*meshes[i], visibility[i].ranges, target);
+                }
+            }
+        } else {
+            for (const auto& mesh : meshes) {
+                drawMesh(*mesh, target);
+            }
+        }
+        texturedModel = nullptr;
+    }
+
+    // meshes - результат prepareMesh для каждого меша модели в порядке getMeshes()
+    void drawPrepared(const Model3D& model, const std::vector<PreparedMesh>& meshes, FrameBuffer& target) {
+        texturedModel = model.hasTextures() ? &model : nullptr;
+        if (occlusionCuller) {
+            occlusionCuller->cull(model, viewProjection.data(), visibility);
+            for (size_t i = 0; i < meshes.size(); ++i) {
+                if (visibility[i].visible) {
+                    drawPrepared(meshes[i], visibility[i].ranges, target);
+                }
+            }
+        } else {
+            for (const auto& mesh : meshes) {
+                drawPrepared(mesh, target);
+            }
+        }
+        texturedModel = nullptr;
+    }
+
+    void drawMesh(const Mesh& mesh, FrameBuffer& target) {
+        prepareMesh(mesh, prepared);
+        drawPrepared(prepared, target);
+    }
+
+    void drawMesh(const Mesh& mesh, const std::vector<OcclusionCuller::Range>& ranges, FrameBuffer& target) {
+        prepareMesh(mesh, prepared);
+        drawPrepared(prepared, ranges, target);
+    }
+
+    // Распаковка вершин и освещение; результат зависит только от меша и направления света
+    void prepareMesh(const Mesh& mesh, PreparedMesh& result) const {
+        result.mesh = &mesh;
+        result.vertices.resize(mesh.getVertexCount());
+        for (size_t i = 0; i < result.vertices.size(); ++i) {
+            Mesh::Vertex vertex = mesh.getVertex(i);
+            result.vertices[i] = ClipVertex{vertex.x, vertex.y, vertex.z, 1.0f,
+                                            shade(vertex.nx, vertex.ny, vertex.nz), vertex.u, vertex.v};
+        }
+    }
+
+    // То же для меша с матрицей модели: позиции остаются в координатах меша (матрица модели
+    // входит в setViewProjection), нормали для освещения переводятся матрицей нормалей
+    // (Matrix4x4::inverseTranspose), один раз на меш, а не на каждый кадр
+    void prepareMesh(const Mesh& mesh, const VecMath::Matrix4x4<float>& normalMatrix, PreparedMesh& result) const {
+        const VecMath::Matrix4x4<float>& n = normalMatrix;
+        result.mesh = &mesh;
+        result.vertices.resize(mesh.getVertexCount());
+        for (size_t i = 0; i < result.vertices.size(); ++i) {
+            Mesh::Vertex vertex = mesh.getVertex(i);
+            float nx = n.m00 * vertex.nx + n.m01 * vertex.ny + n.m02 * vertex.nz;
+            float ny = n.m10 * vertex.nx + n.m11 * vertex.ny + n.m12 * vertex.nz;
+            float nz = n.m20 * vertex.nx + n.m21 * vertex.ny + n.m22 * vertex.nz;
+            result.vertices[i] = ClipVertex{vertex.x, vertex.y, vertex.z, 1.0f, shade(nx, ny, nz), vertex.u, vertex.v};
+        }
+    }
+
+    void drawPrepared(const PreparedMesh& mesh, FrameBuffer& target) {
+        transformVertices(mesh);
+        drawTriangles(mesh, 0, mesh.mesh->getIndices().size(), target);
+    }
+
+    void drawPrepared(const PreparedMesh& mesh, const std::vector<OcclusionCuller::Range>& ranges, FrameBuffer& target) {
+        transformVertices(mesh);
+        for (const auto& range : ranges) {
+            drawTriangles(mesh, range.firstIndex, static_cast<size_t>(range.firstIndex) + range.indexCount, target);
+        }
+    }
+
+private:
+    void transformVertices(const PreparedMesh& mesh) {
+        const auto start = std::chrono::steady_clock::now();
+        const float* matrix = viewProjection.data();
+
+        transformed.resize(mesh.vertices.size());
+        for (size_t i = 0; i < transformed.size(); ++i) {
+            const ClipVertex& vertex = mesh.vertices[i];
+            transformed[i] = ClipSpace::transform(matrix, vertex.x, vertex.y, vertex.z);
+            transformed[i].intensity = vertex.intensity;
+            transformed[i].u = vertex.u;
+            transformed[i].v = vertex.v;
+        }
+        stats.transformMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Отрезок индексов делится по подмешам, если у модели есть текстуры
+    void drawTriangles(const PreparedMesh& mesh, size_t begin, size_t end, FrameBuffer& target) {
+        if (!texturedModel) {
+            drawTriangles(mesh, begin, end, nullptr, target);
+            return;
+        }
+        for (const auto& submesh : mesh.mesh->getSubmeshes()) {
+            const size_t first = std::max<size_t>(begin, submesh.firstIndex);
+            const size_t last = std::min<size_t>(end, static_cast<size_t>(submesh.firstIndex) + submesh.indexCount);
+            if (first < last) {
+                drawTriangles(mesh, first, last, texturedModel->getTexture(submesh.material), target);
+            }
+        }
+    }
+
+    void drawTriangles(const PreparedMesh& mesh, size_t begin, size_t end, const Texture* texture, FrameBuffer& target) {
+        const auto& indices = mesh.mesh->getIndices();
+        end = std::min(end, indices.size());
+
+        for (size_t i = begin; i + 2 < end; i += 3) {
+            ++stats.trianglesSubmitted;
+
+            ClipVertex triangle[3] = {transformed[indices[i]], transformed[indices[i + 1]], transformed[indices[i + 2]]};
+            if (ClipSpace::isTriviallyOutside(triangle[0], triangle[1], triangle[2])) {
+                ++stats.trianglesFrustumCulled;
+                continue;
+            }
+
+            if (triangle[0].intensity < 0.0f || triangle[1].intensity < 0.0f || triangle[2].intensity < 0.0f) {
+                float intensity = shadeFace(mesh.vertices[indices[i]], mesh.vertices[indices[i + 1]], mesh.vertices[indices[i + 2]]);
+                triangle[0].intensity = triangle[1].intensity = triangle[2].intensity = intensity;
+            }
+
+            ClipVertex polygon[4];
+            size_t count = ClipSpace::clipNear(triangle, polygon);
+            if (count < 3) {
+                ++stats.trianglesFrustumCulled;
+                continue;
+            }
+
+            const int width = target.getWidth();
+            const int height = target.getHeight();
+            ScreenVertex first = toScreen(polygon[0], width, height);
+            for (size_t k = 1; k + 1 < count; ++k) {
+                if (texture) {
+                    rasterizeTriangle<true>(first, toScreen(polygon[k], width, height), toScreen(polygon[k + 1], width, height), texture, target);
+                } else {
+                    rasterizeTriangle<false>(first, toScreen(polygon[k], width, height), toScreen(polygon[k + 1], width, height), nullptr, target);
+                }
+            }
+        }
+    }
+};
+
+#endif //OBJVIEWER_SOFTWARERASTERIZER_H
@@ -0,0 +1,261 @@
+#ifndef OBJVIEWER_SOFTWARERENDERER_H
+#define OBJVIEWER_SOFTWARERENDERER_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Renderer.h"
+#include "SoftwareRasterizer.h"
+#include "FrameBuffer.h"
+#include "MeshRegistry.h"
+#include "OcclusionCuller.h"
+#include "../core/MemoryStats.h"
+#include "../models/Mesh.h"
+
+// Бэкенд Renderer без окна: кадр растеризуется SoftwareRasterizer в FrameBuffer.
+// createMesh сваривает треугольники в индексированный меш и сразу освещает вершины,
+// поэтому кадр - отсечение перекрытых мешей, умножение на матрицу и растеризация.
+// Подходит для превью и проверок без GPU
+class SoftwareRenderer final : public Renderer {
+public:
+    struct Stats {
+        size_t frames = 0;
+        size_t drawRecords = 0;
+        SoftwareRasterizer::Stats raster;
+        OcclusionCuller::Stats occlusion;
+    };
+
+private:
+    struct MeshResource {
+        std::unique_ptr<Mesh> mesh;
+        SoftwareRasterizer::PreparedMesh prepared;
+        VecMath::Matrix4x4<float> transform;
+        VecMath::Matrix4x4<float> normalMatrix;
+        MemoryAccount memory{MemoryTag::RenderCopies};
+
+        void updateMemory() {
+            memory.set(prepared.vertices.capacity() * sizeof(prepared.vertices[0]));
+        }
+    };
+
+    // Ключ для слияния одинаковых позиций и нормалей соседних треугольников
+    struct FloatTriple {
+        float x, y, z;
+
+        bool operator==(const FloatTriple& other) const {
+            return std::memcmp(this, &other, sizeof(FloatTriple)) == 0;
+        }
+    };
+
+    struct FloatTripleHash {
+        size_t operator()(const FloatTriple& value) const {
+            uint32_t bits[3];
+            std::memcpy(bits, &value, sizeof(bits));
+            size_t hash = bits[0];
+            hash = hash * 0x9E3779B97F4A7C15ull ^ bits[1];
+            hash = hash * 0x9E3779B97F4A7C15ull ^ bits[2];
+            return hash;
+        }
+    };
+
+    MeshRegistry<MeshResource> meshes;
+    SoftwareRasterizer rasterizer;
+    OcclusionCuller occlusionCuller;
+    FrameBuffer frame;
+    // Записи кадра с найденными ресурсами; матрицы живут здесь, OcclusionCuller::Instance ссылается на них
+    std::vector<const MeshResource*> frameResources;
+    std::vector<VecMath::Matrix4x4<float>> frameMatrices;
+    std::vector<OcclusionCuller::Instance> cullInstances;
+    std::vector<OcclusionCuller::MeshVisibility> visibility;
+    std::shared_ptr<Camera> camera;
+    VecMath::Matrix4x4<float> viewProjection;
+    uint32_t clearColor = FrameBuffer::packColor(0.0f, 0.0f, 0.0f);
+    bool frameRequested = false;
+    std::string lastError;
+    Stats stats;
+
+    static std::unique_ptr<Mesh> buildMesh(const std::vector<Triangle>& triangles) {
+        auto mesh = std::make_unique<Mesh>("mesh");
+        std::unordered_map<FloatTriple, size_t, FloatTripleHash> positions;
+        std::unordered_map<FloatTriple, size_t, FloatTripleHash> normals;
+        positions.reserve(triangles.size());
+        normals.reserve(triangles.size());
+
+        auto positionIndex = [&](const Triangle::Vertex& vertex) {
+            auto [it, inserted] = positions.try_emplace(FloatTriple{vertex.x, vertex.y, vertex.z}, positions.size());
+            if (inserted) {
+                mesh->addPosition(vertex.x, vertex.y, vertex.z);
+            }
+            return it->second;
+        };
+        auto normalIndex = [&](const VecMath::Vector3D<float>& normal) {
+            auto [it, inserted] = normals.try_emplace(FloatTriple{normal.x, normal.y, normal.z}, normals.size());
+            if (inserted) {
+                mesh->addNormal(normal.x, normal.y, normal.z);
+            }
+            return it->second;
+        };
+
+        Mesh::Face face;
+        face.vertexIndices.resize(3);
+        face.normalIndices.resize(3);
+        for (const auto& triangle : triangles) {
+            for (size_t i = 0; i < 3; ++i) {
+                face.vertexIndices[i] = positionIndex(triangle.getVertices()[i]);
+                face.normalIndices[i] = normalIndex(triangle.getNormals()[i]);
+            }
+            mesh->addFace(face);
+        }
+
+        mesh->processVertices();
+        // Меш нужен только для подготовки вершин, исходные массивы больше не читаются
+        mesh->releaseAttributes();
+        return mesh;
+    }
+
+public:
+    SoftwareRenderer(int width, int height) : frame(width, height) {}
+
+    void setEventHandler(IEventHandler* handler) override {
+        eventHandler = handler;
+    }
+
+    void setCamera(std::shared_ptr<Camera> cam) override {
+        camera = std::move(cam);
+    }
+
+    // Используется, если камера не задана
+    void setViewProjection(const VecMath::Matrix4x4<float>& matrix) { viewProjection = matrix; }
+
+    // Освещение запекается в вершины, поэтому смена света пересчитывает все меши
+    void setLightDirection(const VecMath::Vector3D<float>& direction) {
+        rasterizer.setLightDirection(direction);
+        meshes.forEach([&](MeshResource& resource) {
+            rasterizer.prepareMesh(*resource.mesh, resource.normalMatrix, resource.prepared);
+            resource.updateMemory();
+        });
+    }
+
+    void setBaseColor(const VecMath::Vector3D<float>& color) { rasterizer.setBaseColor(color); }
+    void setClearColor(uint32_t color) { clearColor = color; }
+    void setOcclusionCulling(bool enabled) { occlusionCuller.setEnabled(enabled); }
+    void resize(int width, int height) { frame.resize(width, height); }
+
+    [[nodiscard]] bool initialize() override { return true; }
+
+    void cleanup() override {
+        meshes.clear();
+    }
+
+    // Без окна цикла сообщений нет: один проход - разобрать события и нарисовать кадр, если его просили
+    void run() override {
+        dispatchEvents();
+        if (frameRequested) {
+            renderFrame();
+        }
+    }
+
+    [[nodiscard]] MeshHandle createMesh(const std::vector<Triangle>& triangles) override {
+        MeshResource resource;
+        resource.mesh = buildMesh(triangles);
+        rasterizer.prepareMesh(*resource.mesh, resource.prepared);
+        resource.updateMemory();
+        ++renderStats.frame().bufferUploads;
+        return meshes.add(std::move(resource));
+    }
+
+    void destroyMesh(MeshHandle mesh) override {
+        meshes.remove(mesh);
+    }
+
+    void updateTransform(MeshHandle mesh, const VecMath::Matrix4x4<float>& transform) override {
+        if (auto* resource = meshes.find(mesh)) {
+            resource->transform = transform;
+            resource->normalMatrix = transform.inverseTranspose();
+            rasterizer.prepareMesh(*resource->mesh, resource->normalMatrix, resource->prepared);
+            resource->updateMemory();
+        }
+    }
+
+    void requestFrame() override {
+        frameRequested = true;
+    }
+
+    void showError(const std::string& message) override {
+        lastError = message;
+    }
+
+    void renderFrame() {
+        OBJVIEWER_TRACE_SCOPE("SoftwareRenderer::renderFrame");
+        frameRequested = false;
+        renderStats.beginFrame();
+        FrameStats& frameStats = renderStats.frame();
+
+        const std::vector<DrawRecord>* drawList;
+        {
+            auto timer = renderStats.time(FrameStats::Setup);
+            drawList = &collectDrawList();
+            frame.clear(clearColor);
+            const VecMath::Matrix4x4<float> cameraMatrix = camera ? camera->getViewProjectionMatrix() : viewProjection;
+
+            frameResources.clear();
+            frameMatrices.clear();
+            for (const auto& record : *drawList) {
+                if (const MeshResource* resource = meshes.find(record.mesh)) {
+                    frameResources.push_back(resource);
+                    frameMatrices.push_back(cameraMatrix * resource->transform);
+                }
+            }
+        }
+
+        {
+            auto timer = renderStats.time(FrameStats::Cull);
+            cullInstances.clear();
+            for (size_t i = 0; i < frameResources.size(); ++i) {
+                cullInstances.push_back(OcclusionCuller::Instance{frameResources[i]->mesh.get(), frameMatrices[i].data()});
+            }
+            occlusionCuller.cull(cullInstances, visibility);
+        }
+
+        rasterizer.resetStats();
+        {
+            auto timer = renderStats.time(FrameStats::Draw);
+            for (size_t i = 0; i < frameResources.size(); ++i) {
+                if (!visibility[i].visible) {
+                    continue;
+                }
+                rasterizer.setViewProjection(frameMatrices[i]);
+                rasterizer.drawPrepared(frameResources[i]->prepared, visibility[i].ranges, frame);
+                ++frameStats.drawCalls;
+            }
+        }
+
+        ++stats.frames;
+        stats.drawRecords = drawList->size();
+        stats.raster = rasterizer.getStats();
+        stats.occlusion = occlusionCuller.getStats();
+        frameStats.trianglesOccluded = stats.occlusion.trianglesOccluded;
+
+        // Преобразование вершин идёт внутри drawPrepared, его время переносится из Draw в Transform
+        const auto& raster = stats.raster;
+        frameStats.trianglesSubmitted = raster.trianglesSubmitted;
+        frameStats.trianglesBackfaceCulled = raster.trianglesBackfaceCulled;
+        frameStats.trianglesFrustumCulled = raster.trianglesFrustumCulled + stats.occlusion.trianglesOutsideFrustum;
+        frameStats.trianglesRasterized = raster.trianglesRasterized;
+        frameStats.pixelsShaded = raster.pixelsShaded;
+        frameStats.stageMilliseconds[FrameStats::Transform] = raster.transformMilliseconds;
+        frameStats.stageMilliseconds[FrameStats::Draw] =
+                std::max(0.0, frameStats.stageMilliseconds[FrameStats::Draw] - raster.transformMilliseconds);
+        renderStats.endFrame();
+    }
+
+    [[nodiscard]] const FrameBuffer& getFrame() const { return frame; }
+    [[nodiscard]] bool isFrameRequested() const { return frameRequested; }
+    [[nodiscard]] const std::string& getLastError() const { return lastError; }
+    [[nodiscard]] size_t getMeshCount() const { return meshes.size(); }
+    [[nodiscard]] const Stats& getStats() const { return stats; }
+};
+
+#endif //OBJVIEWER_SOFTWARERENDERER_H
@@ -12,19 +12,30 @@
 #include "../controller/Triangle.h"
 #include <gdiplus.h>
 #include <numeric>
+#include <optional>
 
 #pragma comment(lib, "gdiplus.lib")
 
 #define ID_FILE_OPEN 1001
+#define WM_DISPATCH_EVENTS (WM_APP + 1)
 
 class WinAPIRenderer final : public Renderer {
 private:
     ULONG_PTR gdiplusToken; // Токен для GDI+
     Gdiplus::GdiplusStartupInput gdiplusStartupInput;
 
+    // Копия геометрии в бэкенде; кадр ссылается на неё через MeshHandle
+    struct MeshResource {
+        std::vector<Triangle> triangles;
+        VecMath::Matrix4x4<float> transform;
+        VecMath::Matrix4x4<float> normalMatrix;
+        bool hasTransform = false;
+    };
+
     HWND hwnd{nullptr};
     HDC hdc{nullptr};
-    std::vector<Triangle> model;
+    MeshRegistry<MeshResource> meshes;
+    std::vector<Triangle> processedTriangles; // Рабочий буфер кадра, память переиспользуется
     std::string currentFilePath;
     std::shared_ptr<Camera> camera;
     std::unique_ptr<Light> light;
@@ -98,11 +109,20 @@ public:
 
     [[nodiscard]] bool initialize() override { return true; }
 
-    void render(const std::vector<Triangle>& triangles) override {
+    void renderFrame() {
+        OBJVIEWER_TRACE_SCOPE("WinAPIRenderer::renderFrame");
+        // Кадр начинается только после BeginPaint: выход без отрисовки не оставляет
+        // в статистике недостроенный кадр
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
         if (!hdc) return;
 
+        renderStats.beginFrame();
+        FrameStats& frameStats = renderStats.frame();
+        std::optional<RenderStats::StageTimer> setupTimer;
+        setupTimer.emplace(frameStats, FrameStats::Setup);
+        const auto& drawList = collectDrawList();
+
         RECT clientRect;
         GetClientRect(hwnd, &clientRect);
         int windowWidth = clientRect.right - clientRect.left;
@@ -116,36 +136,72 @@ public:
         FillRect(backBufferDC, &clientRect, hBrush);
         DeleteObject(hBrush);
 
-        std::vector<Triangle> processedTriangles;
-        for (const auto& triangle : triangles) {
-            Triangle t(triangle);
-            if (camera) {
-                auto viewProj = camera->getViewProjectionMatrix();
-                t.applyMatrix(viewProj);
-            } else {
-                t.scale(150.0f);
-                t.translate(windowWidth / 2, windowHeight / 2);
+        // С камерой: вид-проекция и перевод NDC в координаты окна (ось y вниз) одной матрицей
+        VecMath::Matrix4x4<float> toWindow;
+        if (camera) {
+            float halfWidth = static_cast<float>(windowWidth) * 0.5f;
+            float halfHeight = static_cast<float>(windowHeight) * 0.5f;
+            toWindow = VecMath::Matrix4x4<float>::translate({halfWidth, halfHeight, 0.0f}) *
+                       VecMath::Matrix4x4<float>::scale({halfWidth, -halfHeight, 1.0f}) *
+                       camera->getViewProjectionMatrix();
+        }
+        setupTimer.reset();
+
+        std::optional<RenderStats::StageTimer> transformTimer;
+        transformTimer.emplace(frameStats, FrameStats::Transform);
+        processedTriangles.clear();
+        for (const auto& record : drawList) {
+            const MeshResource* mesh = meshes.find(record.mesh);
+            if (!mesh) {
+                continue;
+            }
+            frameStats.trianglesSubmitted += mesh->triangles.size();
+            for (const auto& triangle : mesh->triangles) {
+                Triangle t(triangle);
+                if (mesh->hasTransform) {
+                    t.applyTransform(mesh->transform, mesh->normalMatrix);
+                }
+                if (camera) {
+                    t.applyMatrix(toWindow);
+                } else {
+                    t.scale(150.0f);
+                    t.translate(windowWidth / 2, windowHeight / 2);
+                }
+                processedTriangles.push_back(t);
             }
-            processedTriangles.push_back(t);
         }
+        transformTimer.reset();
 
-        std::sort(processedTriangles.begin(), processedTriangles.end());
+        // Каждый треугольник - отдельный вызов GDI+, пикселей GDI+ не сообщает
+        {
+            auto timer = renderStats.time(FrameStats::Draw);
+            std::sort(processedTriangles.begin(), processedTriangles.end());
 
-        for (const auto& triangle : processedTriangles) {
-            if (!triangle.isVisible()) continue;
+            for (const auto& triangle : processedTriangles) {
+                if (!triangle.isVisible()) {
+                    ++frameStats.trianglesBackfaceCulled;
+                    continue;
+                }
 
-            auto [v1, v2, v3] = triangle.getVertices();
-            float intensity = triangle.computeLightIntensity(light->getDirection());
-            drawFilledTriangle(backBufferDC, v1, v2, v3, intensity);
+                auto [v1, v2, v3] = triangle.getVertices();
+                float intensity = triangle.computeLightIntensity(light->getDirection());
+                drawFilledTriangle(backBufferDC, v1, v2, v3, intensity);
+                ++frameStats.trianglesRasterized;
+                ++frameStats.drawCalls;
+            }
         }
 
-        BitBlt(hdc, 0, 0, windowWidth, windowHeight, backBufferDC, 0, 0, SRCCOPY);
+        {
+            auto timer = renderStats.time(FrameStats::Present);
+            BitBlt(hdc, 0, 0, windowWidth, windowHeight, backBufferDC, 0, 0, SRCCOPY);
 
-        SelectObject(backBufferDC, oldBitmap);
-        DeleteObject(backBufferBitmap);
-        DeleteDC(backBufferDC);
+            SelectObject(backBufferDC, oldBitmap);
+            DeleteObject(backBufferBitmap);
+            DeleteDC(backBufferDC);
 
-        EndPaint(hwnd, &ps);
+            EndPaint(hwnd, &ps);
+        }
+        renderStats.endFrame();
     }
 
     void cleanup() override {
@@ -153,15 +209,34 @@ public:
         hdc = nullptr;
     }
 
-    void updateModel(std::vector<Triangle> md) override{
-        model = md;
-        if (!model.empty()) {
-            InvalidateRect(hwnd, nullptr, TRUE); // Перерисовываем окно
-        } else {
-            MessageBox(hwnd, L"Failed to load OBJ model", L"Error", MB_ICONERROR | MB_OK);
+    [[nodiscard]] MeshHandle createMesh(const std::vector<Triangle>& triangles) override {
+        ++renderStats.frame().bufferUploads;
+        return meshes.add(MeshResource{triangles});
+    }
+
+    void destroyMesh(MeshHandle mesh) override {
+        meshes.remove(mesh);
+    }
+
+    void updateTransform(MeshHandle mesh, const VecMath::Matrix4x4<float>& transform) override {
+        if (auto* resource = meshes.find(mesh)) {
+            resource->transform = transform;
+            resource->normalMatrix = transform.inverseTranspose();
+            resource->hasTransform = true;
         }
     }
 
+    void requestFrame() override {
+        InvalidateRect(hwnd, nullptr, TRUE); // Перерисовываем окно
+    }
+
+    void showError(const std::string& message) override {
+        int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, message.c_str(), -1, nullptr, 0);
+        std::wstring text(sizeNeeded, 0);
+        MultiByteToWideChar(CP_UTF8, 0, message.c_str(), -1, &text[0], sizeNeeded);
+        MessageBox(hwnd, text.c_str(), L"Error", MB_ICONERROR | MB_OK);
+    }
+
     void run() override {
         WNDCLASS wc{};
         wc.lpfnWndProc = WndProc;
@@ -176,6 +251,11 @@ public:
                 nullptr, nullptr, GetModuleHandle(nullptr), this
         );
 
+        // События из очереди обрабатываются в потоке окна, поток-источник только будит его
+        if (eventQueue) {
+            eventQueue->setWakeup([window = hwnd] { PostMessage(window, WM_DISPATCH_EVENTS, 0, 0); });
+        }
+
         ShowWindow(hwnd, SW_SHOW);
 
         // Создание меню
@@ -208,8 +288,8 @@ private:
 
         switch (msg) {
             case WM_PAINT:
-                if (renderer && !renderer->model.empty()) {
-                    renderer->render(renderer->model);
+                if (renderer) {
+                    renderer->renderFrame();
                 }
                 return 0;
 
@@ -217,10 +297,16 @@ private:
                 PostQuitMessage(0);
                 return 0;
 
+            case WM_DISPATCH_EVENTS:
+                if (renderer) {
+                    renderer->dispatchEvents();
+                }
+                return 0;
+
             case WM_COMMAND: {
                 if (LOWORD(wParam) == ID_FILE_OPEN) {
                     if (auto filePath = renderer->openFileDialog(); !filePath.empty()) {
-                        renderer->eventHandler->handleEvent(Event(EventType::FileOpen, std::move(filePath)));
+                        renderer->postEvent(Event(EventType::FileOpen, std::move(filePath)));
                     }
                 }
                 return 0;
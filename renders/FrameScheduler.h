@@ -0,0 +1,117 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// Решает, когда перерисовывать окно: кадр строится только если что-то изменилось
+// (камера, модель, размер, перерисовка от системы) и не чаще ограничения частоты кадров.
+// В остальное время цикл сообщений спит до следующего события.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum DirtyFlags : uint32_t {
+        Clean = 0,
+        CameraChanged = 1u << 0,
+        ModelChanged = 1u << 1,
+        Resized = 1u << 2,
+        Exposed = 1u << 3
+    };
+
+    struct Stats {
+        size_t framesRendered = 0;
+        size_t framesSkipped = 0;      // Пробуждения цикла без перерисовки
+        size_t framesDeferred = 0;     // Кадр нужен, но отложен ограничением частоты
+        size_t invalidations = 0;      // Изменения, схлопнутые в кадры
+        double idleSeconds = 0.0;      // Время в ожидании сообщений
+        double activeSeconds = 0.0;    // Всё остальное время цикла
+
+        [[nodiscard]] double idleFraction() const {
+            double total = idleSeconds + activeSeconds;
+            return total > 0.0 ? idleSeconds / total : 0.0;
+        }
+    };
+
+    // Результат waitTimeout: ждать без ограничения по времени
+    static constexpr uint32_t WaitForever = 0xFFFFFFFFu;
+
+private:
+    uint32_t dirty = Resized;
+    double maxFramesPerSecond = 0.0;
+    bool idleSleep = true;
+    Clock::time_point lastFrame{};
+    Stats stats;
+
+    [[nodiscard]] Clock::duration frameInterval() const {
+        if (maxFramesPerSecond <= 0.0) {
+            return Clock::duration::zero();
+        }
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / maxFramesPerSecond));
+    }
+
+public:
+    void invalidate(uint32_t flags) {
+        dirty |= flags;
+        ++stats.invalidations;
+    }
+
+    [[nodiscard]] bool isDirty() const { return dirty != Clean; }
+    [[nodiscard]] uint32_t getDirtyFlags() const { return dirty; }
+
+    // 0 - без ограничения
+    void setFrameRateCap(double framesPerSecond) { maxFramesPerSecond = framesPerSecond; }
+    [[nodiscard]] double getFrameRateCap() const { return maxFramesPerSecond; }
+
+    // false - прежнее поведение: цикл не засыпает и перерисовывает каждый проход
+    void setIdleSleep(bool enabled) { idleSleep = enabled; }
+    [[nodiscard]] bool isIdleSleepEnabled() const { return idleSleep; }
+
+    [[nodiscard]] bool shouldRender(Clock::time_point now) {
+        if (!idleSleep) {
+            return true;
+        }
+        if (!isDirty()) {
+            ++stats.framesSkipped;
+            return false;
+        }
+        if (now - lastFrame < frameInterval()) {
+            ++stats.framesDeferred;
+            return false;
+        }
+        return true;
+    }
+
+    void frameRendered(Clock::time_point now) {
+        dirty = Clean;
+        lastFrame = now;
+        ++stats.framesRendered;
+    }
+
+    // Сколько миллисекунд цикл может спать в ожидании сообщений
+    [[nodiscard]] uint32_t waitTimeout(Clock::time_point now) const {
+        if (!idleSleep) {
+            return 0;
+        }
+        if (!isDirty()) {
+            return WaitForever;
+        }
+        auto remaining = lastFrame + frameInterval() - now;
+        if (remaining <= Clock::duration::zero()) {
+            return 0;
+        }
+        // Округление вверх, чтобы не проснуться на миллисекунду раньше срока
+        auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+        return static_cast<uint32_t>(milliseconds);
+    }
+
+    void addIdleTime(Clock::duration duration) {
+        stats.idleSeconds += std::chrono::duration<double>(duration).count();
+    }
+
+    void addActiveTime(Clock::duration duration) {
+        stats.activeSeconds += std::chrono::duration<double>(duration).count();
+    }
+
+    [[nodiscard]] const Stats& getStats() const { return stats; }
+    void resetStats() { stats = Stats{}; }
+};
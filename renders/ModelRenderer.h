@@ -1,6 +1,10 @@
 #pragma once
 #include <memory>
 #include "../models/Model3D.h"
+#include "../render/OcclusionCuller.h"
+#include "../render/RenderStats.h"
+#include "../core/MemoryStats.h"
+#include "../core/Trace.h"
 #include <gl/GL.h>
 
 class ModelRenderer {
@@ -9,12 +13,52 @@ private:
     float rotationX = 0.0f;
     float rotationY = 0.0f;
     float zoom = -5.0f;
+    OcclusionCuller occlusionCuller;
+    std::vector<OcclusionCuller::MeshVisibility> visibility;
+    RenderStats stats;
+
+    // Vertices unpacked once per model into x y z nx ny nz u v, so a frame only
+    // points GL at them and submits the visible index ranges with glDrawElements.
+    static constexpr GLsizei VertexStride = 8 * sizeof(float);
+    std::vector<std::vector<float>> meshVertices;
+    // False for meshes from OBJ files without vn: their normals are all zero and would light
+    // them ambient-only, so they get one constant normal instead of the normal array.
+    std::vector<bool> meshHasNormals;
+    MemoryAccount vertexMemory{ MemoryTag::RenderCopies };
+
+    void uploadModel() {
+        meshVertices.clear();
+        meshHasNormals.clear();
+        vertexMemory.set(0);
+        if (!model) {
+            return;
+        }
+        for (const auto& mesh : model->getMeshes()) {
+            std::vector<float> vertices;
+            vertices.reserve(mesh->getVertexCount() * 8);
+            bool hasNormals = false;
+            for (size_t i = 0; i < mesh->getVertexCount(); ++i) {
+                const auto vertex = mesh->getVertex(i);
+                vertices.insert(vertices.end(), { vertex.x, vertex.y, vertex.z, vertex.nx, vertex.ny, vertex.nz, vertex.u, vertex.v });
+                hasNormals = hasNormals || vertex.nx != 0.0f || vertex.ny != 0.0f || vertex.nz != 0.0f;
+            }
+            meshVertices.push_back(std::move(vertices));
+            meshHasNormals.push_back(hasNormals);
+        }
+        size_t bytes = 0;
+        for (const auto& vertices : meshVertices) {
+            bytes += vertices.capacity() * sizeof(float);
+        }
+        vertexMemory.set(bytes);
+    }
 
 public:
     ModelRenderer() = default;
 
     void setModel(std::shared_ptr<Model3D> newModel) {
         model = std::move(newModel);
+        uploadModel();
+        stats.frame().bufferUploads += meshVertices.size();
     }
 
     void initialize() {
@@ -71,7 +115,21 @@ public:
         zoom += deltaZ * 0.1f;
     }
 
+    void setOcclusionCulling(bool enabled) {
+        occlusionCuller.setEnabled(enabled);
+    }
+
+    const OcclusionCuller::Stats& getOcclusionStats() const {
+        return occlusionCuller.getStats();
+    }
+
+    RenderStats& getRenderStats() { return stats; }
+    const RenderStats& getRenderStats() const { return stats; }
+
     void render() {
+        OBJVIEWER_TRACE_SCOPE("ModelRenderer::render");
+        stats.beginFrame();
+        FrameStats& frameStats = stats.frame();
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glMatrixMode(GL_MODELVIEW);
@@ -82,41 +140,72 @@ public:
         glRotatef(rotationY, 0.0f, 1.0f, 0.0f);
 
         if (model) {
-            for (const auto& mesh : model->getMeshes()) {
-                renderMesh(mesh);
+            // Матрицы берутся из фиксированного конвейера после установки вида
+            GLfloat projection[16], modelView[16], viewProjection[16];
+            glGetFloatv(GL_PROJECTION_MATRIX, projection);
+            glGetFloatv(GL_MODELVIEW_MATRIX, modelView);
+            ClipSpace::multiply(projection, modelView, viewProjection);
+            {
+                auto timer = stats.time(FrameStats::Cull);
+                occlusionCuller.cull(*model, viewProjection, visibility);
+            }
+            const auto& culled = occlusionCuller.getStats();
+            frameStats.trianglesSubmitted += culled.trianglesTotal;
+            frameStats.trianglesFrustumCulled += culled.trianglesOutsideFrustum;
+            frameStats.trianglesOccluded += culled.trianglesOccluded;
+
+            auto timer = stats.time(FrameStats::Draw);
+            const auto& meshes = model->getMeshes();
+            glDisable(GL_COLOR_MATERIAL);
+            glEnableClientState(GL_VERTEX_ARRAY);
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+            for (size_t i = 0; i < meshes.size(); ++i) {
+                if (visibility[i].visible) {
+                    frameStats.drawCalls += renderMesh(*meshes[i], meshVertices[i], meshHasNormals[i], visibility[i].ranges);
+                }
             }
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+            glDisableClientState(GL_NORMAL_ARRAY);
+            glDisableClientState(GL_VERTEX_ARRAY);
         }
         else {
+            auto timer = stats.time(FrameStats::Draw);
             renderCube();
+            ++frameStats.drawCalls;
+            frameStats.trianglesSubmitted += 12;
         }
+        stats.endFrame();
     }
 
 private:
-    void renderMesh(const std::shared_ptr<Mesh>& mesh) {
-        const auto& vertices = mesh->getVertices();
-        const auto& faces = mesh->getFaces();
-
-        glDisable(GL_COLOR_MATERIAL);
-
-        glBegin(GL_TRIANGLES);
-
-        for (size_t i = 0; i < vertices.size(); i += 3) {
-            for (size_t j = 0; j < 3 && i + j < vertices.size(); ++j) {
-                const auto& vertex = vertices[i + j];
-
-                if (vertex.nx != 0.0f || vertex.ny != 0.0f || vertex.nz != 0.0f) {
-                    glNormal3f(vertex.nx, vertex.ny, vertex.nz);
-                }
-
-                if (vertex.u != 0.0f || vertex.v != 0.0f) {
-                    glTexCoord2f(vertex.u, vertex.v);
-                }
+    // Returns the number of glDrawElements calls
+    size_t renderMesh(const Mesh& mesh, const std::vector<float>& vertices, bool hasNormals,
+                      const std::vector<OcclusionCuller::Range>& ranges) {
+        const auto& indices = mesh.getIndices();
+        if (vertices.empty()) {
+            return 0;
+        }
 
-                glVertex3f(vertex.x, vertex.y, vertex.z);
+        glVertexPointer(3, GL_FLOAT, VertexStride, vertices.data());
+        if (hasNormals) {
+            glEnableClientState(GL_NORMAL_ARRAY);
+            glNormalPointer(GL_FLOAT, VertexStride, vertices.data() + 3);
+        } else {
+            // GL's initial current normal
+            glDisableClientState(GL_NORMAL_ARRAY);
+            glNormal3f(0.0f, 0.0f, 1.0f);
+        }
+        glTexCoordPointer(2, GL_FLOAT, VertexStride, vertices.data() + 6);
+
+        size_t calls = 0;
+        for (const auto& range : ranges) {
+            size_t end = std::min(indices.size(), static_cast<size_t>(range.firstIndex) + range.indexCount);
+            if (end > range.firstIndex) {
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(end - range.firstIndex), GL_UNSIGNED_INT, indices.data() + range.firstIndex);
+                ++calls;
             }
         }
-
-        glEnd();
+        return calls;
     }
 
     void renderCube() {
@@ -1,12 +1,24 @@
 #pragma once
 #include "OpenGLContext.h"
 #include "ModelRenderer.h"
+#include "FrameScheduler.h"
+#include "../controller/EventQueue.h"
+#include "../controller/InputRecording.h"
+#include "../core/MemoryStats.h"
+#include <chrono>
+#include <cstdio>
+#include <sstream>
 
-class OpenGLWindow {
+#define WM_DISPATCH_EVENTS (WM_APP + 1)
+
+class OpenGLWindow : public IEventHandler {
 private:
     HWND hwnd = nullptr;
     std::unique_ptr<OpenGLContext> context;
     std::unique_ptr<ModelRenderer> renderer;
+    FrameScheduler scheduler;
+    EventQueue events;
+    std::unique_ptr<InputRecorder> inputRecorder;
 
     static std::unordered_map<HWND, OpenGLWindow*> windowInstances;
 
@@ -17,6 +29,12 @@ private:
     int width = 800;
     int height = 600;
 
+    void record(InputSample::Kind kind, float a = 0.0f, float b = 0.0f) {
+        if (inputRecorder) {
+            inputRecorder->record(kind, a, b);
+        }
+    }
+
 public:
     OpenGLWindow() :
         context(std::make_unique<OpenGLContext>()),
@@ -70,6 +88,9 @@ public:
 
         windowInstances[hwnd] = this;
 
+        //  MsgWaitForMultipleObjectsEx,      
+        events.setWakeup([window = hwnd] { PostMessage(window, WM_DISPATCH_EVENTS, 0, 0); });
+
         HDC hdc = GetDC(hwnd);
 
         try {
@@ -88,55 +109,152 @@ public:
         }
     }
 
+    //      ,      MsgWaitForMultipleObjectsEx
     int runMessageLoop() {
+        using Clock = FrameScheduler::Clock;
         MSG msg = {};
+        auto lastReport = Clock::now();
 
         while (true) {
-            if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            auto activeStart = Clock::now();
+
+            while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
                 if (msg.message == WM_QUIT) {
-                    break;
+                    reportFrameStats();
+                    return static_cast<int>(msg.wParam);
                 }
 
                 TranslateMessage(&msg);
                 DispatchMessage(&msg);
             }
-            else {
+
+            //         
+            events.dispatch(*this);
+
+            auto now = Clock::now();
+            if (scheduler.shouldRender(now)) {
                 render();
+                scheduler.frameRendered(now);
+                now = Clock::now();
+            }
+            scheduler.addActiveTime(now - activeStart);
+
+            if (now - lastReport >= std::chrono::seconds(5)) {
+                reportFrameStats();
+                lastReport = now;
+            }
+
+            uint32_t timeout = scheduler.waitTimeout(now);
+            if (timeout != 0) {
+                MsgWaitForMultipleObjectsEx(0, nullptr, timeout == FrameScheduler::WaitForever ? INFINITE : timeout,
+                                            QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+                scheduler.addIdleTime(Clock::now() - now);
             }
         }
+    }
+
+    FrameScheduler& getFrameScheduler() {
+        return scheduler;
+    }
 
-        return static_cast<int>(msg.wParam);
+    //      (DebugView,  Output )
+    void reportFrameStats() const {
+        const auto& stats = scheduler.getStats();
+        const auto eventStats = events.getStats();
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "Frames: rendered %zu, skipped %zu, deferred %zu, invalidations %zu, idle %.1f%%; "
+                      "events: posted %zu, coalesced %zu\n",
+                      stats.framesRendered, stats.framesSkipped, stats.framesDeferred, stats.invalidations,
+                      stats.idleFraction() * 100.0, eventStats.posted, eventStats.coalesced);
+        OutputDebugStringA(line);
+
+        std::ostringstream memory;
+        MemoryStats::global().print(memory);
+        OutputDebugStringA(memory.str().c_str());
+    }
+
+    //      OBJInputReplay;   create,     
+    void startInputRecording() {
+        inputRecorder = std::make_unique<InputRecorder>();
+    }
+
+    void saveInputRecording(const std::string& filePath) const {
+        if (inputRecorder) {
+            inputRecorder->getRecording().save(filePath);
+        }
     }
 
     void setModel(std::shared_ptr<Model3D> model) {
         renderer->setModel(std::move(model));
+        scheduler.invalidate(FrameScheduler::ModelChanged);
     }
 
     void onResize(int newWidth, int newHeight) {
         width = newWidth;
         height = newHeight;
+        record(InputSample::Kind::Resize, static_cast<float>(width), static_cast<float>(height));
 
         if (renderer) {
             renderer->resize(width, height);
         }
+        scheduler.invalidate(FrameScheduler::Resized);
+    }
+
+    void onPaint() {
+        scheduler.invalidate(FrameScheduler::Exposed);
+    }
+
+    //     
+    void postEvent(Event event) {
+        events.post(std::move(event));
+    }
+
+    void handleEvent(const Event& event) override {
+        switch (event.type) {
+        case EventType::Rotate: {
+            const auto& delta = event.get<RotateDelta>();
+            record(InputSample::Kind::Rotate, delta.x, delta.y);
+            renderer->updateRotation(delta.x, delta.y);
+            scheduler.invalidate(FrameScheduler::CameraChanged);
+            break;
+        }
+        case EventType::Zoom:
+            record(InputSample::Kind::Zoom, event.get<ZoomDelta>().amount);
+            renderer->updateZoom(event.get<ZoomDelta>().amount);
+            scheduler.invalidate(FrameScheduler::CameraChanged);
+            break;
+        case EventType::Resize: {
+            const auto& size = event.get<WindowSize>();
+            onResize(size.width, size.height);
+            break;
+        }
+        default:
+            break;
+        }
     }
 
     void onMouseDown(int x, int y) {
         mouseDown = true;
+        record(InputSample::Kind::MouseDown, static_cast<float>(x), static_cast<float>(y));
         lastMouseX = x;
         lastMouseY = y;
     }
 
     void onMouseUp() {
         mouseDown = false;
+        record(InputSample::Kind::MouseUp);
     }
 
     void onMouseMove(int x, int y) {
+        record(InputSample::Kind::MouseMove, static_cast<float>(x), static_cast<float>(y));
         if (mouseDown) {
             int deltaX = x - lastMouseX;
             int deltaY = y - lastMouseY;
 
-            renderer->updateRotation(static_cast<float>(deltaX), static_cast<float>(deltaY));
+            if (deltaX != 0 || deltaY != 0) {
+                events.post(Event(EventType::Rotate, RotateDelta{static_cast<float>(deltaX), static_cast<float>(deltaY)}));
+            }
 
             lastMouseX = x;
             lastMouseY = y;
@@ -144,13 +262,17 @@ public:
     }
 
     void onMouseWheel(int delta) {
-        renderer->updateZoom(static_cast<float>(delta) / 120.0f);
+        record(InputSample::Kind::MouseWheel, static_cast<float>(delta) / 120.0f);
+        events.post(Event(EventType::Zoom, ZoomDelta{static_cast<float>(delta) / 120.0f}));
     }
 
     void render() {
         if (renderer) {
+            auto start = std::chrono::steady_clock::now();
             renderer->render();
             context->swapBuffers();
+            record(InputSample::Kind::Frame,
+                   std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
         }
     }
 
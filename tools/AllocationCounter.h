@@ -0,0 +1,14 @@
+#ifndef OBJVIEWER_ALLOCATIONCOUNTER_H
+#define OBJVIEWER_ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+// Число вызовов глобального operator new с начала программы. Замены operator new/delete
+// живут в AllocationCounter.cpp: в отдельной единице трансляции GCC не встраивает их
+// в вызывающий код и не путает free из operator delete с парным ему new
+// (-Wmismatched-new-delete).
+namespace AllocationCounter {
+    size_t count();
+}
+
+#endif //OBJVIEWER_ALLOCATIONCOUNTER_H
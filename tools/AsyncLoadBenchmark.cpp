@@ -0,0 +1,122 @@
+// Сравнение пропускной способности загрузки: loadModel в цикле против co_await loadAllAsync.
+//
+// OBJAsyncLoadBench [--files N] [--segments N] [--jobs N] [--dir DIR] [--trace FILE]
+//
+// Без --dir генерирует N сфер во временном каталоге. --trace записывает интервалы обоих
+// прогонов в Chrome trace JSON (сборка с OBJVIEWER_TRACING).
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../models/ModelManager.h"
+#include "../core/Task.h"
+#include "../core/Trace.h"
+#include "SyntheticObj.h"
+
+namespace {
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    size_t countTriangles(const std::vector<std::shared_ptr<Model3D>>& models) {
+        size_t triangles = 0;
+        for (const auto& model : models) {
+            for (const auto& mesh : model->getMeshes()) {
+                triangles += mesh->getIndices().size() / 3;
+            }
+        }
+        return triangles;
+    }
+}
+
+int main(int argc, char** argv) {
+    int fileCount = 24;
+    int segments = 160;
+    unsigned jobThreads = 0;
+    std::filesystem::path directory;
+    std::string tracePath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--files") {
+            fileCount = std::max(1, std::atoi(argv[i + 1]));
+        } else if (arg == "--segments") {
+            segments = std::max(3, std::atoi(argv[i + 1]));
+        } else if (arg == "--jobs") {
+            jobThreads = static_cast<unsigned>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (arg == "--dir") {
+            directory = argv[i + 1];
+        } else if (arg == "--trace") {
+            tracePath = argv[i + 1];
+        }
+    }
+    JobSystem::configureGlobal(jobThreads);
+
+    std::vector<std::string> files;
+    if (directory.empty()) {
+        directory = std::filesystem::temp_directory_path() / "objviewer_async_load";
+        std::filesystem::create_directories(directory);
+        for (int i = 0; i < fileCount; ++i) {
+            auto path = directory / ("sphere_" + std::to_string(i) + ".obj");
+            SyntheticObj::write(path.string(), segments);
+            files.push_back(path.string());
+        }
+    } else {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+                files.push_back(entry.path().string());
+            }
+        }
+    }
+
+    uintmax_t bytes = 0;
+    for (const auto& file : files) {
+        bytes += std::filesystem::file_size(file);
+    }
+    std::cout << files.size() << " files, " << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MiB, "
+              << JobSystem::global().getThreadCount() << " job threads" << std::endl;
+
+    // Прогрев файлового кэша, чтобы оба варианта читали из памяти
+    {
+        ModelManager warmup;
+        warmup.loadModel(files.front());
+    }
+
+    ModelManager sequentialManager;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Model3D>> sequential;
+    for (const auto& file : files) {
+        sequential.push_back(sequentialManager.loadModel(file));
+    }
+    double sequentialSeconds = secondsSince(start);
+
+    ModelManager asyncManager;
+    start = std::chrono::steady_clock::now();
+    auto concurrent = syncWait(asyncManager.loadAllAsync(files));
+    double asyncSeconds = secondsSince(start);
+
+    bool identical = countTriangles(sequential) == countTriangles(concurrent);
+
+    auto report = [&](const char* name, double seconds) {
+        std::cout << "  " << name << ": " << seconds * 1000.0 << " ms, "
+                  << static_cast<double>(files.size()) / seconds << " models/s, "
+                  << static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds << " MiB/s" << std::endl;
+    };
+    report("loadModel loop ", sequentialSeconds);
+    report("loadAllAsync   ", asyncSeconds);
+    std::cout << "  speedup " << sequentialSeconds / asyncSeconds << "x, "
+              << (identical ? "same triangle count" : "TRIANGLE COUNT MISMATCH") << std::endl;
+
+    if (!tracePath.empty()) {
+        if (!Trace::isCompiledIn()) {
+            std::cout << "  --trace ignored: built without OBJVIEWER_TRACING" << std::endl;
+        } else if (!Trace::writeChromeTrace(tracePath)) {
+            std::cout << "  failed to write " << tracePath << std::endl;
+        }
+    }
+
+    return identical ? 0 : 1;
+}
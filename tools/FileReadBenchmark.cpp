@@ -0,0 +1,176 @@
+// Сравнение способов чтения OBJ: std::ifstream против AsyncFileReader (io_uring и фоновый поток),
+// только чтение и чтение вместе с разбором. Выводит время и пропускную способность.
+//
+// OBJFileReadBench [--segments N] [--block KiB] [--depth N] [--repeat N] [--file PATH]
+//
+// Без --file генерирует сферу во временном каталоге. Файл читается из кэша ОС:
+// измеряется накладная часть чтения и перекрытие его с разбором, а не скорость диска.
+// При сборке с zlib дополнительно разбирается gzip-копия файла через DecompressingFileStream.
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../core/AsyncFileReader.h"
+#include "../core/DecompressingFileStream.h"
+#include "../models/ObjLoader.h"
+#include "SyntheticObj.h"
+
+namespace {
+    struct Result {
+        double seconds = 0.0;
+        size_t checksum = 0;
+    };
+
+    // Лучшее из нескольких повторов, чтобы отсечь шум планировщика
+    Result measure(int repeat, const std::function<size_t()>& body) {
+        Result best;
+        for (int i = 0; i < repeat; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            size_t checksum = body();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (i == 0 || seconds < best.seconds) {
+                best = {seconds, checksum};
+            }
+        }
+        return best;
+    }
+
+    size_t countIndices(const Model3D& model) {
+        size_t indices = 0;
+        for (const auto& mesh : model.getMeshes()) {
+            indices += mesh->getIndices().size();
+        }
+        return indices;
+    }
+
+#ifdef OBJVIEWER_WITH_ZLIB
+    std::string writeGzipCopy(const std::string& filePath) {
+        std::string gzipPath = filePath + ".gz";
+        std::ifstream source(filePath, std::ios::binary);
+        gzFile target = gzopen(gzipPath.c_str(), "wb6");
+        if (!source.is_open() || !target) {
+            throw std::runtime_error("Failed to write " + gzipPath);
+        }
+        std::vector<char> buffer(1 << 20);
+        while (source.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || source.gcount() > 0) {
+            gzwrite(target, buffer.data(), static_cast<unsigned>(source.gcount()));
+        }
+        gzclose(target);
+        return gzipPath;
+    }
+#endif
+}
+
+int main(int argc, char** argv) {
+    int segments = 600;
+    int repeat = 3;
+    AsyncFileReader::Options options;
+    std::string filePath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--segments") {
+            segments = std::max(3, std::atoi(argv[i + 1]));
+        } else if (arg == "--block") {
+            options.blockSize = static_cast<size_t>(std::max(4, std::atoi(argv[i + 1]))) * 1024;
+        } else if (arg == "--depth") {
+            options.queueDepth = static_cast<size_t>(std::max(2, std::atoi(argv[i + 1])));
+        } else if (arg == "--repeat") {
+            repeat = std::max(1, std::atoi(argv[i + 1]));
+        } else if (arg == "--file") {
+            filePath = argv[i + 1];
+        }
+    }
+
+    if (filePath.empty()) {
+        auto path = std::filesystem::temp_directory_path() / "objviewer_read_bench.obj";
+        SyntheticObj::write(path.string(), segments);
+        filePath = path.string();
+    }
+    const double bytes = static_cast<double>(std::filesystem::file_size(filePath));
+
+    AsyncFileReader::Options threadOptions = options;
+    threadOptions.allowIoUring = false;
+    const char* asyncBackend = AsyncFileReader::backendName(AsyncFileReader(filePath, options).getStats().backend);
+
+    std::cout << filePath << ": " << bytes / (1024.0 * 1024.0) << " MiB, block " << options.blockSize / 1024
+              << " KiB x " << options.queueDepth << std::endl;
+
+    auto report = [&](const std::string& name, const Result& result, const Result& reference) {
+        std::string label = name;
+        label.resize(18, ' ');
+        std::cout << "  " << label << result.seconds * 1000.0 << " ms, "
+                  << bytes / (1024.0 * 1024.0) / result.seconds << " MiB/s"
+                  << (result.checksum == reference.checksum ? "" : "  CHECKSUM MISMATCH") << std::endl;
+        return result.checksum == reference.checksum;
+    };
+
+    // Только чтение: суммируем байты, чтобы компилятор не выбросил цикл
+    auto readIfstream = [&] {
+        std::ifstream file(filePath, std::ios::binary);
+        std::vector<char> buffer(options.blockSize);
+        size_t sum = 0;
+        while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0) {
+            for (std::streamsize i = 0; i < file.gcount(); ++i) {
+                sum += static_cast<unsigned char>(buffer[i]);
+            }
+        }
+        return sum;
+    };
+    auto readAsync = [&](const AsyncFileReader::Options& readerOptions) {
+        AsyncFileReader reader(filePath, readerOptions);
+        size_t sum = 0;
+        for (auto block = reader.next(); !block.empty(); block = reader.next()) {
+            for (char c : block) {
+                sum += static_cast<unsigned char>(c);
+            }
+        }
+        return sum;
+    };
+
+    // Чтение с разбором построчным парсером ObjLoader
+    ObjLoader loader;
+    auto parseIfstream = [&] {
+        std::ifstream file(filePath, std::ios::binary);
+        return countIndices(*loader.parseModel(file, "bench"));
+    };
+    auto parseAsync = [&](const AsyncFileReader::Options& readerOptions) {
+        AsyncFileStream file(filePath, readerOptions);
+        return countIndices(*loader.parseModel(file, "bench"));
+    };
+
+    measure(1, readIfstream); // Прогрев кэша ОС
+
+    bool same = true;
+    std::cout << "Read only" << std::endl;
+    Result reference = measure(repeat, readIfstream);
+    same &= report("ifstream", reference, reference);
+    same &= report(std::string("async (") + asyncBackend + ")",
+                   measure(repeat, [&] { return readAsync(options); }), reference);
+    same &= report("async (thread)", measure(repeat, [&] { return readAsync(threadOptions); }), reference);
+
+    std::cout << "Read + parse" << std::endl;
+    reference = measure(repeat, parseIfstream);
+    same &= report("ifstream", reference, reference);
+    same &= report(std::string("async (") + asyncBackend + ")",
+                   measure(repeat, [&] { return parseAsync(options); }), reference);
+    same &= report("async (thread)", measure(repeat, [&] { return parseAsync(threadOptions); }), reference);
+
+#ifdef OBJVIEWER_WITH_ZLIB
+    std::string gzipPath = writeGzipCopy(filePath);
+    double gzipBytes = static_cast<double>(std::filesystem::file_size(gzipPath));
+    std::cout << "Read + parse from gzip (" << gzipBytes / (1024.0 * 1024.0) << " MiB on disk, ratio "
+              << bytes / gzipBytes << ":1, MiB/s of uncompressed data)" << std::endl;
+    same &= report("gzip stream", measure(repeat, [&] {
+        DecompressingFileStream file(gzipPath, {256 * 1024, options.queueDepth, options});
+        return countIndices(*loader.parseModel(file, "bench"));
+    }), reference);
+#endif
+
+    return same ? 0 : 1;
+}
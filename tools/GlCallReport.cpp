@@ -0,0 +1,241 @@
+// Кадры RenderOgl3/ModelRenderer на RecordingGlDevice, без GPU и контекста:
+// число вызовов отрисовки и смен состояния для модели из многих мешей и проверка,
+// что каждый индексированный вызов попадает в границы буферов.
+//
+// OBJGlCallReport [--meshes N] [--segments N] [--materials N] [--frames N] [--budget-ms MS]
+// OBJGlCallReport --replay RECORDING [--meshes N] [--segments N] [--materials N] [--csv PATH|-]
+//
+// Каждый третий меш сжат (PackedVertex). "draw commands" - сколько glDrawElements
+// выдал бы прежний MeshBuffer: по одному на каждый видимый диапазон каждого меша.
+// С --materials N грани каждого меша по очереди получают один из N материалов (usemtl перед каждой
+// гранью), каждый четвёртый материал полупрозрачный, у чётных - одна из двух текстур в шахматную клетку
+// (текстуры с одинаковым содержимым загружаются в GL один раз). Для кадра выводится, сколько смен
+// состояния даёт отсортированный список отрисовки и сколько дал бы порядок мешей.
+// Код возврата ненулевой, если найден некорректный вызов или в кадре запрашивалось
+// расположение uniform: после линковки все они берутся из таблицы ShaderProgram.
+// В конце печатается RenderStats рендера (время кадра на CPU, p50/p95/p99); с --budget-ms
+// код возврата ненулевой и при p95 выше бюджета. Затем - MemoryStats по подсистемам.
+// --replay проигрывает запись ввода окна (см. OBJInputReplay) на этом рендере вместо фиксированных кадров
+// и выводит время каждого кадра в записи и в повторе.
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../RenderOgl3/ModelRenderer.h"
+#include "../RenderOgl3/RecordingGlDevice.h"
+#include "../models/ObjLoader.h"
+#include "ReplayRunner.h"
+#include "SyntheticObj.h"
+
+namespace {
+    std::shared_ptr<const Texture> checkerTexture(uint32_t size, uint8_t shade) {
+        std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * 4);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                uint8_t* pixel = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+                pixel[0] = pixel[1] = pixel[2] = ((x / 8 + y / 8) % 2) ? shade : 255;
+                pixel[3] = 255;
+            }
+        }
+        const uint64_t hash = Texture::hashContent(pixels.data(), pixels.size());
+        return std::make_shared<const Texture>(size, size, std::move(pixels), hash);
+    }
+
+    std::shared_ptr<Model3D> buildModel(int meshCount, int segments, int materials) {
+        ObjLoader loader;
+        auto model = std::make_shared<Model3D>("synthetic");
+        const std::shared_ptr<const Texture> checkers[] = {checkerTexture(64, 40), checkerTexture(64, 120)};
+        // Каждая часть встречает material_0..N-1 в одном порядке, поэтому их номера совпадают с номерами в model
+        for (int k = 0; k < materials; ++k) {
+            Material material;
+            material.name = "material_" + std::to_string(k);
+            material.diffuseColor = {static_cast<float>(k % 7) / 6.0f, 0.5f, 1.0f - static_cast<float>(k % 5) / 4.0f};
+            material.dissolve = k % 4 == 3 ? 0.5f : 1.0f;
+            const uint32_t id = model->getMaterials().define(material);
+            if (k % 2 == 0) {
+                model->setTexture(id, checkers[(k / 2) % 2]);
+            }
+        }
+        for (int i = 0; i < meshCount; ++i) {
+            SyntheticObj::Options options;
+            options.segments = segments;
+            options.materials = materials;
+            options.radius = 1.0f + 0.1f * static_cast<float>(i);
+            std::istringstream stream(SyntheticObj::generate(options).text);
+            auto part = loader.parseModel(stream, "part");
+            for (const auto& mesh : part->getMeshes()) {
+                ModelLoader::processMesh(*mesh);
+                if (i % 3 == 2) {
+                    mesh->compress();
+                }
+                model->addMesh(mesh);
+            }
+        }
+        return model;
+    }
+
+    size_t countIndices(const Model3D& model) {
+        size_t indices = 0;
+        for (const auto& mesh : model.getMeshes()) {
+            indices += mesh->getIndices().size();
+        }
+        return indices;
+    }
+
+    void printFrame(const char* label, const RecordingGlDevice& gl) {
+        std::cout << label << ": draw calls " << gl.drawCalls()
+                  << ", draw commands " << gl.drawCommands()
+                  << ", state changes " << gl.stateChanges()
+                  << ", uniform uploads " << gl.count(RecordingGlDevice::Call::UniformMatrix3fv)
+                                           + gl.count(RecordingGlDevice::Call::UniformMatrix4fv) + gl.count(RecordingGlDevice::Call::Uniform3fv)
+                                           + gl.count(RecordingGlDevice::Call::Uniform4fv)
+                  << ", uniform lookups " << gl.count(RecordingGlDevice::Call::GetUniformLocation)
+                  << ", indices " << gl.indicesDrawn()
+                  << ", invalid " << gl.invalidDrawCount() << '\n';
+    }
+
+    // Смены состояния списка отрисовки: после сортировки и в порядке мешей
+    void printDrawList(const DrawList::Stats& drawList) {
+        std::cout << "  draw list: " << drawList.draws << " draws, " << drawList.stateChanges << " state changes sorted, "
+                  << drawList.unsortedStateChanges << " in mesh order\n";
+    }
+
+    // Ошибки сбрасываются вместе со счётчиками, поэтому выводятся после каждого кадра
+    bool reportErrors(const RecordingGlDevice& gl) {
+        for (const auto& error : gl.getErrors()) {
+            std::cout << "error: " << error << '\n';
+        }
+        return gl.getErrors().empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    int meshCount = 24;
+    int segments = 32;
+    int frames = 8;
+    int materials = 0;
+    double budgetMilliseconds = 0.0;
+    std::string replayPath;
+    std::string csvPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--meshes") {
+            meshCount = std::max(1, std::atoi(argv[i + 1]));
+        } else if (arg == "--segments") {
+            segments = std::max(3, std::atoi(argv[i + 1]));
+        } else if (arg == "--materials") {
+            materials = std::max(0, std::atoi(argv[i + 1]));
+        } else if (arg == "--frames") {
+            frames = std::max(1, std::atoi(argv[i + 1]));
+        } else if (arg == "--budget-ms") {
+            budgetMilliseconds = std::max(0.0, std::atof(argv[i + 1]));
+        } else if (arg == "--replay") {
+            replayPath = argv[i + 1];
+        } else if (arg == "--csv") {
+            csvPath = argv[i + 1];
+        }
+    }
+
+    auto model = buildModel(meshCount, segments, materials);
+    const size_t totalIndices = countIndices(*model);
+
+    RecordingGlDevice gl;
+    ModelRenderer renderer(gl);
+    renderer.initialize();
+    renderer.resize(1280, 720);
+    renderer.setModel(model);
+    renderer.getRenderStats().setFrameBudget(budgetMilliseconds);
+    if (replayPath.empty() || csvPath != "-") {
+        std::cout << "meshes " << model->getMeshes().size() << ", indices " << totalIndices
+                  << ", upload calls " << gl.count(RecordingGlDevice::Call::BufferData) + gl.count(RecordingGlDevice::Call::BufferSubData)
+                  << ", textures " << gl.textureCount() << '\n';
+    }
+
+    bool failed = !reportErrors(gl);
+
+    if (!replayPath.empty()) {
+        std::ofstream csvFile;
+        std::ostream* csv = nullptr;
+        std::ostream* text = &std::cout;
+        if (csvPath == "-") {
+            csv = &std::cout;
+            text = nullptr;
+        } else if (!csvPath.empty()) {
+            csvFile.open(csvPath);
+            csv = &csvFile;
+        }
+        try {
+            failed |= !ReplayRunner::run(InputRecording::load(replayPath), renderer, false, csv, text);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+        failed |= !reportErrors(gl);
+        return failed ? 1 : 0;
+    }
+
+    // Без отсечения рисуется вся модель: все индексы должны дойти до вызовов
+    renderer.setOcclusionCulling(false);
+    gl.resetCounters();
+    renderer.render();
+    printFrame("all visible", gl);
+    printDrawList(renderer.getDrawListStats());
+    if (gl.indicesDrawn() != totalIndices) {
+        std::cout << "expected " << totalIndices << " indices\n";
+        failed = true;
+    }
+    failed |= !reportErrors(gl);
+
+    renderer.setOcclusionCulling(true);
+    for (int frame = 0; frame < frames; ++frame) {
+        renderer.updateRotation(7.0f, 3.0f);
+        gl.resetCounters();
+        renderer.render();
+        if (frame == frames - 1) {
+            printFrame("culled", gl);
+            printDrawList(renderer.getDrawListStats());
+        }
+        if (gl.count(RecordingGlDevice::Call::GetUniformLocation) != 0) {
+            std::cout << "glGetUniformLocation called during a frame\n";
+            failed = true;
+        }
+        // Статистика рендера должна совпадать с тем, что дошло до GL
+        const FrameStats& frameStats = renderer.getRenderStats().lastFrame();
+        const size_t uploads = gl.count(RecordingGlDevice::Call::BufferData) + gl.count(RecordingGlDevice::Call::BufferSubData);
+        if (frameStats.drawCalls != gl.drawCalls() || frameStats.bufferUploads != uploads) {
+            std::cout << "render stats report " << frameStats.drawCalls << " draw calls and " << frameStats.bufferUploads
+                      << " uploads, GL saw " << gl.drawCalls() << " and " << uploads << '\n';
+            failed = true;
+        }
+        // Рендер меняет состояние ровно там, где его меняет отсортированный список
+        if (frameStats.stateChanges != renderer.getDrawListStats().stateChanges) {
+            std::cout << "render stats report " << frameStats.stateChanges << " state changes, the draw list has "
+                      << renderer.getDrawListStats().stateChanges << '\n';
+            failed = true;
+        }
+        failed |= !reportErrors(gl);
+    }
+
+    renderer.getRenderStats().print(std::cout);
+    MemoryStats::global().print(std::cout);
+    if (renderer.getRenderStats().isOverBudget()) {
+        std::cout << "p95 frame time exceeds the " << budgetMilliseconds << " ms budget\n";
+        failed = true;
+    }
+
+    // Повторная загрузка использует те же объекты GL
+    gl.resetCounters();
+    renderer.setModel(model);
+    if (gl.count(RecordingGlDevice::Call::GenBuffers) + gl.count(RecordingGlDevice::Call::GenVertexArrays) != 0) {
+        std::cout << "setModel created new GL objects\n";
+        failed = true;
+    }
+    failed |= !reportErrors(gl);
+
+    std::cout << (failed ? "FAILED" : "OK") << '\n';
+    return failed ? 1 : 0;
+}
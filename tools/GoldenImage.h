@@ -0,0 +1,121 @@
+#ifndef OBJVIEWER_GOLDENIMAGE_H
+#define OBJVIEWER_GOLDENIMAGE_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../render/FrameBuffer.h"
+
+// Эталонные кадры для регрессионных проверок растеризатора. Хранятся в PPM (P6):
+// формат читается без библиотек, а ImageWriter::writePPM уже пишет его
+namespace GoldenImage {
+    struct Comparison {
+        size_t differingPixels = 0; // Пиксели, где хотя бы один канал отличается больше допуска
+        int maxDelta = 0;           // Наибольшая разница канала по всему кадру
+        double differingFraction = 0.0;
+        bool sizeMismatch = false;
+    };
+
+    // Только бинарный P6 с maxval 255, как пишет ImageWriter::writePPM; комментарии в заголовке пропускаются
+    inline bool readPPM(const std::string& filePath, FrameBuffer& frame) {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        auto nextToken = [&file]() {
+            std::string token;
+            char c;
+            while (file.get(c)) {
+                if (c == '#') {
+                    std::string comment;
+                    std::getline(file, comment);
+                } else if (std::isspace(static_cast<unsigned char>(c))) {
+                    if (!token.empty()) {
+                        break;
+                    }
+                } else {
+                    token += c;
+                }
+            }
+            return token;
+        };
+
+        if (nextToken() != "P6") {
+            return false;
+        }
+        int width = std::atoi(nextToken().c_str());
+        int height = std::atoi(nextToken().c_str());
+        if (width <= 0 || height <= 0 || nextToken() != "255") {
+            return false;
+        }
+
+        frame.resize(width, height);
+        std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height; ++y) {
+            if (!file.read(reinterpret_cast<char*>(row.data()), static_cast<std::streamsize>(row.size()))) {
+                return false;
+            }
+            uint32_t* pixels = frame.colorData() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                pixels[x] = row[x * 3] | (row[x * 3 + 1] << 8) | (row[x * 3 + 2] << 16) | 0xFF000000u;
+            }
+        }
+        return true;
+    }
+
+    // Альфа не сравнивается: в PPM её нет
+    inline Comparison compare(const FrameBuffer& actual, const FrameBuffer& expected, int tolerance) {
+        Comparison result;
+        if (actual.getWidth() != expected.getWidth() || actual.getHeight() != expected.getHeight()) {
+            result.sizeMismatch = true;
+            return result;
+        }
+
+        const size_t count = static_cast<size_t>(actual.getWidth()) * actual.getHeight();
+        const uint32_t* a = actual.colorData();
+        const uint32_t* b = expected.colorData();
+        for (size_t i = 0; i < count; ++i) {
+            int delta = 0;
+            for (int shift = 0; shift < 24; shift += 8) {
+                delta = std::max(delta, std::abs(static_cast<int>((a[i] >> shift) & 0xFF) - static_cast<int>((b[i] >> shift) & 0xFF)));
+            }
+            result.maxDelta = std::max(result.maxDelta, delta);
+            if (delta > tolerance) {
+                ++result.differingPixels;
+            }
+        }
+        result.differingFraction = count ? static_cast<double>(result.differingPixels) / static_cast<double>(count) : 0.0;
+        return result;
+    }
+
+    // Отличающиеся пиксели красным поверх приглушённого эталона
+    inline FrameBuffer diffImage(const FrameBuffer& actual, const FrameBuffer& expected, int tolerance) {
+        FrameBuffer diff(expected.getWidth(), expected.getHeight());
+        if (actual.getWidth() != expected.getWidth() || actual.getHeight() != expected.getHeight()) {
+            return diff;
+        }
+
+        const size_t count = static_cast<size_t>(expected.getWidth()) * expected.getHeight();
+        const uint32_t* a = actual.colorData();
+        const uint32_t* b = expected.colorData();
+        uint32_t* out = diff.colorData();
+        for (size_t i = 0; i < count; ++i) {
+            int delta = 0;
+            int luminance = 0;
+            for (int shift = 0; shift < 24; shift += 8) {
+                delta = std::max(delta, std::abs(static_cast<int>((a[i] >> shift) & 0xFF) - static_cast<int>((b[i] >> shift) & 0xFF)));
+                luminance += static_cast<int>((b[i] >> shift) & 0xFF);
+            }
+            uint32_t gray = static_cast<uint32_t>(luminance / 12);
+            out[i] = delta > tolerance ? 0xFF0000FFu : (0xFF000000u | gray | (gray << 8) | (gray << 16));
+        }
+        return diff;
+    }
+}
+
+#endif //OBJVIEWER_GOLDENIMAGE_H
@@ -0,0 +1,226 @@
+// Воспроизведение записанного ввода (OBJViewer_ --record-input ПУТЬ) без окна: камера получает
+// те же updateRotation/updateZoom/resize между теми же кадрами, что и в записи, и для каждого кадра
+// выводится время в записи и в повторе. Так сборки сравниваются на одном и том же взаимодействии.
+//
+// OBJInputReplay RECORDING [--model PATH] [--realtime] [--csv PATH|-]
+// OBJInputReplay --synthesize PATH [--seconds N]
+//
+// Без --model рисуется сфера SyntheticObj 160x160. Рисует SoftwareRenderer с камерой
+// renders/ModelRenderer (перспектива 45 градусов, сдвиг на zoom, поворот X затем Y); тот же повтор
+// на RenderOgl3 - OBJGlCallReport --replay. По умолчанию кадры идут подряд;
+// --realtime ждёт до времени кадра в записи, сохраняя темп взаимодействия.
+// --synthesize пишет запись-образец: перетаскивание по кругу и прокрутку колесом при 60 кадрах/с.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../controller/InputRecording.h"
+#include "../controller/Triangle.h"
+#include "../render/SoftwareRenderer.h"
+#include "../models/ObjLoader.h"
+#include "ReplayRunner.h"
+#include "SyntheticObj.h"
+
+namespace {
+    constexpr float DegreesToRadians = 3.14159265358979f / 180.0f;
+
+    std::vector<Triangle> toTriangles(const Mesh& mesh) {
+        std::vector<Triangle> triangles;
+        const auto& indices = mesh.getIndices();
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            Mesh::Vertex v[3] = {mesh.getVertex(indices[i]), mesh.getVertex(indices[i + 1]), mesh.getVertex(indices[i + 2])};
+            triangles.emplace_back(Triangle::Vertex{v[0].x, v[0].y, v[0].z},
+                                   Triangle::Vertex{v[1].x, v[1].y, v[1].z},
+                                   Triangle::Vertex{v[2].x, v[2].y, v[2].z},
+                                   VecMath::Vector3D<float>(v[0].nx, v[0].ny, v[0].nz),
+                                   VecMath::Vector3D<float>(v[1].nx, v[1].ny, v[1].nz),
+                                   VecMath::Vector3D<float>(v[2].nx, v[2].ny, v[2].nz));
+        }
+        return triangles;
+    }
+
+    // Камера окна (renders/ModelRenderer) поверх SoftwareRenderer
+    class SoftwareTarget {
+    private:
+        SoftwareRenderer renderer{800, 600};
+        std::vector<MeshHandle> handles;
+        float rotationX = 0.0f;
+        float rotationY = 0.0f;
+        float zoom = -5.0f;
+        int width = 800;
+        int height = 600;
+
+    public:
+        explicit SoftwareTarget(const Model3D& model) {
+            renderer.setLightDirection({0.577f, 0.577f, 0.577f});
+            renderer.setClearColor(FrameBuffer::packColor(0.2f, 0.2f, 0.2f));
+            for (const auto& mesh : model.getMeshes()) {
+                handles.push_back(renderer.createMesh(toTriangles(*mesh)));
+            }
+            renderer.setFrameCallback([this](Renderer& target) {
+                for (MeshHandle handle : handles) {
+                    target.draw(handle);
+                }
+            });
+        }
+
+        void resize(int newWidth, int newHeight) {
+            width = std::max(newWidth, 1);
+            height = std::max(newHeight, 1);
+            renderer.resize(width, height);
+        }
+
+        void updateRotation(float deltaX, float deltaY) {
+            rotationY += deltaX * 0.5f;
+            rotationX += deltaY * 0.5f;
+        }
+
+        void updateZoom(float deltaZ) {
+            zoom += deltaZ * 0.1f;
+        }
+
+        void render() {
+            using Matrix = VecMath::Matrix4x4<float>;
+            const float aspect = static_cast<float>(width) / static_cast<float>(height);
+            renderer.setViewProjection(Matrix::perspective(45.0f * DegreesToRadians, aspect, 0.1f, 100.0f) *
+                                       Matrix::translate({0.0f, 0.0f, zoom}) *
+                                       Matrix::rotate(rotationX * DegreesToRadians, {1.0f, 0.0f, 0.0f}) *
+                                       Matrix::rotate(rotationY * DegreesToRadians, {0.0f, 1.0f, 0.0f}));
+            renderer.renderFrame();
+        }
+
+        [[nodiscard]] const RenderStats& getRenderStats() const { return renderer.getRenderStats(); }
+    };
+
+    // Перетаскивание по кругу с прокруткой колесом; Rotate и Zoom - как их слил бы EventQueue за кадр
+    InputRecording synthesize(double seconds) {
+        constexpr double FrameSeconds = 1.0 / 60.0;
+        constexpr int MovesPerFrame = 4;
+        InputRecording recording;
+        auto add = [&](double time, InputSample::Kind kind, float a = 0.0f, float b = 0.0f) {
+            recording.samples.push_back({time, kind, a, b});
+        };
+
+        add(0.0, InputSample::Kind::Resize, 1280.0f, 720.0f);
+        add(0.0, InputSample::Kind::MouseDown, 840.0f, 360.0f);
+        int lastX = 840;
+        int lastY = 360;
+        const int frames = static_cast<int>(seconds / FrameSeconds);
+        for (int frame = 0; frame < frames; ++frame) {
+            const double start = frame * FrameSeconds;
+            int deltaX = 0;
+            int deltaY = 0;
+            for (int move = 1; move <= MovesPerFrame; ++move) {
+                const double time = start + FrameSeconds * move / (MovesPerFrame + 1);
+                const int x = 640 + static_cast<int>(std::lround(200.0 * std::cos(time * 2.0)));
+                const int y = 360 + static_cast<int>(std::lround(120.0 * std::sin(time * 3.0)));
+                add(time, InputSample::Kind::MouseMove, static_cast<float>(x), static_cast<float>(y));
+                deltaX += x - lastX;
+                deltaY += y - lastY;
+                lastX = x;
+                lastY = y;
+            }
+            const double dispatch = start + FrameSeconds * 0.9;
+            if (frame % 30 == 15) {
+                const float wheel = frame % 60 < 30 ? 1.0f : -1.0f;
+                add(dispatch, InputSample::Kind::MouseWheel, wheel);
+                add(dispatch, InputSample::Kind::Zoom, wheel);
+            }
+            if (deltaX != 0 || deltaY != 0) {
+                add(dispatch, InputSample::Kind::Rotate, static_cast<float>(deltaX), static_cast<float>(deltaY));
+            }
+            add(start + FrameSeconds, InputSample::Kind::Frame, 16.0f);
+        }
+        add(frames * FrameSeconds, InputSample::Kind::MouseUp);
+        return recording;
+    }
+
+    void usage() {
+        std::cerr << "Usage: OBJInputReplay RECORDING [--model PATH] [--realtime] [--csv PATH|-]\n"
+                     "       OBJInputReplay --synthesize PATH [--seconds N]\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string recordingPath;
+    std::string modelPath;
+    std::string csvPath;
+    std::string synthesizePath;
+    double seconds = 10.0;
+    bool realtime = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--realtime") {
+            realtime = true;
+        } else if (arg.rfind("--", 0) != 0) {
+            recordingPath = arg;
+        } else if (i + 1 >= argc) {
+            usage();
+            return 2;
+        } else if (arg == "--model") {
+            modelPath = argv[++i];
+        } else if (arg == "--csv") {
+            csvPath = argv[++i];
+        } else if (arg == "--synthesize") {
+            synthesizePath = argv[++i];
+        } else if (arg == "--seconds") {
+            seconds = std::max(0.1, std::atof(argv[++i]));
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    try {
+        if (!synthesizePath.empty()) {
+            synthesize(seconds).save(synthesizePath);
+            return 0;
+        }
+        if (recordingPath.empty()) {
+            usage();
+            return 2;
+        }
+
+        const auto recording = InputRecording::load(recordingPath);
+        std::shared_ptr<Model3D> model;
+        if (modelPath.empty()) {
+            ObjLoader loader;
+            std::istringstream stream(SyntheticObj::generate(160));
+            model = loader.parseModel(stream, "sphere");
+            for (const auto& mesh : model->getMeshes()) {
+                ModelLoader::processMesh(*mesh);
+            }
+        } else {
+            model = ModelLoader::createLoaderForFile(modelPath)->loadModel(modelPath);
+        }
+
+        std::ofstream csvFile;
+        std::ostream* csv = nullptr;
+        std::ostream* text = &std::cout;
+        if (csvPath == "-") {
+            csv = &std::cout;
+            text = nullptr;
+        } else if (!csvPath.empty()) {
+            csvFile.open(csvPath);
+            csv = &csvFile;
+        }
+
+        SoftwareTarget target(*model);
+        const bool replayed = ReplayRunner::run(recording, target, realtime, csv, text);
+        if (text) {
+            MemoryStats::global().print(*text);
+        }
+        return replayed ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
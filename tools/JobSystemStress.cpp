@@ -0,0 +1,188 @@
+// Проверка планировщика задач: корректность под конкуренцией и масштабирование по числу потоков.
+// Код возврата 0 - все проверки прошли.
+//
+// OBJJobStress [--threads N] [--iterations N]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../core/JobSystem.h"
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const std::string& name) {
+        std::cout << (condition ? "  ok    " : "  FAIL  ") << name << std::endl;
+        if (!condition) {
+            ++failures;
+        }
+    }
+
+    double seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Каждый элемент покрыт ровно один раз, в том числе при вложенном parallelFor
+    void checkParallelFor(JobSystem& jobs) {
+        std::vector<std::atomic<int>> hits(1'000'003);
+        jobs.parallelFor(0, hits.size(), 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        bool once = std::all_of(hits.begin(), hits.end(), [](const auto& h) { return h.load() == 1; });
+        check(once, "parallelFor visits every index exactly once");
+
+        std::atomic<size_t> inner{0};
+        jobs.parallelFor(0, 64, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                jobs.parallelFor(0, 1000, 10, [&](size_t b, size_t e) {
+                    inner.fetch_add(e - b, std::memory_order_relaxed);
+                });
+            }
+        });
+        check(inner.load() == 64 * 1000, "nested parallelFor completes without deadlock");
+    }
+
+    // Несколько внешних потоков одновременно засыпают пул мелкими задачами
+    void checkContention(JobSystem& jobs, size_t iterations) {
+        constexpr size_t Producers = 8;
+        std::atomic<size_t> counter{0};
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < Producers; ++p) {
+            producers.emplace_back([&] {
+                JobSystem::TaskGroup group;
+                for (size_t i = 0; i < iterations; ++i) {
+                    jobs.run(group, [&] { counter.fetch_add(1, std::memory_order_relaxed); });
+                }
+                jobs.wait(group);
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        check(counter.load() == Producers * iterations, "tiny tasks from 8 producer threads all run once");
+    }
+
+    // Ромб и цепочка: задача видит результаты всех своих зависимостей
+    void checkTaskGraph(JobSystem& jobs) {
+        for (int round = 0; round < 200; ++round) {
+            std::vector<std::atomic<int>> done(6);
+            std::atomic<bool> ordered{true};
+            auto task = [&](size_t id, std::vector<size_t> deps) {
+                return [&done, &ordered, id, deps] {
+                    for (size_t dep : deps) {
+                        if (done[dep].load(std::memory_order_acquire) != 1) {
+                            ordered = false;
+                        }
+                    }
+                    done[id].fetch_add(1, std::memory_order_release);
+                };
+            };
+
+            JobSystem::TaskGraph graph;
+            auto a = graph.add(task(0, {}));
+            auto b = graph.add(task(1, {0}), {a});
+            auto c = graph.add(task(2, {0}), {a});
+            auto d = graph.add(task(3, {1, 2}), {b, c});
+            auto e = graph.add(task(4, {}));
+            graph.add(task(5, {3, 4}), {d, e});
+            jobs.run(graph);
+
+            bool all = std::all_of(done.begin(), done.end(), [](const auto& v) { return v.load() == 1; });
+            if (!all || !ordered) {
+                check(false, "task graph respects dependencies");
+                return;
+            }
+        }
+        check(true, "task graph respects dependencies");
+    }
+
+    void checkExceptions(JobSystem& jobs) {
+        bool caught = false;
+        try {
+            jobs.parallelFor(0, 1000, 1, [](size_t begin, size_t end) {
+                if (begin <= 500 && 500 < end) {
+                    throw std::runtime_error("expected");
+                }
+            });
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        check(caught, "exception from a task reaches the waiting thread");
+    }
+
+    double computeLoad(JobSystem& jobs, size_t items) {
+        std::vector<double> results(items);
+        auto start = std::chrono::steady_clock::now();
+        jobs.parallelFor(0, items, 16, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                double value = static_cast<double>(i);
+                for (int k = 0; k < 2000; ++k) {
+                    value = std::sqrt(value + k);
+                }
+                results[i] = value;
+            }
+        });
+        double elapsed = seconds(start);
+        volatile double sink = std::accumulate(results.begin(), results.end(), 0.0);
+        (void)sink;
+        return elapsed;
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    size_t iterations = 100'000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--threads") {
+            maxThreads = static_cast<unsigned>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (arg == "--iterations") {
+            iterations = static_cast<size_t>(std::max(1, std::atoi(argv[i + 1])));
+        }
+    }
+
+    {
+        JobSystem jobs(maxThreads);
+        std::cout << "Correctness (" << jobs.getThreadCount() << " threads)" << std::endl;
+        checkParallelFor(jobs);
+        checkContention(jobs, iterations);
+        checkTaskGraph(jobs);
+        checkExceptions(jobs);
+
+        auto stats = jobs.getStats();
+        std::cout << "  executed " << stats.executed << " jobs, stolen " << stats.stolen << std::endl;
+    }
+
+    std::cout << "Scaling (parallelFor, 20000 items)" << std::endl;
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double baseline = 0.0;
+    for (unsigned threads : threadCounts) {
+        JobSystem jobs(threads);
+        computeLoad(jobs, 2000); // Прогрев
+        double elapsed = computeLoad(jobs, 20000);
+        if (threads == 1) {
+            baseline = elapsed;
+        }
+        std::cout << "  " << threads << " threads: " << elapsed * 1000.0 << " ms, speedup "
+                  << (elapsed > 0.0 ? baseline / elapsed : 0.0) << "x" << std::endl;
+    }
+
+    std::cout << (failures == 0 ? "All checks passed" : "Some checks FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,316 @@
+// Пропускная способность разборщиков OBJ и MTL на синтетических файлах из SyntheticObj:
+// OBJModel::loadOBJ, ObjLoader::parseModel (из памяти), ObjLoader::loadModel (файл, чтение
+// с опережением, разбор и обработка мешей) и MTLParser::loadMTL. Выводит МБ/с и граней/с.
+//
+// OBJParseBench [--sizes small,large,huge] [--cases LIST] [--parsers LIST] [--repeat N] [--csv PATH]
+//
+// Размеры: small - сфера 96x96, large - 512x512, huge - 1024x1024 (около 170 МБ с vt/vn),
+// по умолчанию small,large. Варианты (--cases): quads - квады с v/vt/vn, positions - квады
+// без vt и vn, tris, ngons, negative - отрицательные индексы, groups - 64 группы o/g со своими вершинами,
+// usemtl - смена одного из 16 материалов перед каждой гранью, materials - библиотека MTL (256, 16K и 256K материалов).
+// Треугольники loadModel считаются по подмешам, так что проверка заодно видит, что подмеши покрывают все грани.
+// --csv пишет таблицу для сравнения между версиями (МБ = 10^6 байт), "-" - в stdout вместо текста.
+// Лучшее из --repeat повторов; файлы читаются из кэша ОС. Код возврата ненулевой, если разборщик
+// вернул не то число граней (треугольников для loadModel, материалов для MTL), что записал генератор.
+// Для каждого разбора выводится число вызовов operator new (allocs): parseModel и loadModel
+// берут память для промежуточных данных из арены загрузки, у них это десятки, а не миллионы.
+// После loadModel для каждого меша выводится ACMR (вершин на треугольник через FIFO-кэш)
+// до и после MeshOptimizer - только в текстовом выводе, CSV не меняется.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../model/obj/MTLParser.h"
+#include "../model/obj/OBJModel.h"
+#include "../models/ObjLoader.h"
+#include "AllocationCounter.h"
+#include "SyntheticObj.h"
+
+namespace {
+    struct Size {
+        std::string name;
+        int segments;
+        int materials;
+    };
+
+    struct Case {
+        std::string name;
+        SyntheticObj::Options options;
+    };
+
+    struct Options {
+        std::vector<std::string> sizes{"small", "large"};
+        std::vector<std::string> cases;
+        std::vector<std::string> parsers;
+        int repeat = 3;
+        std::string csvPath;
+    };
+
+    const std::vector<Size> AllSizes = {
+            {"small", 96, 256},
+            {"large", 512, 16384},
+            {"huge", 1024, 262144},
+    };
+
+    std::vector<Case> allCases() {
+        using SyntheticObj::FaceShape;
+        std::vector<Case> cases;
+        cases.push_back({"quads", {}});
+        cases.push_back({"positions", {}});
+        cases.back().options.texCoords = false;
+        cases.back().options.normals = false;
+        cases.push_back({"tris", {}});
+        cases.back().options.faces = FaceShape::Triangles;
+        cases.push_back({"ngons", {}});
+        cases.back().options.faces = FaceShape::Polygons;
+        cases.push_back({"negative", {}});
+        cases.back().options.negativeIndices = true;
+        cases.push_back({"groups", {}});
+        cases.back().options.groups = 64;
+        cases.push_back({"usemtl", {}});
+        cases.back().options.materials = 16;
+        return cases;
+    }
+
+    std::vector<std::string> splitList(const std::string& list) {
+        std::vector<std::string> items;
+        std::istringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    bool selected(const std::vector<std::string>& filter, const std::string& name) {
+        return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+    }
+
+    struct Measurement {
+        double seconds = 0.0;
+        size_t items = 0;
+        size_t allocations = 0;
+    };
+
+    // Лучшее время из нескольких повторов; body возвращает число разобранных элементов
+    Measurement measure(int repeat, const std::function<size_t()>& body) {
+        Measurement result;
+        for (int i = 0; i < repeat; ++i) {
+            const size_t allocationsBefore = AllocationCounter::count();
+            auto start = std::chrono::steady_clock::now();
+            result.items = body();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.allocations = AllocationCounter::count() - allocationsBefore;
+            if (i == 0 || seconds < result.seconds) {
+                result.seconds = seconds;
+            }
+        }
+        return result;
+    }
+
+    size_t countFaces(const Model3D& model) {
+        size_t faces = 0;
+        for (const auto& mesh : model.getMeshes()) {
+            faces += mesh->getFaceCount();
+        }
+        return faces;
+    }
+
+    size_t countTriangles(const Model3D& model) {
+        size_t indices = 0;
+        for (const auto& mesh : model.getMeshes()) {
+            for (const auto& submesh : mesh->getSubmeshes()) {
+                indices += submesh.indexCount;
+            }
+        }
+        return indices / 3;
+    }
+
+    class Report {
+    private:
+        std::ofstream csvFile;
+        std::ostream* csv = nullptr;
+        std::ostream* text = &std::cout;
+        bool failed = false;
+
+    public:
+        explicit Report(const std::string& csvPath) {
+            if (csvPath == "-") {
+                csv = &std::cout;
+                text = nullptr;
+            } else if (!csvPath.empty()) {
+                csvFile.open(csvPath);
+                if (!csvFile.is_open()) {
+                    throw std::runtime_error("Failed to open " + csvPath);
+                }
+                csv = &csvFile;
+            }
+            if (csv) {
+                *csv << "parser,case,size,bytes,items,item_unit,seconds,mb_per_s,items_per_s,check,allocations\n";
+            }
+        }
+
+        void add(const std::string& parser, const std::string& caseName, const std::string& size, size_t bytes,
+                 const char* unit, size_t expected, const Measurement& result) {
+            const auto [seconds, items, allocations] = result;
+            const bool ok = items == expected;
+            failed |= !ok;
+            const double megabytes = static_cast<double>(bytes) / 1e6;
+            if (csv) {
+                *csv << parser << ',' << caseName << ',' << size << ',' << bytes << ',' << expected << ',' << unit << ','
+                     << seconds << ',' << megabytes / seconds << ',' << static_cast<double>(expected) / seconds << ','
+                     << (ok ? "ok" : "mismatch") << ',' << allocations << '\n';
+            }
+            if (text) {
+                std::string label = parser;
+                label.resize(24, ' ');
+                *text << "  " << label << seconds * 1000.0 << " ms, " << megabytes / seconds << " MB/s, "
+                      << static_cast<double>(expected) / seconds / 1e6 << " M " << unit << "/s, " << allocations << " allocs";
+                if (!ok) {
+                    *text << "  MISMATCH: " << items << " " << unit << ", expected " << expected;
+                }
+                *text << std::endl;
+            }
+        }
+
+        // ACMR по мешам из MeshOptimizer::Report и по модели в целом, взвешенный по треугольникам
+        void optimization(const Model3D& model) {
+            if (!text) {
+                return;
+            }
+            double before = 0.0;
+            double after = 0.0;
+            size_t triangles = 0;
+            for (const auto& mesh : model.getMeshes()) {
+                const auto& optimized = mesh->getOptimizationReport();
+                *text << "    ACMR " << mesh->getName() << ": " << optimized.acmrBefore << " -> " << optimized.acmrAfter
+                      << " (cache " << optimized.cacheSize << ", " << optimized.triangleCount << " triangles, "
+                      << optimized.vertexCount << " vertices)" << std::endl;
+                before += static_cast<double>(optimized.acmrBefore) * static_cast<double>(optimized.triangleCount);
+                after += static_cast<double>(optimized.acmrAfter) * static_cast<double>(optimized.triangleCount);
+                triangles += optimized.triangleCount;
+            }
+            if (model.getMeshes().size() > 1 && triangles > 0) {
+                *text << "    ACMR model: " << before / static_cast<double>(triangles) << " -> "
+                      << after / static_cast<double>(triangles) << std::endl;
+            }
+        }
+
+        void section(const std::string& title) {
+            if (text) {
+                *text << title << std::endl;
+            }
+        }
+
+        [[nodiscard]] bool hasFailed() const { return failed; }
+    };
+
+    void usage() {
+        std::cerr << "Usage: OBJParseBench [--sizes small,large,huge] [--cases quads,positions,tris,ngons,negative,groups,usemtl,materials]\n"
+                     "                     [--parsers loadOBJ,parseModel,loadModel,loadMTL] [--repeat N] [--csv PATH|-]\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "--sizes") {
+            options.sizes = splitList(value);
+        } else if (arg == "--cases") {
+            options.cases = splitList(value);
+        } else if (arg == "--parsers") {
+            options.parsers = splitList(value);
+        } else if (arg == "--repeat") {
+            options.repeat = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--csv") {
+            options.csvPath = value;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    const auto directory = std::filesystem::temp_directory_path();
+    Report report(options.csvPath);
+    ObjLoader loader;
+
+    for (const auto& size : AllSizes) {
+        if (!selected(options.sizes, size.name)) {
+            continue;
+        }
+
+        for (auto testCase : allCases()) {
+            if (!selected(options.cases, testCase.name)) {
+                continue;
+            }
+            testCase.options.segments = size.segments;
+            const auto document = SyntheticObj::generate(testCase.options);
+            const auto path = (directory / ("objviewer_parse_bench_" + testCase.name + ".obj")).string();
+            SyntheticObj::writeText(path, document.text);
+            const size_t bytes = document.text.size();
+
+            report.section(testCase.name + " " + size.name + ": " + std::to_string(bytes / 1000000.0) + " MB, "
+                           + std::to_string(document.faces) + " faces");
+
+            if (selected(options.parsers, "loadOBJ")) {
+                report.add("OBJModel::loadOBJ", testCase.name, size.name, bytes, "faces", document.faces,
+                           measure(options.repeat, [&] {
+                               auto model = OBJModel::loadOBJ(path);
+                               return model ? model->getFaces().size() : 0;
+                           }));
+            }
+            if (selected(options.parsers, "parseModel")) {
+                report.add("ObjLoader::parseModel", testCase.name, size.name, bytes, "faces", document.faces,
+                           measure(options.repeat, [&] {
+                               ModelLoader::LoadArena arena;
+                               std::istringstream stream(document.text);
+                               return countFaces(*loader.parseModel(stream, "bench", &arena));
+                           }));
+            }
+            if (selected(options.parsers, "loadModel")) {
+                std::shared_ptr<Model3D> loaded;
+                report.add("ObjLoader::loadModel", testCase.name, size.name, bytes, "triangles", document.triangles,
+                           measure(options.repeat, [&] {
+                               loaded.reset();
+                               loaded = loader.loadModel(path);
+                               return countTriangles(*loaded);
+                           }));
+                report.optimization(*loaded);
+            }
+            std::filesystem::remove(path);
+        }
+
+        if (selected(options.parsers, "loadMTL") && selected(options.cases, "materials")) {
+            const std::string text = SyntheticObj::generateMtl(size.materials);
+            const auto path = (directory / "objviewer_parse_bench.mtl").string();
+            SyntheticObj::writeText(path, text);
+
+            report.section("materials " + size.name + ": " + std::to_string(text.size() / 1000000.0) + " MB, "
+                           + std::to_string(size.materials) + " materials");
+            report.add("MTLParser::loadMTL", "materials", size.name, text.size(), "materials",
+                       static_cast<size_t>(size.materials), measure(options.repeat, [&] {
+                           auto materials = MTLParser::loadMTL(path);
+                           return materials ? materials->size() : 0;
+                       }));
+            std::filesystem::remove(path);
+        }
+    }
+
+    return report.hasFailed() ? 1 : 0;
+}
@@ -0,0 +1,417 @@
+// Бенчмарк и регрессионная проверка программного рендера (SoftwareRenderer) без окна.
+// Сцена проходит фиксированный путь камеры (облёт с покачиванием по высоте) на нескольких
+// разрешениях и числах потоков; выводятся мс/кадр, Мпикс/с и p50/p95 времени кадра из RenderStats.
+//
+// OBJRasterBench [--sizes 320x240,1280x720] [--threads 1,2,4] [--frames N] [--scenes LIST]
+//                [--model PATH]... [--golden DIR] [--update-golden] [--tolerance N] [--max-diff F]
+//                [--csv PATH|-]
+//
+// Сцены: sphere - одна сфера SyntheticObj 160x160 (51K треугольников), spheres - 27 пересекающихся
+// сфер 48x48, размещённых через updateTransform (много мешей и перекрытий); --model добавляет
+// сцену из файла. Геометрия передаётся рендеру как Triangle, свет - направленный Light.
+// Потоки не делят кадр: каждый рендерит свою часть пути своим SoftwareRenderer, поэтому кадры
+// не зависят от числа потоков - это тоже проверяется.
+//
+// --golden DIR сравнивает кадры 0, N/4, N/2, 3N/4 с DIR/<сцена>_<Ш>x<В>_<кадр>.ppm: пиксель отличается,
+// если разница канала больше --tolerance (по умолчанию 2), кадр не проходит, если таких пикселей
+// больше доли --max-diff (0.001). Для непрошедших кадров рядом пишутся .actual.ppm и .diff.ppm.
+// --update-golden перезаписывает эталоны текущими кадрами. Код возврата ненулевой при расхождении.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../controller/Triangle.h"
+#include "../render/Framing.h"
+#include "../render/ImageWriter.h"
+#include "../render/Light.h"
+#include "../render/SoftwareRenderer.h"
+#include "../models/ObjLoader.h"
+#include "GoldenImage.h"
+#include "SyntheticObj.h"
+
+namespace {
+    struct Resolution {
+        int width;
+        int height;
+    };
+
+    struct Options {
+        std::vector<Resolution> sizes{{320, 240}, {1280, 720}};
+        std::vector<int> threads{1, 2, 4};
+        std::vector<std::string> scenes;
+        std::vector<std::string> models;
+        int frames = 24;
+        std::string goldenDirectory;
+        bool updateGolden = false;
+        int tolerance = 2;
+        double maxDiffFraction = 0.001;
+        std::string csvPath;
+    };
+
+    // Меши сцены как треугольники и их матрицы модели
+    struct Scene {
+        std::string name;
+        std::vector<std::vector<Triangle>> meshes{};
+        std::vector<VecMath::Matrix4x4<float>> transforms{};
+        Mesh::Bounds bounds{};
+        size_t triangles = 0;
+    };
+
+    std::vector<Triangle> toTriangles(const Mesh& mesh) {
+        std::vector<Triangle> triangles;
+        const auto& indices = mesh.getIndices();
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            Mesh::Vertex v[3] = {mesh.getVertex(indices[i]), mesh.getVertex(indices[i + 1]), mesh.getVertex(indices[i + 2])};
+            triangles.emplace_back(Triangle::Vertex{v[0].x, v[0].y, v[0].z},
+                                   Triangle::Vertex{v[1].x, v[1].y, v[1].z},
+                                   Triangle::Vertex{v[2].x, v[2].y, v[2].z},
+                                   VecMath::Vector3D<float>(v[0].nx, v[0].ny, v[0].nz),
+                                   VecMath::Vector3D<float>(v[1].nx, v[1].ny, v[1].nz),
+                                   VecMath::Vector3D<float>(v[2].nx, v[2].ny, v[2].nz));
+        }
+        return triangles;
+    }
+
+    void addModel(Scene& scene, const Model3D& model, const VecMath::Matrix4x4<float>& transform) {
+        for (const auto& mesh : model.getMeshes()) {
+            scene.meshes.push_back(toTriangles(*mesh));
+            scene.transforms.push_back(transform);
+            scene.triangles += scene.meshes.back().size();
+        }
+    }
+
+    // Габариты в мировых координатах, по вершинам после матрицы модели
+    void computeBounds(Scene& scene) {
+        bool first = true;
+        for (size_t i = 0; i < scene.meshes.size(); ++i) {
+            const auto& m = scene.transforms[i];
+            for (const auto& triangle : scene.meshes[i]) {
+                for (const auto& v : triangle.getVertices()) {
+                    float p[3] = {m.m00 * v.x + m.m01 * v.y + m.m02 * v.z + m.m03,
+                                  m.m10 * v.x + m.m11 * v.y + m.m12 * v.z + m.m13,
+                                  m.m20 * v.x + m.m21 * v.y + m.m22 * v.z + m.m23};
+                    for (int axis = 0; axis < 3; ++axis) {
+                        scene.bounds.min[axis] = first ? p[axis] : std::min(scene.bounds.min[axis], p[axis]);
+                        scene.bounds.max[axis] = first ? p[axis] : std::max(scene.bounds.max[axis], p[axis]);
+                    }
+                    first = false;
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<Model3D> sphereModel(int segments) {
+        ObjLoader loader;
+        std::istringstream stream(SyntheticObj::generate(segments));
+        auto model = loader.parseModel(stream, "sphere");
+        for (const auto& mesh : model->getMeshes()) {
+            ModelLoader::processMesh(*mesh);
+        }
+        return model;
+    }
+
+    std::vector<Scene> buildScenes(const Options& options) {
+        std::vector<Scene> scenes;
+        auto selected = [&](const std::string& name) {
+            return options.scenes.empty() || std::find(options.scenes.begin(), options.scenes.end(), name) != options.scenes.end();
+        };
+
+        if (selected("sphere")) {
+            Scene scene{"sphere"};
+            addModel(scene, *sphereModel(160), VecMath::Matrix4x4<float>());
+            scenes.push_back(std::move(scene));
+        }
+        if (selected("spheres")) {
+            Scene scene{"spheres"};
+            auto sphere = sphereModel(48);
+            for (int i = 0; i < 27; ++i) {
+                VecMath::Vector3D<float> offset{static_cast<float>(i % 3 - 1) * 1.6f,
+                                                static_cast<float>(i / 3 % 3 - 1) * 1.6f,
+                                                static_cast<float>(i / 9 - 1) * 1.6f};
+                float radius = 0.8f + 0.15f * static_cast<float>(i % 4);
+                addModel(scene, *sphere, VecMath::Matrix4x4<float>::translate(offset) *
+                                         VecMath::Matrix4x4<float>::scale({radius, radius, radius}));
+            }
+            scenes.push_back(std::move(scene));
+        }
+        for (const auto& path : options.models) {
+            Scene scene{ModelLoader::modelName(path)};
+            addModel(scene, *ModelLoader::createLoaderForFile(path)->loadModel(path), VecMath::Matrix4x4<float>());
+            scenes.push_back(std::move(scene));
+        }
+
+        for (auto& scene : scenes) {
+            computeBounds(scene);
+        }
+        return scenes;
+    }
+
+    // Облёт: полный оборот по yaw, наклон качается между 0.1 и 0.8 радиана
+    std::vector<VecMath::Matrix4x4<float>> cameraPath(const Mesh::Bounds& bounds, float aspect, int frames) {
+        constexpr float TwoPi = 6.28318530718f;
+        std::vector<VecMath::Matrix4x4<float>> path;
+        path.reserve(frames);
+        for (int i = 0; i < frames; ++i) {
+            float t = static_cast<float>(i) / static_cast<float>(frames);
+            path.push_back(Framing::fitBounds(bounds, aspect, TwoPi * t, 0.45f + 0.35f * std::sin(2.0f * TwoPi * t)).viewProjection);
+        }
+        return path;
+    }
+
+    uint64_t hashFrame(const FrameBuffer& frame) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        const size_t count = static_cast<size_t>(frame.getWidth()) * frame.getHeight();
+        for (size_t i = 0; i < count; ++i) {
+            hash = (hash ^ frame.colorData()[i]) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // Рендер сцены с готовыми мешами; свет неподвижен относительно сцены
+    class SceneRenderer {
+    private:
+        SoftwareRenderer renderer;
+        std::vector<MeshHandle> handles;
+
+    public:
+        SceneRenderer(const Scene& scene, const Resolution& size, const Light& light) : renderer(size.width, size.height) {
+            renderer.setLightDirection(light.getDirection());
+            renderer.setClearColor(FrameBuffer::packColor(0.2f, 0.2f, 0.2f));
+            for (size_t i = 0; i < scene.meshes.size(); ++i) {
+                handles.push_back(renderer.createMesh(scene.meshes[i]));
+                renderer.updateTransform(handles.back(), scene.transforms[i]);
+            }
+            renderer.setFrameCallback([this](Renderer& target) {
+                for (MeshHandle handle : handles) {
+                    target.draw(handle);
+                }
+            });
+        }
+
+        const FrameBuffer& render(const VecMath::Matrix4x4<float>& viewProjection) {
+            renderer.setViewProjection(viewProjection);
+            renderer.renderFrame();
+            return renderer.getFrame();
+        }
+
+        [[nodiscard]] const RenderStats& getRenderStats() const { return renderer.getRenderStats(); }
+    };
+
+    std::vector<int> goldenFrames(int frames) {
+        std::vector<int> result;
+        for (int quarter = 0; quarter < 4; ++quarter) {
+            int frame = frames * quarter / 4;
+            if (result.empty() || result.back() != frame) {
+                result.push_back(frame);
+            }
+        }
+        return result;
+    }
+
+    std::string goldenName(const Scene& scene, const Resolution& size, int frame) {
+        char suffix[48];
+        std::snprintf(suffix, sizeof(suffix), "_%dx%d_%02d", size.width, size.height, frame);
+        return scene.name + suffix;
+    }
+
+    // false - кадр не совпал с эталоном или эталона нет
+    bool checkGolden(const Options& options, const std::string& name, const FrameBuffer& frame, std::ostream* text) {
+        const auto base = std::filesystem::path(options.goldenDirectory) / name;
+        if (options.updateGolden) {
+            ImageWriter::writePPM(base.string() + ".ppm", frame);
+            return true;
+        }
+
+        FrameBuffer expected;
+        if (!GoldenImage::readPPM(base.string() + ".ppm", expected)) {
+            if (text) {
+                *text << "  golden " << name << ": missing (run with --update-golden)" << std::endl;
+            }
+            return false;
+        }
+
+        const auto comparison = GoldenImage::compare(frame, expected, options.tolerance);
+        const bool passed = !comparison.sizeMismatch && comparison.differingFraction <= options.maxDiffFraction;
+        if (text) {
+            *text << "  golden " << name << ": " << (passed ? "ok" : "FAILED");
+            if (comparison.sizeMismatch) {
+                *text << ", size differs";
+            } else {
+                *text << ", " << comparison.differingPixels << " pixels differ, max delta " << comparison.maxDelta;
+            }
+            *text << std::endl;
+        }
+        if (!passed) {
+            ImageWriter::writePPM(base.string() + ".actual.ppm", frame);
+            ImageWriter::writePPM(base.string() + ".diff.ppm", GoldenImage::diffImage(frame, expected, options.tolerance));
+        }
+        return passed;
+    }
+
+    std::vector<std::string> splitList(const std::string& list) {
+        std::vector<std::string> items;
+        std::istringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    void usage() {
+        std::cerr << "Usage: OBJRasterBench [--sizes WxH,...] [--threads N,...] [--frames N] [--scenes sphere,spheres]\n"
+                     "                      [--model PATH]... [--golden DIR] [--update-golden] [--tolerance N]\n"
+                     "                      [--max-diff F] [--csv PATH|-]\n";
+    }
+
+    bool parseArguments(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--update-golden") {
+                options.updateGolden = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                return false;
+            }
+            std::string value = argv[++i];
+            if (arg == "--sizes") {
+                options.sizes.clear();
+                for (const auto& item : splitList(value)) {
+                    Resolution size{};
+                    if (std::sscanf(item.c_str(), "%dx%d", &size.width, &size.height) != 2 || size.width <= 0 || size.height <= 0) {
+                        return false;
+                    }
+                    options.sizes.push_back(size);
+                }
+            } else if (arg == "--threads") {
+                options.threads.clear();
+                for (const auto& item : splitList(value)) {
+                    options.threads.push_back(std::max(1, std::atoi(item.c_str())));
+                }
+            } else if (arg == "--frames") {
+                options.frames = std::max(1, std::atoi(value.c_str()));
+            } else if (arg == "--scenes") {
+                options.scenes = splitList(value);
+            } else if (arg == "--model") {
+                options.models.push_back(value);
+            } else if (arg == "--golden") {
+                options.goldenDirectory = value;
+            } else if (arg == "--tolerance") {
+                options.tolerance = std::max(0, std::atoi(value.c_str()));
+            } else if (arg == "--max-diff") {
+                options.maxDiffFraction = std::max(0.0, std::atof(value.c_str()));
+            } else if (arg == "--csv") {
+                options.csvPath = value;
+            } else {
+                return false;
+            }
+        }
+        return !options.sizes.empty() && !options.threads.empty() && (!options.updateGolden || !options.goldenDirectory.empty());
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+    if (options.updateGolden) {
+        std::filesystem::create_directories(options.goldenDirectory);
+    }
+
+    std::ofstream csvFile;
+    std::ostream* csv = nullptr;
+    std::ostream* text = &std::cout;
+    if (options.csvPath == "-") {
+        csv = &std::cout;
+        text = nullptr;
+    } else if (!options.csvPath.empty()) {
+        csvFile.open(options.csvPath);
+        csv = &csvFile;
+    }
+    if (csv) {
+        *csv << "scene,width,height,threads,frames,triangles,ms_per_frame,mpixels_per_s,p50_ms,p95_ms,consistent\n";
+    }
+
+    const Light light(LightType::Directional, {0.0f, 0.0f, 0.0f}, {0.4f, 0.7f, 1.0f}, {1.0f, 1.0f, 1.0f}, 1.0f);
+    bool failed = false;
+
+    for (const auto& scene : buildScenes(options)) {
+        for (const auto& size : options.sizes) {
+            const auto path = cameraPath(scene.bounds, static_cast<float>(size.width) / static_cast<float>(size.height), options.frames);
+            const auto checked = goldenFrames(options.frames);
+            if (text) {
+                *text << scene.name << " " << size.width << "x" << size.height << ": " << scene.meshes.size() << " meshes, "
+                      << scene.triangles << " triangles, " << path.size() << " frames" << std::endl;
+            }
+
+            std::vector<uint64_t> reference;
+            for (int threadCount : options.threads) {
+                // Рендеры создаются до замера: подготовка мешей не входит во время кадра
+                std::vector<std::unique_ptr<SceneRenderer>> renderers;
+                for (int t = 0; t < threadCount; ++t) {
+                    renderers.push_back(std::make_unique<SceneRenderer>(scene, size, light));
+                }
+                std::vector<uint64_t> hashes(path.size());
+
+                auto start = std::chrono::steady_clock::now();
+                std::vector<std::thread> workers;
+                for (int t = 0; t < threadCount; ++t) {
+                    workers.emplace_back([&, t] {
+                        for (size_t frame = t; frame < path.size(); frame += threadCount) {
+                            hashes[frame] = hashFrame(renderers[t]->render(path[frame]));
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                // Хэш кадра считается в замере, но его стоимость - один проход по буферу, как у очистки
+                const bool consistent = reference.empty() || hashes == reference;
+                if (reference.empty()) {
+                    reference = hashes;
+                }
+                failed |= !consistent;
+
+                const double msPerFrame = seconds * 1000.0 / static_cast<double>(path.size());
+                const double megapixels = static_cast<double>(size.width) * size.height * static_cast<double>(path.size()) / 1e6 / seconds;
+                const auto summary = renderers[0]->getRenderStats().getFrameTimes().summarize();
+                if (text) {
+                    *text << "  threads " << threadCount << ": " << msPerFrame << " ms/frame, " << megapixels << " Mpixels/s, "
+                          << "frame p50 " << summary.p50 << " ms, p95 " << summary.p95 << " ms"
+                          << (consistent ? "" : "  FRAMES DIFFER FROM THE FIRST THREAD COUNT") << std::endl;
+                }
+                if (csv) {
+                    *csv << scene.name << ',' << size.width << ',' << size.height << ',' << threadCount << ',' << path.size() << ','
+                         << scene.triangles << ',' << msPerFrame << ',' << megapixels << ',' << summary.p50 << ','
+                         << summary.p95 << ',' << (consistent ? "yes" : "no") << '\n';
+                }
+            }
+
+            if (!options.goldenDirectory.empty()) {
+                SceneRenderer renderer(scene, size, light);
+                for (int frame : checked) {
+                    failed |= !checkGolden(options, goldenName(scene, size, frame), renderer.render(path[frame]), text);
+                }
+            }
+        }
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+#ifndef OBJVIEWER_REPLAYRUNNER_H
+#define OBJVIEWER_REPLAYRUNNER_H
+
+#include <chrono>
+#include <ostream>
+#include <thread>
+#include "../controller/InputRecording.h"
+#include "../render/RenderStats.h"
+
+// Общий цикл воспроизведения записи ввода для OBJInputReplay (SoftwareRenderer) и OBJGlCallReport
+// (RenderOgl3): у Target есть resize/updateRotation/updateZoom, render и getRenderStats
+namespace ReplayRunner {
+    // csv - по строке на кадр, text - сводка времени кадров в записи и в повторе; любой из них может быть nullptr.
+    // realtime ждёт начала кадра по времени записи, иначе кадры идут подряд
+    template<typename Target>
+    bool run(const InputRecording& recording, Target& target, bool realtime, std::ostream* csv, std::ostream* text) {
+        if (csv) {
+            *csv << "frame,seconds,raw_events,recorded_ms,replay_ms,triangles_submitted,triangles_rasterized,draw_calls\n";
+        }
+
+        FrameTimeHistogram recorded(recording.samples.size() + 1);
+        FrameTimeHistogram replayed(recording.samples.size() + 1);
+        InputReplay replay(recording);
+        InputReplay::Frame frame;
+        const auto start = std::chrono::steady_clock::now();
+        while (replay.nextFrame(target, frame)) {
+            if (realtime) {
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(frame.seconds - frame.recordedMilliseconds / 1000.0)));
+            }
+            target.render();
+
+            const FrameStats& stats = target.getRenderStats().lastFrame();
+            recorded.add(frame.recordedMilliseconds);
+            replayed.add(stats.frameMilliseconds);
+            if (csv) {
+                *csv << frame.index << ',' << frame.seconds << ',' << frame.rawEvents << ',' << frame.recordedMilliseconds << ','
+                     << stats.frameMilliseconds << ',' << stats.trianglesSubmitted << ',' << stats.trianglesRasterized << ','
+                     << stats.drawCalls << '\n';
+            }
+        }
+
+        if (text) {
+            auto print = [&](const char* label, const FrameTimeHistogram& times) {
+                const auto summary = times.summarize();
+                *text << label << summary.frames << " frames, ms mean " << summary.mean << " p50 " << summary.p50
+                      << " p95 " << summary.p95 << " p99 " << summary.p99 << " max " << summary.max << '\n';
+            };
+            *text << "input: " << recording.count(InputSample::Kind::MouseMove) << " mouse moves, "
+                  << recording.count(InputSample::Kind::MouseWheel) << " wheel steps, "
+                  << recording.count(InputSample::Kind::Rotate) << " rotations and "
+                  << recording.count(InputSample::Kind::Zoom) << " zooms applied\n";
+            print("recorded: ", recorded);
+            print("replayed: ", replayed);
+        }
+        return replayed.size() > 0;
+    }
+}
+
+#endif //OBJVIEWER_REPLAYRUNNER_H
@@ -0,0 +1,206 @@
+#ifndef OBJVIEWER_SYNTHETICOBJ_H
+#define OBJVIEWER_SYNTHETICOBJ_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+// Генератор тестовых OBJ для бенчмарков: UV-сфера с v/vt/vn и четырёхугольными гранями.
+// segments x segments квадов, (segments + 1)^2 вершин
+namespace SyntheticObj {
+    enum class FaceShape {
+        Triangles,
+        Quads,
+        Polygons // Шестиугольники из пар соседних квадов, в конце ряда - квад
+    };
+
+    // Вариант файла для бенчмарка разбора. Вывод детерминирован: одинаковые параметры дают одинаковые байты
+    struct Options {
+        int segments = 64;
+        bool texCoords = true;
+        bool normals = true;
+        FaceShape faces = FaceShape::Quads;
+        bool negativeIndices = false; // Индексы относительно конца списка вершин: -1 - последняя
+        int groups = 1;               // Полосы сферы, каждая под своим o (чётные) или g (нечётные) со своими вершинами
+        int materials = 0;            // usemtl material_N перед каждой гранью, N по кругу из materials имён
+        float radius = 1.0f;
+    };
+
+    struct Document {
+        std::string text;
+        size_t positions = 0;
+        size_t faces = 0;
+        size_t triangles = 0; // После веерной триангуляции граней
+    };
+    inline std::string generate(int segments, float radius = 1.0f) {
+        constexpr float Pi = 3.14159265358979f;
+        std::string text;
+        text.reserve(static_cast<size_t>(segments + 1) * (segments + 1) * 110 + static_cast<size_t>(segments) * segments * 60);
+
+        char line[192];
+        for (int i = 0; i <= segments; ++i) {
+            float theta = Pi * static_cast<float>(i) / static_cast<float>(segments);
+            for (int j = 0; j <= segments; ++j) {
+                float phi = 2.0f * Pi * static_cast<float>(j) / static_cast<float>(segments);
+                float x = std::sin(theta) * std::cos(phi);
+                float y = std::cos(theta);
+                float z = std::sin(theta) * std::sin(phi);
+                std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x * radius, y * radius, z * radius);
+                text += line;
+                std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", static_cast<float>(j) / segments, static_cast<float>(i) / segments);
+                text += line;
+                std::snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n", x, y, z);
+                text += line;
+            }
+        }
+
+        // Обход против часовой стрелки снаружи сферы
+        const int row = segments + 1;
+        for (int i = 0; i < segments; ++i) {
+            for (int j = 0; j < segments; ++j) {
+                int a = i * row + j + 1;
+                int b = a + row;
+                int c = b + 1;
+                int d = a + 1;
+                std::snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n",
+                              a, a, a, d, d, d, c, c, c, b, b, b);
+                text += line;
+            }
+        }
+        return text;
+    }
+
+    inline Document generate(const Options& options) {
+        constexpr float Pi = 3.14159265358979f;
+        const int segments = std::max(options.segments, 3);
+        const int groups = std::clamp(options.groups, 1, segments);
+        const int row = segments + 1;
+
+        Document document;
+        const size_t cells = static_cast<size_t>(segments) * segments;
+        document.text.reserve(static_cast<size_t>(row) * (row + groups) * 110 + cells * 60);
+
+        char line[192];
+        auto index = [&](char* out, size_t size, int value, int bandVertices) {
+            // value - номер вершины внутри полосы, с нуля
+            int written = options.negativeIndices ? value - bandVertices
+                                                  : static_cast<int>(document.positions) - bandVertices + value + 1;
+            int length = std::snprintf(out, size, "%d", written);
+            if (options.texCoords && options.normals) {
+                length += std::snprintf(out + length, size - length, "/%d/%d", written, written);
+            } else if (options.texCoords) {
+                length += std::snprintf(out + length, size - length, "/%d", written);
+            } else if (options.normals) {
+                length += std::snprintf(out + length, size - length, "//%d", written);
+            }
+            return length;
+        };
+        auto face = [&](const int* corners, int count, int bandVertices) {
+            if (options.materials > 0) {
+                std::snprintf(line, sizeof(line), "usemtl material_%d\n", static_cast<int>(document.faces % options.materials));
+                document.text += line;
+            }
+            char* out = line;
+            size_t left = sizeof(line);
+            int length = std::snprintf(out, left, "f");
+            for (int k = 0; k < count; ++k) {
+                out[length++] = ' ';
+                length += index(out + length, left - length, corners[k], bandVertices);
+            }
+            out[length++] = '\n';
+            document.text.append(line, static_cast<size_t>(length));
+            ++document.faces;
+            document.triangles += static_cast<size_t>(count - 2);
+        };
+
+        for (int group = 0; group < groups; ++group) {
+            const int firstRow = segments * group / groups;
+            const int lastRow = segments * (group + 1) / groups;
+            std::snprintf(line, sizeof(line), "%s part_%d\n", group % 2 == 0 ? "o" : "g", group);
+            document.text += line;
+
+            for (int i = firstRow; i <= lastRow; ++i) {
+                float theta = Pi * static_cast<float>(i) / static_cast<float>(segments);
+                for (int j = 0; j <= segments; ++j) {
+                    float phi = 2.0f * Pi * static_cast<float>(j) / static_cast<float>(segments);
+                    float x = std::sin(theta) * std::cos(phi);
+                    float y = std::cos(theta);
+                    float z = std::sin(theta) * std::sin(phi);
+                    std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x * options.radius, y * options.radius, z * options.radius);
+                    document.text += line;
+                    if (options.texCoords) {
+                        std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", static_cast<float>(j) / segments, static_cast<float>(i) / segments);
+                        document.text += line;
+                    }
+                    if (options.normals) {
+                        std::snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n", x, y, z);
+                        document.text += line;
+                    }
+                }
+            }
+            const int bandVertices = (lastRow - firstRow + 1) * row;
+            document.positions += static_cast<size_t>(bandVertices);
+
+            // Обход против часовой стрелки снаружи сферы, номера вершин внутри полосы
+            for (int i = 0; i < lastRow - firstRow; ++i) {
+                for (int j = 0; j < segments; ++j) {
+                    int a = i * row + j;
+                    int b = a + row;
+                    if (options.faces == FaceShape::Triangles) {
+                        const int first[3] = {a, a + 1, b + 1};
+                        const int second[3] = {a, b + 1, b};
+                        face(first, 3, bandVertices);
+                        face(second, 3, bandVertices);
+                    } else if (options.faces == FaceShape::Polygons && j + 1 < segments) {
+                        const int hexagon[6] = {a, a + 1, a + 2, b + 2, b + 1, b};
+                        face(hexagon, 6, bandVertices);
+                        ++j;
+                    } else {
+                        const int quad[4] = {a, a + 1, b + 1, b};
+                        face(quad, 4, bandVertices);
+                    }
+                }
+            }
+        }
+        return document;
+    }
+
+    // Библиотека материалов: newmtl с цветами, блеском, прозрачностью и текстурой
+    inline std::string generateMtl(int materials) {
+        std::string text;
+        text.reserve(static_cast<size_t>(std::max(materials, 0)) * 200);
+        char line[128];
+        for (int i = 0; i < materials; ++i) {
+            float shade = static_cast<float>(i % 97) / 96.0f;
+            std::snprintf(line, sizeof(line), "newmtl material_%d\n", i);
+            text += line;
+            std::snprintf(line, sizeof(line), "Ka %.4f %.4f %.4f\n", 0.1f, 0.1f, 0.1f);
+            text += line;
+            std::snprintf(line, sizeof(line), "Kd %.4f %.4f %.4f\n", shade, 1.0f - shade, 0.5f);
+            text += line;
+            std::snprintf(line, sizeof(line), "Ks %.4f %.4f %.4f\nNs %.1f\nd %.2f\nillum 2\n", 0.5f, 0.5f, 0.5f,
+                          10.0f + static_cast<float>(i % 50), i % 4 == 0 ? 0.5f : 1.0f);
+            text += line;
+            std::snprintf(line, sizeof(line), "map_Kd textures/material_%d.png\n\n", i);
+            text += line;
+        }
+        return text;
+    }
+
+    inline void writeText(const std::string& filePath, const std::string& text) {
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + filePath);
+        }
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    inline void write(const std::string& filePath, int segments, float radius = 1.0f) {
+        writeText(filePath, generate(segments, radius));
+    }
+}
+
+#endif //OBJVIEWER_SYNTHETICOBJ_H
@@ -0,0 +1,199 @@
+// Конвейер текстур: построение mip-уровней (SSE2 против скалярного кода), декодирование
+// файлов по одному и параллельно на JobSystem, повторная загрузка по тому же пути и копий
+// под другими именами (без декодирования) и вытеснение при уменьшении бюджета кэша.
+//
+// OBJTextureBench [--files N] [--size N] [--jobs N] [--repeat N]
+//
+// Файлы пишутся во временный каталог: чётные - PNG (ImageWriter, читается и без zlib),
+// нечётные - TGA. Код возврата ненулевой, если mip-уровни SSE2 и скалярного кода
+// различаются или кэш повёл себя не так, как ожидается.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../models/TextureCache.h"
+#include "../render/ImageWriter.h"
+
+namespace {
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Узор, свой для каждого seed
+    uint32_t pattern(int x, int y, int seed) {
+        uint32_t value = static_cast<uint32_t>(x * 73856093) ^ static_cast<uint32_t>(y * 19349663) ^ static_cast<uint32_t>(seed * 83492791);
+        value ^= value >> 13;
+        value *= 0x5BD1E995u;
+        return (value ^ (value >> 15)) | 0xFF000000u;
+    }
+
+    void writeTGA(const std::string& filePath, int size, int seed) {
+        std::vector<uint8_t> data = {0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                     static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+                                     static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8), 32, 8};
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const uint32_t color = pattern(x, y, seed);
+                data.insert(data.end(), {static_cast<uint8_t>(color >> 16), static_cast<uint8_t>(color >> 8),
+                                         static_cast<uint8_t>(color), static_cast<uint8_t>(color >> 24)});
+            }
+        }
+        std::ofstream(filePath, std::ios::binary).write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    void writePNG(const std::string& filePath, int size, int seed) {
+        FrameBuffer frame(size, size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                frame.colorData()[static_cast<size_t>(y) * size + x] = pattern(x, y, seed);
+            }
+        }
+        ImageWriter::writePNG(filePath, frame);
+    }
+
+    // Вся цепочка уровней одной функцией downsample, как в конструкторе Texture
+    template <typename Downsample>
+    void buildChain(std::vector<uint8_t>& levels, uint32_t size, Downsample downsample) {
+        size_t offset = 0;
+        for (uint32_t width = size; width > 1; width /= 2) {
+            const size_t bytes = static_cast<size_t>(width) * width * 4;
+            downsample(levels.data() + offset, width, width, levels.data() + offset + bytes);
+            offset += bytes;
+        }
+    }
+
+    bool benchmarkMips(uint32_t size, int repeat) {
+        size_t total = 0;
+        for (uint32_t width = size; width >= 1; width /= 2) {
+            total += static_cast<size_t>(width) * width * 4;
+            if (width == 1) {
+                break;
+            }
+        }
+        std::vector<uint8_t> simd(total);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                const uint32_t color = pattern(static_cast<int>(x), static_cast<int>(y), 0);
+                std::memcpy(&simd[(static_cast<size_t>(y) * size + x) * 4], &color, 4);
+            }
+        }
+        std::vector<uint8_t> scalar = simd;
+
+        auto measure = [&](std::vector<uint8_t>& levels, auto downsample) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeat; ++i) {
+                buildChain(levels, size, downsample);
+            }
+            return secondsSince(start) / repeat;
+        };
+        const double scalarSeconds = measure(scalar, Texture::downsampleScalar);
+        const double simdSeconds = measure(simd, Texture::downsample);
+        const double texels = static_cast<double>(size) * size;
+        std::cout << "mips " << size << "x" << size << ": scalar " << scalarSeconds * 1000.0 << " ms ("
+                  << texels / scalarSeconds / 1e6 << " Mtexels/s), downsample " << simdSeconds * 1000.0 << " ms ("
+                  << texels / simdSeconds / 1e6 << " Mtexels/s), speedup " << scalarSeconds / simdSeconds << "x\n";
+        if (simd != scalar) {
+            std::cout << "mip levels differ between downsample and downsampleScalar\n";
+            return false;
+        }
+        return true;
+    }
+
+    void printStats(const char* label, TextureCache& cache, double seconds) {
+        const auto stats = cache.getStats();
+        std::cout << "  " << label << ": " << seconds * 1000.0 << " ms, decoded " << stats.decoded << ", path hits " << stats.pathHits
+                  << ", content hits " << stats.contentHits << ", failed " << stats.failed << ", evicted " << stats.evicted
+                  << ", cached " << cache.getTextureCount() << " textures " << static_cast<double>(cache.getCachedBytes()) / (1024.0 * 1024.0)
+                  << " MiB\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int fileCount = 32;
+    int size = 512;
+    int repeat = 5;
+    unsigned jobThreads = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--files") {
+            fileCount = std::max(1, std::atoi(argv[i + 1]));
+        } else if (arg == "--size") {
+            size = std::clamp(std::atoi(argv[i + 1]), 1, 8192);
+        } else if (arg == "--jobs") {
+            jobThreads = static_cast<unsigned>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (arg == "--repeat") {
+            repeat = std::max(1, std::atoi(argv[i + 1]));
+        }
+    }
+    JobSystem::configureGlobal(jobThreads);
+
+    bool failed = !benchmarkMips(static_cast<uint32_t>(size), repeat);
+
+    const auto directory = std::filesystem::temp_directory_path() / "objviewer_textures";
+    std::filesystem::create_directories(directory / "copies");
+    std::vector<std::string> files;
+    std::vector<std::string> copies;
+    for (int i = 0; i < fileCount; ++i) {
+        const std::string name = "texture_" + std::to_string(i) + (i % 2 == 0 ? ".png" : ".tga");
+        const auto path = directory / name;
+        if (i % 2 == 0) {
+            writePNG(path.string(), size, i);
+        } else {
+            writeTGA(path.string(), size, i);
+        }
+        std::filesystem::copy_file(path, directory / "copies" / name, std::filesystem::copy_options::overwrite_existing);
+        files.push_back(path.string());
+        copies.push_back((directory / "copies" / name).string());
+    }
+    std::cout << fileCount << " textures " << size << "x" << size << ", " << JobSystem::global().getThreadCount() << " job threads\n";
+
+    // По одному файлу в вызывающем потоке
+    TextureCache serialCache;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& file : files) {
+        serialCache.load(file);
+    }
+    const double serialSeconds = secondsSince(start);
+    printStats("load loop   ", serialCache, serialSeconds);
+
+    TextureCache cache;
+    start = std::chrono::steady_clock::now();
+    auto textures = cache.loadAll(files);
+    const double parallelSeconds = secondsSince(start);
+    printStats("loadAll     ", cache, parallelSeconds);
+    std::cout << "  speedup " << serialSeconds / parallelSeconds << "x\n";
+    failed |= cache.getStats().decoded != files.size();
+
+    // Те же файлы под другими путями: только чтение и хэш
+    start = std::chrono::steady_clock::now();
+    auto copied = cache.loadAll(copies);
+    printStats("copies      ", cache, secondsSince(start));
+    failed |= cache.getStats().contentHits != copies.size() || cache.getStats().decoded != files.size();
+    for (size_t i = 0; i < files.size(); ++i) {
+        failed |= !textures[i] || textures[i] != copied[i];
+    }
+
+    start = std::chrono::steady_clock::now();
+    cache.loadAll(files);
+    printStats("same paths  ", cache, secondsSince(start));
+    failed |= cache.getStats().pathHits != files.size();
+
+    // Половина бюджета: вытесняются давно не использованные, модели со ссылками их сохраняют
+    const size_t budget = cache.getCachedBytes() / 2;
+    cache.setBudget(budget);
+    start = std::chrono::steady_clock::now();
+    cache.loadAll(files);
+    printStats("half budget ", cache, secondsSince(start));
+    failed |= cache.getStats().evicted == 0 || cache.getCachedBytes() > budget;
+
+    MemoryStats::global().print(std::cout);
+    std::cout << (failed ? "FAILED" : "OK") << '\n';
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,362 @@
+// Пакетная генерация превью OBJ-моделей без окна.
+// Загрузка (чтение и разбор) и рендер идут в отдельных пулах потоков,
+// между ними ограниченная очередь, чтобы в памяти не копились загруженные модели.
+//
+// OBJThumbnailer [--size WxH] [--format png|ppm] [--out DIR] [--views N]
+//                [--io-threads N] [--render-threads N] [--jobs N] [--no-occlusion] PATH...
+//
+// --jobs N - потоки общего JobSystem (обработка мешей, виды турнтейбла), по умолчанию по числу ядер
+// --views N > 1 - турнтейбл: модель готовится один раз, N видов рендерятся параллельно в <имя>_NN.<формат>
+// Превью моделей из каталога лежат в --out по тем же относительным путям: a/model.obj -> DIR/a/model.png
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../models/ModelManager.h"
+#include "../render/SoftwareRasterizer.h"
+#include "../render/OcclusionCuller.h"
+#include "../render/MultiViewRenderer.h"
+#include "../render/Framing.h"
+#include "../render/ImageWriter.h"
+
+namespace {
+    struct Options {
+        int width = 256;
+        int height = 256;
+        std::string format = "png";
+        unsigned views = 1;
+        unsigned jobThreads = 0;
+        std::filesystem::path outputDirectory = ".";
+        unsigned ioThreads = 2;
+        unsigned renderThreads = std::max(1u, std::thread::hardware_concurrency());
+        bool occlusion = true;
+        std::vector<std::filesystem::path> inputs;
+    };
+
+    // Входной файл и путь превью относительно --out без суффикса и расширения
+    struct InputFile {
+        std::string path;
+        std::filesystem::path outputStem;
+    };
+
+    struct LoadedModel {
+        const InputFile* input;
+        std::shared_ptr<Model3D> model;
+    };
+
+    // Ограниченная очередь между стадиями загрузки и рендера
+    template<typename T>
+    class BoundedQueue {
+    private:
+        std::deque<T> items;
+        size_t capacity;
+        bool closed = false;
+        std::mutex mutex;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+
+    public:
+        explicit BoundedQueue(size_t maxItems) : capacity(std::max<size_t>(1, maxItems)) {}
+
+        void push(T item) {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [&] { return items.size() < capacity; });
+            items.push_back(std::move(item));
+            notEmpty.notify_one();
+        }
+
+        std::optional<T> pop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [&] { return !items.empty() || closed; });
+            if (items.empty()) {
+                return std::nullopt;
+            }
+            T item = std::move(items.front());
+            items.pop_front();
+            notFull.notify_one();
+            return item;
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            notEmpty.notify_all();
+        }
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: OBJThumbnailer [--size WxH] [--format png|ppm] [--out DIR] [--views N]\n"
+                     "                      [--io-threads N] [--render-threads N] [--jobs N] [--no-occlusion] PATH...\n"
+                     "PATH may be an .obj file or a directory scanned recursively; thumbnails of\n"
+                     "directory contents keep their relative paths under --out.\n";
+    }
+
+    std::optional<Options> parseArguments(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::optional<std::string> {
+                if (i + 1 >= argc) {
+                    return std::nullopt;
+                }
+                return std::string(argv[++i]);
+            };
+
+            if (arg == "--size") {
+                auto value = next();
+                if (!value || std::sscanf(value->c_str(), "%dx%d", &options.width, &options.height) != 2 ||
+                    options.width <= 0 || options.height <= 0) {
+                    return std::nullopt;
+                }
+            } else if (arg == "--format") {
+                auto value = next();
+                if (!value || (*value != "png" && *value != "ppm")) {
+                    return std::nullopt;
+                }
+                options.format = *value;
+            } else if (arg == "--out") {
+                auto value = next();
+                if (!value) {
+                    return std::nullopt;
+                }
+                options.outputDirectory = *value;
+            } else if (arg == "--io-threads" || arg == "--render-threads" || arg == "--views" || arg == "--jobs") {
+                auto value = next();
+                if (!value) {
+                    return std::nullopt;
+                }
+                unsigned count = static_cast<unsigned>(std::max(1, std::atoi(value->c_str())));
+                if (arg == "--views") {
+                    options.views = count;
+                } else if (arg == "--jobs") {
+                    options.jobThreads = count;
+                } else {
+                    (arg == "--io-threads" ? options.ioThreads : options.renderThreads) = count;
+                }
+            } else if (arg == "--no-occlusion") {
+                options.occlusion = false;
+            } else if (arg == "--help" || arg == "-h") {
+                return std::nullopt;
+            } else {
+                options.inputs.emplace_back(arg);
+            }
+        }
+
+        if (options.inputs.empty()) {
+            return std::nullopt;
+        }
+        return options;
+    }
+
+    // Файлы из каталогов сохраняют путь относительно своего корня, поэтому a/model.obj
+    // и b/model.obj не пишут в один model.png
+    std::vector<InputFile> collectFiles(const std::vector<std::filesystem::path>& inputs) {
+        std::vector<InputFile> files;
+        for (const auto& input : inputs) {
+            std::error_code error;
+            if (std::filesystem::is_directory(input, error)) {
+                for (const auto& entry : std::filesystem::recursive_directory_iterator(input, error)) {
+                    // Сжатые model.obj.gz / model.obj.zst распаковываются при загрузке
+                    auto sourcePath = DecompressingFileStream::stripCompressionSuffix(entry.path().string());
+                    if (entry.is_regular_file() && std::filesystem::path(sourcePath).extension() == ".obj") {
+                        auto relative = entry.path().lexically_relative(input).parent_path();
+                        files.push_back({entry.path().string(), relative / ModelLoader::modelName(sourcePath)});
+                    }
+                }
+            } else {
+                files.push_back({input.string(), ModelLoader::modelName(input.string())});
+            }
+        }
+        return files;
+    }
+
+    // Одинаковые пути превью (model.obj и model.obj.gz рядом, два файла с одним именем в
+    // аргументах) отклоняются: второй файл затёр бы первый, а два потока писали бы один файл.
+    // Сравнение без учёта регистра, --out может лежать на нечувствительной к нему ФС
+    std::vector<InputFile> rejectDuplicateOutputs(std::vector<InputFile> files, size_t& rejected) {
+        std::unordered_map<std::string, std::string> owners;
+        std::vector<InputFile> unique;
+        for (auto& file : files) {
+            std::string key = file.outputStem.lexically_normal().generic_string();
+            std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            auto [it, inserted] = owners.try_emplace(key, file.path);
+            if (!inserted) {
+                std::cerr << file.path << ": output " << file.outputStem.string() << " is already used by " << it->second << std::endl;
+                ++rejected;
+                continue;
+            }
+            unique.push_back(std::move(file));
+        }
+        return unique;
+    }
+
+    // Состояние одного потока рендера
+    struct RenderContext {
+        SoftwareRasterizer rasterizer;
+        OcclusionCuller culler;
+        FrameBuffer frame;
+        MultiViewRenderer multiView;
+        std::vector<FrameBuffer> frames;
+
+        explicit RenderContext(const Options& options)
+                : frame(options.width, options.height),
+                  frames(options.views, FrameBuffer(options.width, options.height)) {
+            if (options.occlusion) {
+                rasterizer.setOcclusionCuller(&culler);
+            }
+            multiView.setOcclusionCulling(options.occlusion);
+        }
+    };
+
+    void writeImage(const Options& options, const InputFile& input, const std::string& suffix, const FrameBuffer& frame) {
+        auto output = options.outputDirectory / input.outputStem;
+        output += suffix + "." + options.format;
+        if (options.format == "png") {
+            ImageWriter::writePNG(output.string(), frame);
+        } else {
+            ImageWriter::writePPM(output.string(), frame);
+        }
+    }
+
+    // Свет из-за плеча камеры
+    VecMath::Vector3D<float> lightFor(const Framing::View& view) {
+        return (view.eye - view.target).normalized() + VecMath::Vector3D<float>{0.0f, 0.5f, 0.0f};
+    }
+
+    void renderThumbnail(const LoadedModel& loaded, const Options& options, RenderContext& context) {
+        float aspect = static_cast<float>(options.width) / static_cast<float>(options.height);
+        auto bounds = loaded.model->computeBounds();
+
+        if (options.views <= 1) {
+            auto view = Framing::fitBounds(bounds, aspect);
+            context.rasterizer.setViewProjection(view.viewProjection);
+            context.rasterizer.setLightDirection(lightFor(view));
+
+            context.frame.clear(FrameBuffer::packColor(0.2f, 0.2f, 0.2f));
+            context.rasterizer.drawModel(*loaded.model, context.frame);
+            writeImage(options, *loaded.input, "", context.frame);
+            return;
+        }
+
+        auto views = Framing::turntable(bounds, aspect, options.views);
+        std::vector<VecMath::Matrix4x4<float>> viewProjections;
+        viewProjections.reserve(views.size());
+        for (const auto& view : views) {
+            viewProjections.push_back(view.viewProjection);
+        }
+
+        // Свет неподвижен относительно модели, чтобы кадры турнтейбла стыковались
+        context.multiView.setLightDirection(lightFor(views.front()));
+        context.multiView.prepare(*loaded.model);
+        context.multiView.render(viewProjections, context.frames);
+
+        for (size_t i = 0; i < views.size(); ++i) {
+            char suffix[24];
+            std::snprintf(suffix, sizeof(suffix), "_%02zu", i);
+            writeImage(options, *loaded.input, suffix, context.frames[i]);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    auto parsed = parseArguments(argc, argv);
+    if (!parsed) {
+        printUsage();
+        return 1;
+    }
+    const Options options = *parsed;
+    JobSystem::configureGlobal(options.jobThreads);
+
+    std::error_code error;
+    std::filesystem::create_directories(options.outputDirectory, error);
+
+    auto collected = collectFiles(options.inputs);
+    if (collected.empty()) {
+        std::cerr << "No input files found." << std::endl;
+        return 1;
+    }
+    const size_t inputCount = collected.size();
+    size_t rejected = 0;
+    const auto files = rejectDuplicateOutputs(std::move(collected), rejected);
+
+    // Подкаталоги создаются заранее, а не из потоков рендера
+    for (const auto& file : files) {
+        std::filesystem::create_directories((options.outputDirectory / file.outputStem).parent_path(), error);
+    }
+
+    ModelManager modelManager;
+    BoundedQueue<LoadedModel> queue(options.renderThreads * 2);
+    std::atomic<size_t> nextFile{0};
+    std::atomic<size_t> rendered{0};
+    std::atomic<size_t> failed{rejected};
+    std::mutex logMutex;
+
+    auto report = [&](const std::string& path, const std::exception& e) {
+        std::lock_guard<std::mutex> lock(logMutex);
+        std::cerr << path << ": " << e.what() << std::endl;
+        ++failed;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> loaders;
+    for (unsigned t = 0; t < options.ioThreads; ++t) {
+        loaders.emplace_back([&] {
+            for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+                try {
+                    queue.push(LoadedModel{&files[i], modelManager.loadModel(files[i].path)});
+                } catch (const std::exception& e) {
+                    report(files[i].path, e);
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> renderers;
+    for (unsigned t = 0; t < options.renderThreads; ++t) {
+        renderers.emplace_back([&] {
+            RenderContext context(options);
+
+            while (auto loaded = queue.pop()) {
+                try {
+                    renderThumbnail(*loaded, options, context);
+                    ++rendered;
+                } catch (const std::exception& e) {
+                    report(loaded->input->path, e);
+                }
+                modelManager.releaseModel(loaded->input->path);
+            }
+        });
+    }
+
+    for (auto& thread : loaders) {
+        thread.join();
+    }
+    queue.close();
+    for (auto& thread : renderers) {
+        thread.join();
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Rendered " << rendered << " of " << inputCount << " models"
+              << " (" << failed << " failed) in " << seconds << " s, "
+              << (seconds > 0.0 ? static_cast<double>(rendered) / seconds : 0.0) << " models/s"
+              << " [io threads: " << options.ioThreads << ", render threads: " << options.renderThreads << "]"
+              << std::endl;
+
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,257 @@
+// Проверка кодеков компактного формата вершин (VertexCodec, Mesh::compress) на случайных и граничных
+// входах против оценок из комментария к Mesh::compress: позиция - не дальше extent / 131070 по оси,
+// нормаль - не дальше 0.05 градуса, текстурная координата - 11 значащих бит.
+// Код возврата 0 - все проверки прошли.
+//
+// OBJVertexCodecCheck [--samples N] [--seed N]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../models/ObjLoader.h"
+#include "../models/VertexCodec.h"
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const std::string& name) {
+        std::cout << (condition ? "  ok    " : "  FAIL  ") << name << std::endl;
+        if (!condition) {
+            ++failures;
+        }
+    }
+
+    constexpr double PositionSteps = 131070.0;
+    constexpr double NormalDegrees = 0.05;
+    constexpr double HalfPrecision = 1.0 / 2048.0;        // 11 значащих бит
+    constexpr double HalfDenormalStep = 1.0 / 33554432.0; // Половина шага денормалей half, 2^-25
+
+    // Погрешность float-арифметики самого кодека: несколько ulp от наибольшего модуля координаты
+    double positionTolerance(float minimum, float extent) {
+        const double magnitude = std::max({std::fabs(static_cast<double>(minimum)),
+                                           std::fabs(static_cast<double>(minimum) + extent),
+                                           static_cast<double>(extent)});
+        return static_cast<double>(extent) / PositionSteps + magnitude * std::ldexp(1.0, -21);
+    }
+
+    double positionError(float value, float minimum, float extent) {
+        const uint16_t encoded = VertexCodec::quantizeUnorm16(value, minimum, extent);
+        return std::fabs(static_cast<double>(VertexCodec::dequantizeUnorm16(encoded, minimum, extent)) - value);
+    }
+
+    // Угол между исходной и декодированной нормалью; atan2 точнее acos около нуля.
+    // В кодек нормаль уходит умноженной на scale
+    double normalErrorDegrees(double nx, double ny, double nz, double scale = 1.0) {
+        const double length = std::sqrt(nx * nx + ny * ny + nz * nz);
+        nx /= length;
+        ny /= length;
+        nz /= length;
+        int16_t ex, ey;
+        VertexCodec::octEncode(static_cast<float>(nx * scale), static_cast<float>(ny * scale), static_cast<float>(nz * scale), ex, ey);
+        float dx, dy, dz;
+        VertexCodec::octDecode(ex, ey, dx, dy, dz);
+        const double cx = ny * dz - nz * dy;
+        const double cy = nz * dx - nx * dz;
+        const double cz = nx * dy - ny * dx;
+        const double cross = std::sqrt(cx * cx + cy * cy + cz * cz);
+        const double dot = nx * dx + ny * dy + nz * dz;
+        return std::atan2(cross, dot) * 180.0 / 3.14159265358979323846;
+    }
+
+    bool halfRoundTripWithinBound(float value) {
+        const float decoded = VertexCodec::halfToFloat(VertexCodec::floatToHalf(value));
+        const double error = std::fabs(static_cast<double>(decoded) - value);
+        return error <= std::max(std::fabs(static_cast<double>(value)) * HalfPrecision, HalfDenormalStep);
+    }
+
+    void checkPositions(std::mt19937& random, size_t samples) {
+        std::uniform_real_distribution<float> minimumDistribution(-1000.0f, 1000.0f);
+        std::uniform_real_distribution<float> logExtentDistribution(-6.0f, 4.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        double worst = 0.0; // В долях допуска
+        for (size_t i = 0; i < samples; ++i) {
+            const float minimum = minimumDistribution(random);
+            const float extent = std::pow(10.0f, logExtentDistribution(random));
+            const float value = minimum + unit(random) * extent;
+            worst = std::max(worst, positionError(value, minimum, extent) / positionTolerance(minimum, extent));
+        }
+        std::cout << "  worst random position error: " << worst << " of the bound" << std::endl;
+        check(worst <= 1.0, "random positions stay within extent / 131070");
+
+        // Концы отрезка, середина, ровно между двумя шагами и значения за границами AABB (зажимаются)
+        bool edges = true;
+        for (float extent : {1.0f, 3.0f, 1e-4f, 65535.0f}) {
+            for (float minimum : {0.0f, -0.0f, -1.5f, 1e3f}) {
+                const double tolerance = positionTolerance(minimum, extent);
+                for (float t : {0.0f, 1.0f, 0.5f, 0.5f / 65535.0f, 1.5f / 65535.0f, 1.0f - 0.5f / 65535.0f}) {
+                    edges = edges && positionError(minimum + t * extent, minimum, extent) <= tolerance;
+                }
+                edges = edges && VertexCodec::quantizeUnorm16(minimum - extent, minimum, extent) == 0;
+                edges = edges && VertexCodec::quantizeUnorm16(minimum + 2.0f * extent, minimum, extent) == 65535;
+            }
+        }
+        check(edges, "AABB corners, half steps and clamped outside values");
+
+        // Плоский меш: по оси без протяжённости кодируется 0, а декодируется ровно minimum
+        bool degenerate = true;
+        for (float minimum : {0.0f, -0.0f, 2.5f, -7.25f}) {
+            degenerate = degenerate && VertexCodec::quantizeUnorm16(minimum, minimum, 0.0f) == 0;
+            degenerate = degenerate && VertexCodec::dequantizeUnorm16(0, minimum, 0.0f) == minimum;
+            degenerate = degenerate && VertexCodec::dequantizeUnorm16(65535, minimum, 0.0f) == minimum;
+        }
+        check(degenerate, "degenerate AABB axis decodes to its minimum");
+    }
+
+    void checkNormals(std::mt19937& random, size_t samples) {
+        std::normal_distribution<double> gaussian;
+        double worst = 0.0;
+        for (size_t i = 0; i < samples; ++i) {
+            double x, y, z;
+            do {
+                x = gaussian(random);
+                y = gaussian(random);
+                z = gaussian(random);
+            } while (x * x + y * y + z * z < 1e-12);
+            worst = std::max(worst, normalErrorDegrees(x, y, z));
+        }
+        std::cout << "  worst random normal error: " << worst << " degrees" << std::endl;
+        check(worst <= NormalDegrees, "random normals stay within 0.05 degrees");
+
+        // Оси со всеми знаками нулей, диагонали, линия сгиба октаэдра (z = 0) и почти осевые векторы
+        const double axes[][3] = {
+            {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+            {1, -0.0, 0}, {-0.0, -1, -0.0}, {-0.0, -0.0, 1}, {-0.0, 0, -1}, {0, -0.0, -1},
+        };
+        double axisWorst = 0.0;
+        for (const auto& axis : axes) {
+            axisWorst = std::max(axisWorst, normalErrorDegrees(axis[0], axis[1], axis[2]));
+        }
+        check(axisWorst <= NormalDegrees, "axis-aligned normals with +0 and -0 components");
+
+        double edgeWorst = 0.0;
+        for (int sx : {-1, 1}) {
+            for (int sy : {-1, 1}) {
+                for (int sz : {-1, 1}) {
+                    edgeWorst = std::max(edgeWorst, normalErrorDegrees(sx, sy, sz));
+                    edgeWorst = std::max(edgeWorst, normalErrorDegrees(sx, sy, 0.0));
+                    edgeWorst = std::max(edgeWorst, normalErrorDegrees(sx * 0.3, sy * 0.7, sz * 1e-7));
+                    edgeWorst = std::max(edgeWorst, normalErrorDegrees(sx * 1e-6, sy * 1e-6, sz));
+                    edgeWorst = std::max(edgeWorst, normalErrorDegrees(sx, sy * 1e-6, sz * 1e-6));
+                }
+            }
+        }
+        check(edgeWorst <= NormalDegrees, "diagonals, octahedron fold and near-axis normals");
+
+        // Ненормированный вход: octEncode делит на L1-норму, длина не должна влиять
+        check(normalErrorDegrees(0.0, 0.0, 1.0, 250.0) <= NormalDegrees &&
+              normalErrorDegrees(-3.0, 2.0, -1.0, 1e-3) <= NormalDegrees &&
+              normalErrorDegrees(0.2, -0.9, 0.4, 7.5) <= NormalDegrees, "unnormalized normals");
+    }
+
+    void checkTexCoords(std::mt19937& random, size_t samples) {
+        std::uniform_real_distribution<float> tiled(-8.0f, 8.0f);
+        std::uniform_real_distribution<float> logMagnitude(-20.0f, 15.0f);
+        bool randomWithin = true;
+        for (size_t i = 0; i < samples; ++i) {
+            randomWithin = randomWithin && halfRoundTripWithinBound(tiled(random));
+            randomWithin = randomWithin && halfRoundTripWithinBound(std::exp2(logMagnitude(random)));
+        }
+        check(randomWithin, "random texcoords keep 11 significant bits");
+
+        // Граничные значения half: нули, единица, наименьшие нормальное и денормальное, наибольшее конечное
+        bool edges = true;
+        for (float value : {0.0f, 1.0f, 0.5f, 1.0f - 1.0f / 4096.0f, 0x1p-14f, 0x1p-24f, 0x1.ffcp15f, 2047.0f, 2048.0f}) {
+            edges = edges && halfRoundTripWithinBound(value) && halfRoundTripWithinBound(-value);
+        }
+        const float negativeZero = VertexCodec::halfToFloat(VertexCodec::floatToHalf(-0.0f));
+        edges = edges && negativeZero == 0.0f && std::signbit(negativeZero);
+        edges = edges && !std::signbit(VertexCodec::halfToFloat(VertexCodec::floatToHalf(0.0f)));
+        check(edges, "texcoord edges, including -0 keeping its sign");
+
+        // Вне диапазона half: переполнение в бесконечность, NaN остаётся NaN
+        const float infinity = std::numeric_limits<float>::infinity();
+        check(std::isinf(VertexCodec::halfToFloat(VertexCodec::floatToHalf(70000.0f))) &&
+              VertexCodec::halfToFloat(VertexCodec::floatToHalf(-infinity)) == -infinity &&
+              std::isnan(VertexCodec::halfToFloat(VertexCodec::floatToHalf(std::numeric_limits<float>::quiet_NaN()))),
+              "texcoord overflow and NaN");
+
+        // Каждое значение half переживает halfToFloat -> floatToHalf без изменений
+        bool exact = true;
+        for (uint32_t bits = 0; bits <= 0xFFFFu; ++bits) {
+            const float value = VertexCodec::halfToFloat(static_cast<uint16_t>(bits));
+            if (std::isnan(value)) {
+                exact = exact && std::isnan(VertexCodec::halfToFloat(VertexCodec::floatToHalf(value)));
+            } else {
+                exact = exact && VertexCodec::floatToHalf(value) == bits;
+            }
+        }
+        check(exact, "all 65536 half values round-trip exactly");
+    }
+
+    // Весь путь Mesh::compress -> getVertex на плоском квадрате: z не имеет протяжённости, нормали осевые
+    void checkMesh() {
+        std::istringstream stream(
+            "v -1 -1 0\nv 1 -1 0\nv 1 1 0\nv -1 1 0\n"
+            "vt 0 0\nvt 1 0\nvt 1 1\nvt 0.333 0.667\n"
+            "vn 0 0 1\nvn 0 0 -1\nvn -0 1 0\nvn 1 0 -0\n"
+            "f 1/1/1 2/2/2 3/3/3 4/4/4\n");
+        ObjLoader loader;
+        auto model = loader.parseModel(stream, "quad");
+        bool within = !model->getMeshes().empty();
+        for (const auto& mesh : model->getMeshes()) {
+            ModelLoader::processMesh(*mesh);
+            const std::vector<Mesh::Vertex> original = mesh->getVertices();
+            const Mesh::Bounds bounds = mesh->getBounds();
+            const auto extent = bounds.extent();
+            mesh->compress();
+            within = within && mesh->isCompressed() && mesh->getVertexCount() == original.size();
+            for (size_t i = 0; within && i < original.size(); ++i) {
+                const Mesh::Vertex& before = original[i];
+                const Mesh::Vertex after = mesh->getVertex(i);
+                within = within && std::fabs(after.x - before.x) <= positionTolerance(bounds.min[0], extent[0]);
+                within = within && std::fabs(after.y - before.y) <= positionTolerance(bounds.min[1], extent[1]);
+                within = within && after.z == before.z;
+                within = within && normalErrorDegrees(before.nx, before.ny, before.nz) <= NormalDegrees;
+                within = within && std::fabs(after.nx * before.nx + after.ny * before.ny + after.nz * before.nz - 1.0f) < 1e-6f;
+                within = within && halfRoundTripWithinBound(before.u) && halfRoundTripWithinBound(before.v);
+            }
+        }
+        check(within, "Mesh::compress keeps a flat quad within the bounds");
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t samples = 1'000'000;
+    unsigned seed = 12345;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--samples") {
+            samples = static_cast<size_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (arg == "--seed") {
+            seed = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+
+    std::mt19937 random(seed);
+    std::cout << "Positions (unorm16 in the AABB)" << std::endl;
+    checkPositions(random, samples);
+    std::cout << "Normals (octahedral snorm16)" << std::endl;
+    checkNormals(random, samples);
+    std::cout << "Texture coordinates (half)" << std::endl;
+    checkTexCoords(random, samples);
+    std::cout << "Mesh" << std::endl;
+    checkMesh();
+
+    std::cout << (failures == 0 ? "All checks passed" : "Some checks FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}